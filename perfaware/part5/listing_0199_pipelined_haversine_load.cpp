@@ -0,0 +1,402 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 199
+   ======================================================================== */
+
+/* NOTE(casey): No single pair record should ever come close to this size. The
+   carry buffer is twice as large, so that a partial record left at the end of
+   one block can always be joined with at least this many bytes from the next. */
+#define MAX_HAVERSINE_RECORD_SIZE 1024
+
+enum haversine_block_stage
+{
+    BlockStage_Header,
+    BlockStage_Pairs,
+    BlockStage_Done,
+};
+
+struct haversine_block_parser
+{
+    haversine_block_stage Stage;
+    u32 HeaderTokenCount;
+    b32 HadError;
+
+    u64 MaxPairCount;
+    u64 PairCount;
+    haversine_pair *Pairs;
+
+    u64 StartTime;
+    u64 FirstPairTime;
+
+    u64 CarryCount;
+    u8 Carry[2*MAX_HAVERSINE_RECORD_SIZE];
+};
+
+static b32 IsJSONWhitespace(u8 Val)
+{
+    b32 Result = ((Val == ' ') || (Val == '\t') || (Val == '\n') || (Val == '\r'));
+    return Result;
+}
+
+static u64 ParseHaversineHeader(haversine_block_parser *BlockParser, buffer Source)
+{
+    // NOTE(casey): The header is the {"pairs":[ that precedes the first record. We only
+    // accept a token once we can see all of it, so a header split across blocks just waits
+    // in the carry buffer until the rest arrives.
+    json_token_type Expected[] = {Token_open_brace, Token_string_literal, Token_colon, Token_open_bracket};
+
+    json_parser Parser = {};
+    Parser.Source = Source;
+
+    u64 Consumed = 0;
+    while(BlockParser->HeaderTokenCount < ArrayCount(Expected))
+    {
+        json_token Token = GetJSONToken(&Parser);
+        if(Token.Type == Token_end_of_stream)
+        {
+            break;
+        }
+
+        if(Token.Type == Token_string_literal)
+        {
+            u8 *StringEnd = Token.Value.Data + Token.Value.Count;
+            if(StringEnd >= (Source.Data + Source.Count))
+            {
+                // NOTE(casey): The closing quote hasn't arrived yet
+                break;
+            }
+
+            if(!AreEqual(Token.Value, CONSTANT_STRING("pairs")))
+            {
+                Error(&Parser, Token, "Expected \"pairs\" array");
+            }
+        }
+
+        if(Token.Type != Expected[BlockParser->HeaderTokenCount])
+        {
+            Error(&Parser, Token, "Unexpected token in haversine header");
+        }
+
+        if(Parser.HadError)
+        {
+            BlockParser->HadError = true;
+            break;
+        }
+
+        ++BlockParser->HeaderTokenCount;
+        Consumed = Parser.At;
+    }
+
+    if(BlockParser->HeaderTokenCount == ArrayCount(Expected))
+    {
+        BlockParser->Stage = BlockStage_Pairs;
+    }
+
+    return Consumed;
+}
+
+static void ParseHaversineRecord(haversine_block_parser *BlockParser, buffer Record)
+{
+    if(BlockParser->PairCount < BlockParser->MaxPairCount)
+    {
+        json_element *Element = ParseJSON(Record);
+
+        haversine_pair *Pair = BlockParser->Pairs + BlockParser->PairCount++;
+        Pair->X0 = ConvertElementToF64(Element, CONSTANT_STRING("x0"));
+        Pair->Y0 = ConvertElementToF64(Element, CONSTANT_STRING("y0"));
+        Pair->X1 = ConvertElementToF64(Element, CONSTANT_STRING("x1"));
+        Pair->Y1 = ConvertElementToF64(Element, CONSTANT_STRING("y1"));
+
+        FreeJSON(Element);
+
+        if(BlockParser->PairCount == 1)
+        {
+            BlockParser->FirstPairTime = ReadCPUTimer();
+        }
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: More pairs in JSON than expected (%llu)\n", BlockParser->MaxPairCount);
+        BlockParser->HadError = true;
+    }
+}
+
+static u64 ParseHaversineBlock(haversine_block_parser *BlockParser, buffer Source)
+{
+    /* NOTE(casey): Returns how many bytes of Source were fully used. Anything past that
+       is the beginning of a record that continues in the next block, and must be handed
+       back in again once more data is available. */
+
+    u64 At = 0;
+    if(BlockParser->Stage == BlockStage_Header)
+    {
+        At = ParseHaversineHeader(BlockParser, Source);
+    }
+
+    while(!BlockParser->HadError && (BlockParser->Stage == BlockStage_Pairs) && IsInBounds(Source, At))
+    {
+        u8 Val = Source.Data[At];
+        if(IsJSONWhitespace(Val) || (Val == ','))
+        {
+            ++At;
+        }
+        else if(Val == ']')
+        {
+            BlockParser->Stage = BlockStage_Done;
+            ++At;
+        }
+        else if(Val == '{')
+        {
+            // NOTE(casey): Pair records are flat objects, so the first closing brace outside
+            // of a string literal ends the record.
+            u64 End = At + 1;
+            b32 InString = false;
+            while(IsInBounds(Source, End))
+            {
+                u8 EndVal = Source.Data[End];
+                if(InString && (EndVal == '\\'))
+                {
+                    ++End;
+                }
+                else if(EndVal == '"')
+                {
+                    InString = !InString;
+                }
+                else if(!InString && (EndVal == '}'))
+                {
+                    break;
+                }
+
+                ++End;
+            }
+
+            if(IsInBounds(Source, End))
+            {
+                buffer Record = {(End + 1) - At, Source.Data + At};
+                ParseHaversineRecord(BlockParser, Record);
+                At = End + 1;
+            }
+            else
+            {
+                break;
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: \"%c\" - Unexpected character in haversine pairs array\n", Val);
+            BlockParser->HadError = true;
+        }
+    }
+
+    if(BlockParser->Stage == BlockStage_Done)
+    {
+        // NOTE(casey): Everything after the closing bracket is just the end of the outer object
+        At = Source.Count;
+    }
+
+    return At;
+}
+
+static void ParseHaversineStream(haversine_block_parser *BlockParser, buffer Block)
+{
+    u64 BlockAt = 0;
+
+    if(BlockParser->CarryCount)
+    {
+        // NOTE(casey): Join the partial record from the previous block with the start of this one
+        u64 CarryMax = sizeof(BlockParser->Carry);
+        u64 TakeCount = CarryMax - BlockParser->CarryCount;
+        if(TakeCount > Block.Count)
+        {
+            TakeCount = Block.Count;
+        }
+        memcpy(BlockParser->Carry + BlockParser->CarryCount, Block.Data, TakeCount);
+
+        buffer Stitched = {BlockParser->CarryCount + TakeCount, BlockParser->Carry};
+        u64 Used = ParseHaversineBlock(BlockParser, Stitched);
+        if(Used >= BlockParser->CarryCount)
+        {
+            BlockAt = Used - BlockParser->CarryCount;
+            BlockParser->CarryCount = 0;
+        }
+        else if(TakeCount == Block.Count)
+        {
+            // NOTE(casey): The whole block fit in the carry buffer without finishing the record
+            BlockParser->CarryCount = Stitched.Count - Used;
+            memmove(BlockParser->Carry, BlockParser->Carry + Used, BlockParser->CarryCount);
+            BlockAt = Block.Count;
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Haversine record exceeds %u bytes\n", MAX_HAVERSINE_RECORD_SIZE);
+            BlockParser->HadError = true;
+        }
+    }
+
+    if(!BlockParser->HadError && (BlockAt < Block.Count))
+    {
+        buffer Remaining = {Block.Count - BlockAt, Block.Data + BlockAt};
+        u64 Used = ParseHaversineBlock(BlockParser, Remaining);
+
+        u64 LeftoverCount = Remaining.Count - Used;
+        if(LeftoverCount <= MAX_HAVERSINE_RECORD_SIZE)
+        {
+            memcpy(BlockParser->Carry, Remaining.Data + Used, LeftoverCount);
+            BlockParser->CarryCount = LeftoverCount;
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Haversine record exceeds %u bytes\n", MAX_HAVERSINE_RECORD_SIZE);
+            BlockParser->HadError = true;
+        }
+    }
+}
+
+static b32 FinishHaversineStream(haversine_block_parser *BlockParser)
+{
+    if(!BlockParser->HadError && (BlockParser->Stage != BlockStage_Done))
+    {
+        fprintf(stderr, "ERROR: Haversine JSON ended before the pairs array was closed\n");
+        BlockParser->HadError = true;
+    }
+
+    b32 Result = !BlockParser->HadError;
+    return Result;
+}
+
+static u64 LoadHaversinePairsPipelined(char const *FileName, u64 FileSize, u64 BlockSize,
+                                       u64 MaxPairCount, haversine_pair *Pairs, u64 *FirstPairTime = 0)
+{
+    /* NOTE(casey): This is OpenAllocateAndSumOverlapped from listing 167, except that instead
+       of summing each block as it comes back from the IO thread, we parse it. Only two blocks
+       of the file are ever resident at once, and parsing starts as soon as the first block lands. */
+
+    u64 PairCount = 0;
+
+    haversine_block_parser BlockParser = {};
+
+    threaded_io ThreadedIO = {};
+    ThreadedIO.File = fopen(FileName, "rb");
+    ThreadedIO.TotalFileSize = FileSize;
+    ThreadedIO.Buffers[0].Value = AllocateBuffer(BlockSize);
+    ThreadedIO.Buffers[1].Value = AllocateBuffer(BlockSize);
+
+    thread_handle IOThread = {};
+    if(ThreadedIO.File &&
+       IsValid(ThreadedIO.Buffers[0].Value) &&
+       IsValid(ThreadedIO.Buffers[1].Value))
+    {
+        BlockParser.MaxPairCount = MaxPairCount;
+        BlockParser.Pairs = Pairs;
+        BlockParser.StartTime = ReadCPUTimer();
+
+        IOThread = CreateAndStartThread(IOThreadRoutine, &ThreadedIO);
+    }
+
+    if(IsValidThread(IOThread))
+    {
+        u64 BufferIndex = 0;
+        u64 SizeRemaining = FileSize;
+        while(SizeRemaining)
+        {
+            overlapped_buffer *Buffer = &ThreadedIO.Buffers[BufferIndex++ & 1];
+
+            while(Buffer->State != Buffer_ReadCompleted) {_mm_pause();}
+
+            EXCESSIVE_FENCE;
+
+            u64 ReadSize = Buffer->ReadSize;
+            if(!BlockParser.HadError)
+            {
+                buffer Block = {ReadSize, Buffer->Value.Data};
+                ParseHaversineStream(&BlockParser, Block);
+            }
+
+            EXCESSIVE_FENCE;
+
+            Buffer->State = Buffer_Unused;
+
+            SizeRemaining -= ReadSize;
+        }
+
+        if(ThreadedIO.ReadError)
+        {
+            fprintf(stderr, "ERROR: Unable to read \"%s\".\n", FileName);
+        }
+        else if(FinishHaversineStream(&BlockParser))
+        {
+            PairCount = BlockParser.PairCount;
+            if(FirstPairTime && PairCount)
+            {
+                *FirstPairTime = BlockParser.FirstPairTime - BlockParser.StartTime;
+            }
+        }
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Couldn't acquire resources to load \"%s\".\n", FileName);
+    }
+
+    FreeBuffer(&ThreadedIO.Buffers[0].Value);
+    FreeBuffer(&ThreadedIO.Buffers[1].Value);
+    if(ThreadedIO.File)
+    {
+        fclose(ThreadedIO.File);
+    }
+
+    return PairCount;
+}
+
+static haversine_setup SetUpHaversinePipelined(char *PairsJSONFileName, char *AnswerFileName, u64 BlockSize = 1024*1024)
+{
+    // NOTE(casey): Same as SetUpHaversine, but the JSON never has to be resident in memory all at once
+
+    haversine_setup Result = {};
+
+    u64 JSONFileSize = GetFileSize(PairsJSONFileName);
+    Result.AnswerBuffer = ReadEntireFile(AnswerFileName);
+
+    u32 MinimumJSONPairEncoding = 16; // NOTE(casey): There should be no way to define a pair in JSON without substantially more characters than this
+    u64 MaxPairCount = JSONFileSize / MinimumJSONPairEncoding;
+    Result.ParsedPairsBuffer = AllocateBuffer(sizeof(haversine_pair) * MaxPairCount);
+
+    if(MaxPairCount && IsValid(Result.AnswerBuffer) && IsValid(Result.ParsedPairsBuffer))
+    {
+        Result.Pairs = (haversine_pair *)Result.ParsedPairsBuffer.Data;
+
+        u64 AnswerCount = Result.AnswerBuffer.Count / sizeof(f64);
+        u64 PairCount = LoadHaversinePairsPipelined(PairsJSONFileName, JSONFileSize, BlockSize, MaxPairCount, Result.Pairs);
+        if(AnswerCount == (PairCount + 1))
+        {
+            Result.PairCount = PairCount;
+            Result.Answers = (f64 *)Result.AnswerBuffer.Data;
+            Result.SumAnswer = Result.Answers[PairCount];
+
+            Result.ParsedByteCount = (sizeof(haversine_pair)*Result.PairCount);
+
+            u64 Megabyte = 1024*1024;
+            fprintf(stdout, "Source JSON: %llumb (streamed in %llukb blocks)\n", JSONFileSize/Megabyte, BlockSize/1024);
+            fprintf(stdout, "Parsed: %llumb (%llu pairs)\n", Result.ParsedByteCount/Megabyte, Result.PairCount);
+
+            Result.Valid = (Result.PairCount != 0);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: JSON source data has %llu pairs, but answer file has %llu values (should have %llu).\n",
+                    PairCount, AnswerCount, PairCount + 1);
+        }
+    }
+
+    return Result;
+}
@@ -0,0 +1,181 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 200
+   ======================================================================== */
+
+/* NOTE(casey): _CRT_SECURE_NO_WARNINGS is here because otherwise we cannot
+   call fopen(). If we replace fopen() with fopen_s() to avoid the warning,
+   then the code doesn't compile on Linux anymore, since fopen_s() does not
+   exist there.
+
+   What exactly the CRT maintainers were thinking when they made this choice,
+   I have no idea. */
+#define _CRT_SECURE_NO_WARNINGS
+
+#define __STDC_WANT_LIB_EXT1__ 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef int32_t b32;
+
+typedef float f32;
+typedef double f64;
+
+#define ArrayCount(Array) (sizeof(Array)/sizeof((Array)[0]))
+
+#include "listing_0125_buffer.cpp"
+#include "listing_0169_os_platform.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+#include "listing_0167_osread_sum.cpp"
+#include "listing_0172_reference_haversine.cpp"
+#include "listing_0199_pipelined_haversine_load.cpp"
+
+typedef u64 haversine_load_func(char *FileName, u64 FileSize, u64 BlockSize, u64 MaxPairCount, haversine_pair *Pairs, u64 *FirstPairTime);
+
+static u64 ReadThenParse(char *FileName, u64 FileSize, u64 BlockSize, u64 MaxPairCount, haversine_pair *Pairs, u64 *FirstPairTime)
+{
+    // NOTE(casey): This is what SetUpHaversine does - no pair is available until the entire file has been read and parsed
+    (void)FileSize;
+    (void)BlockSize;
+
+    u64 StartTime = ReadCPUTimer();
+
+    buffer JSON = ReadEntireFile(FileName);
+    u64 PairCount = ParseHaversinePairs(JSON, MaxPairCount, Pairs);
+    FreeBuffer(&JSON);
+
+    *FirstPairTime = ReadCPUTimer() - StartTime;
+
+    return PairCount;
+}
+
+static u64 ParsePipelined(char *FileName, u64 FileSize, u64 BlockSize, u64 MaxPairCount, haversine_pair *Pairs, u64 *FirstPairTime)
+{
+    u64 PairCount = LoadHaversinePairsPipelined(FileName, FileSize, BlockSize, MaxPairCount, Pairs, FirstPairTime);
+    return PairCount;
+}
+
+struct test_function
+{
+    char const *Name;
+    haversine_load_func *Load;
+};
+static test_function TestFunctions[] =
+{
+    {"ReadThenParse", ReadThenParse},
+    {"ParsePipelined", ParsePipelined},
+};
+
+int main(int ArgCount, char **Args)
+{
+    InitializeOSPlatform();
+
+    if(ArgCount == 3)
+    {
+        char *JSONFileName = Args[1];
+
+        haversine_setup Setup = SetUpHaversine(Args[1], Args[2]);
+        buffer TestPairsBuffer = AllocateBuffer(Setup.ParsedPairsBuffer.Count);
+        repetition_test_series TestSeries = AllocateTestSeries(ArrayCount(TestFunctions), 64);
+        if(IsValid(Setup) && IsValid(TestPairsBuffer) && IsValid(TestSeries))
+        {
+            u64 FileSize = Setup.JSONBuffer.Count;
+            u64 MaxPairCount = TestPairsBuffer.Count / sizeof(haversine_pair);
+            haversine_pair *TestPairs = (haversine_pair *)TestPairsBuffer.Data;
+
+            SetRowLabelLabel(&TestSeries, "BlockSize");
+            for(u64 BlockSize = 64*1024; BlockSize <= 64*1024*1024; BlockSize *= 4)
+            {
+                SetRowLabel(&TestSeries, "%lluk", BlockSize/1024);
+                for(u32 TestFunctionIndex = 0; TestFunctionIndex < ArrayCount(TestFunctions); ++TestFunctionIndex)
+                {
+                    test_function Function = TestFunctions[TestFunctionIndex];
+
+                    SetColumnLabel(&TestSeries, "%s", Function.Name);
+
+                    repetition_tester Tester = {};
+                    NewTestWave(&TestSeries, &Tester, FileSize, GetCPUTimerFreq());
+
+                    b32 Passed = true;
+                    u64 MinFirstPairTime = (u64)-1;
+                    while(IsTesting(&TestSeries, &Tester))
+                    {
+                        memset(TestPairs, 0, Setup.ParsedByteCount);
+
+                        u64 FirstPairTime = 0;
+                        BeginTime(&Tester);
+                        u64 PairCount = Function.Load(JSONFileName, FileSize, BlockSize, MaxPairCount, TestPairs, &FirstPairTime);
+                        CountBytes(&Tester, FileSize);
+                        EndTime(&Tester);
+
+                        if((PairCount != Setup.PairCount) ||
+                           (memcmp(TestPairs, Setup.Pairs, Setup.ParsedByteCount) != 0))
+                        {
+                            Passed = false;
+                        }
+
+                        if(MinFirstPairTime > FirstPairTime)
+                        {
+                            MinFirstPairTime = FirstPairTime;
+                        }
+                    }
+
+                    fprintf(stdout, "First pair: %fms\n", 1000.0*SecondsFromCPUTime((f64)MinFirstPairTime, GetCPUTimerFreq()));
+
+                    if(!Passed)
+                    {
+                        fprintf(stderr, "WARNING: Parsed pairs do not match SetUpHaversine\n");
+                    }
+                }
+            }
+
+            PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Test data size must be non-zero\n");
+        }
+
+        FreeHaversine(&Setup);
+        FreeBuffer(&TestPairsBuffer);
+        FreeTestSeries(&TestSeries);
+    }
+    else
+    {
+        fprintf(stderr, "Usage: %s [haversine JSON file] [haversine answer file]\n", Args[0]);
+    }
+
+    (void)&OpenAllocateAndFRead;
+    (void)&OpenAllocateAndSum;
+    (void)&OpenAllocateAndSumOverlapped;
+    (void)&ReferenceSumHaversine;
+    (void)&ReferenceVerifyHaversine;
+    (void)&SetUpHaversinePipelined;
+
+    return 0;
+}
@@ -0,0 +1,193 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 201
+   ======================================================================== */
+
+/* NOTE(casey): The binary pair format is a 64-byte header followed by four
+   columns - all the X0s, then all the Y0s, then all the X1s, then all the Y1s.
+   Each column is padded out to a multiple of 64 bytes, so as long as the file
+   is mapped at a page boundary, every column starts on a cache line. Nothing
+   in the file needs to be parsed or copied before it can be used.
+
+   The checksum is the 64-bit wrapping sum of the bit patterns of every value
+   in every column. Since addition doesn't care about order, the generator can
+   accumulate it as it goes, and a loader can check it at memory bandwidth. */
+
+#define HAVERSINE_BINARY_MAGIC 0x5249415052564148ULL // NOTE(casey): "HAVRPAIR" when viewed as bytes
+#define HAVERSINE_BINARY_VERSION 1
+#define HAVERSINE_COLUMN_ALIGNMENT 64
+#define HAVERSINE_BINARY_WRITE_CHUNK 4096
+
+struct haversine_binary_header
+{
+    u64 MagicValue;
+    u32 Version;
+    u32 HeaderSize;
+
+    u64 PairCount;
+    u64 ColumnStride;
+    u64 Checksum;
+    f64 ExpectedSum;
+
+    u64 Reserved[2];
+};
+static_assert(sizeof(haversine_binary_header) == HAVERSINE_COLUMN_ALIGNMENT, "Header must keep the columns aligned");
+
+enum haversine_column
+{
+    HaversineColumn_X0,
+    HaversineColumn_Y0,
+    HaversineColumn_X1,
+    HaversineColumn_Y1,
+
+    HaversineColumn_Count,
+};
+
+#if _WIN32
+#define SeekFile64 _fseeki64
+#else
+#define SeekFile64 fseeko
+#endif
+
+inline u64 GetHaversineColumnStride(u64 PairCount)
+{
+    u64 Mask = HAVERSINE_COLUMN_ALIGNMENT - 1;
+    u64 Result = (PairCount*sizeof(f64) + Mask) & ~Mask;
+    return Result;
+}
+
+inline u64 GetHaversineBinarySize(u64 PairCount)
+{
+    u64 Result = sizeof(haversine_binary_header) + HaversineColumn_Count*GetHaversineColumnStride(PairCount);
+    return Result;
+}
+
+struct haversine_binary_writer
+{
+    FILE *File;
+
+    u64 PairCount;
+    u64 ColumnStride;
+    u64 Checksum;
+
+    u64 FlushedCount;
+    u32 BufferedCount;
+    b32 WriteError;
+
+    f64 Columns[HaversineColumn_Count][HAVERSINE_BINARY_WRITE_CHUNK];
+};
+
+inline void FlushHaversineColumns(haversine_binary_writer *Writer)
+{
+    // NOTE(casey): Each column lives in its own region of the file, so each buffered
+    // column chunk has to be written at its own offset.
+    for(u32 ColumnIndex = 0; ColumnIndex < HaversineColumn_Count; ++ColumnIndex)
+    {
+        u64 Offset = (sizeof(haversine_binary_header) +
+                      ColumnIndex*Writer->ColumnStride +
+                      Writer->FlushedCount*sizeof(f64));
+        if((SeekFile64(Writer->File, Offset, SEEK_SET) != 0) ||
+           (fwrite(Writer->Columns[ColumnIndex], sizeof(f64)*Writer->BufferedCount, 1, Writer->File) != 1))
+        {
+            Writer->WriteError = true;
+        }
+    }
+
+    Writer->FlushedCount += Writer->BufferedCount;
+    Writer->BufferedCount = 0;
+}
+
+inline void BeginHaversineBinary(haversine_binary_writer *Writer, FILE *File, u64 PairCount)
+{
+    Writer->File = File;
+    Writer->PairCount = PairCount;
+    Writer->ColumnStride = GetHaversineColumnStride(PairCount);
+    Writer->Checksum = 0;
+    Writer->FlushedCount = 0;
+    Writer->BufferedCount = 0;
+    Writer->WriteError = false;
+}
+
+inline void WriteHaversinePair(haversine_binary_writer *Writer, f64 X0, f64 Y0, f64 X1, f64 Y1)
+{
+    f64 Values[HaversineColumn_Count] = {X0, Y0, X1, Y1};
+    for(u32 ColumnIndex = 0; ColumnIndex < HaversineColumn_Count; ++ColumnIndex)
+    {
+        u64 Bits;
+        memcpy(&Bits, &Values[ColumnIndex], sizeof(Bits));
+        Writer->Checksum += Bits;
+
+        Writer->Columns[ColumnIndex][Writer->BufferedCount] = Values[ColumnIndex];
+    }
+
+    if(++Writer->BufferedCount == HAVERSINE_BINARY_WRITE_CHUNK)
+    {
+        FlushHaversineColumns(Writer);
+    }
+}
+
+inline b32 EndHaversineBinary(haversine_binary_writer *Writer, f64 ExpectedSum)
+{
+    if(Writer->BufferedCount)
+    {
+        FlushHaversineColumns(Writer);
+    }
+
+    if(Writer->FlushedCount != Writer->PairCount)
+    {
+        fprintf(stderr, "ERROR: Binary pair file expected %llu pairs, but %llu were written.\n",
+                Writer->PairCount, Writer->FlushedCount);
+        Writer->WriteError = true;
+    }
+
+    // NOTE(casey): Make sure the padding after the last column actually exists in the file
+    if(Writer->ColumnStride > (Writer->PairCount*sizeof(f64)))
+    {
+        u64 TotalSize = GetHaversineBinarySize(Writer->PairCount);
+        u8 Zero = 0;
+        if((SeekFile64(Writer->File, TotalSize - 1, SEEK_SET) != 0) ||
+           (fwrite(&Zero, 1, 1, Writer->File) != 1))
+        {
+            Writer->WriteError = true;
+        }
+    }
+
+    haversine_binary_header Header = {};
+    Header.MagicValue = HAVERSINE_BINARY_MAGIC;
+    Header.Version = HAVERSINE_BINARY_VERSION;
+    Header.HeaderSize = sizeof(Header);
+    Header.PairCount = Writer->PairCount;
+    Header.ColumnStride = Writer->ColumnStride;
+    Header.Checksum = Writer->Checksum;
+    Header.ExpectedSum = ExpectedSum;
+    if((SeekFile64(Writer->File, 0, SEEK_SET) != 0) ||
+       (fwrite(&Header, sizeof(Header), 1, Writer->File) != 1))
+    {
+        Writer->WriteError = true;
+    }
+
+    b32 Result = !Writer->WriteError;
+    return Result;
+}
+
+inline b32 IsValid(haversine_binary_header *Header, u64 FileSize)
+{
+    b32 Result = ((FileSize >= sizeof(haversine_binary_header)) &&
+                  (Header->MagicValue == HAVERSINE_BINARY_MAGIC) &&
+                  (Header->Version == HAVERSINE_BINARY_VERSION) &&
+                  (Header->HeaderSize == sizeof(haversine_binary_header)) &&
+                  (Header->ColumnStride == GetHaversineColumnStride(Header->PairCount)) &&
+                  (FileSize >= GetHaversineBinarySize(Header->PairCount)));
+    return Result;
+}
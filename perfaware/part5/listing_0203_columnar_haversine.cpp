@@ -0,0 +1,505 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+   
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+   
+   Please see https://computerenhance.com for more information
+   
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 203
+   ======================================================================== */
+
+/* NOTE(casey): The radius of the Earth is set to 6372.8 because that was
+   the constant used in the original question on which this code is based.
+   The Earth is not a perfect sphere, but it is outside the scope of our
+   exploration here to ask what the best value would be for this constant. */
+#define QUESTIONABLE_EARTH_RADIUS 6372.8
+
+#include "listing_0201_haversine_binary_format.cpp"
+
+struct haversine_pair
+{
+    f64 X0, Y0;
+    f64 X1, Y1;
+};
+
+struct haversine_columns
+{
+    f64 *X0;
+    f64 *Y0;
+    f64 *X1;
+    f64 *Y1;
+};
+
+struct haversine_columns32
+{
+    f32 *X0;
+    f32 *Y0;
+    f32 *X1;
+    f32 *Y1;
+};
+
+enum summation_strategy
+{
+    Summation_Serial, // NOTE(casey): Whatever the compute function does on its own, which for most of them is one running sum
+    Summation_MultiAccumulator,
+    Summation_Pairwise,
+    Summation_Kahan,
+    
+    Summation_Count,
+};
+
+struct haversine_setup
+{
+    buffer JSONBuffer;
+    buffer AnswerBuffer;
+    buffer ParsedPairsBuffer;
+    buffer ColumnsBuffer;
+    buffer Columns32Buffer;
+    
+    // NOTE(casey): These are only open when the pairs came from a binary pair file, and the answers only if an answer file was given
+    b32 Mapped;
+    b32 MappedAnswersOpen;
+    memory_mapped_file MappedPairs;
+    memory_mapped_file MappedAnswers;
+    haversine_binary_header *BinaryHeader;
+    
+    u64 ParsedByteCount;
+    
+    u64 PairCount;
+    haversine_pair *Pairs; // NOTE(casey): Will be 0 for binary pair files unless BuildPairsFromColumns is called
+    haversine_columns Columns;
+    haversine_columns32 Columns32; // NOTE(casey): Will be 0 unless BuildColumns32 is called
+    f64 *Answers;
+    
+    f64 SumAnswer;
+    
+    // NOTE(casey): Only compute functions built on a haversine_accumulator look at this
+    summation_strategy Summation;
+    
+    b32 Valid;
+};
+
+typedef f64 haversine_compute_func(haversine_setup Setup);
+typedef u64 haversine_verify_func(haversine_setup Setup);
+
+#include "listing_0069_lookup_json_parser.cpp"
+
+static f64 Square(f64 A)
+{
+    f64 Result = (A*A);
+    return Result;
+}
+
+static b32 ApproxAreEqual(f64 A, f64 B)
+{
+    /* NOTE(casey): Epsilon can be set to whatever tolerance we decide we will accept. If we make this value larger,
+       we have more options for optimization. If we make it smaller, we must more closely follow the sequence
+       of floating point operations that produced the original value. At zero, we would have to reproduce the
+       sequence _exactly_. */
+    f64 Epsilon = 0.00000001f;
+    
+    f64 Diff = (A - B);
+    b32 Result = (Diff > -Epsilon) && (Diff < Epsilon);
+    return Result;
+}
+
+static f64 RadiansFromDegrees(f64 Degrees)
+{
+    f64 Result = 0.01745329251994329577 * Degrees;
+    return Result;
+}
+
+static f64 ReferenceHaversine(f64 X0, f64 Y0, f64 X1, f64 Y1, f64 EarthRadius)
+{
+    /* NOTE(casey): This is not meant to be a "good" way to calculate the Haversine distance.
+       Instead, it attempts to follow, as closely as possible, the formula used in the real-world
+       question on which these homework exercises are loosely based.
+    */
+    
+    f64 lat1 = Y0;
+    f64 lat2 = Y1;
+    f64 lon1 = X0;
+    f64 lon2 = X1;
+    
+    f64 dLat = RadiansFromDegrees(lat2 - lat1);
+    f64 dLon = RadiansFromDegrees(lon2 - lon1);
+    lat1 = RadiansFromDegrees(lat1);
+    lat2 = RadiansFromDegrees(lat2);
+    
+    f64 a = Square(sin(dLat/2.0)) + cos(lat1)*cos(lat2)*Square(sin(dLon/2));
+    f64 c = 2.0*asin(sqrt(a));
+    
+    f64 Result = EarthRadius * c;
+    
+    return Result;
+}
+
+inline f64 ReferenceSumHaversine(haversine_setup Setup)
+{
+    u64 PairCount = Setup.PairCount;
+    haversine_pair *Pairs = Setup.Pairs;
+    
+    f64 Sum = 0;
+    
+    f64 SumCoef = 1 / (f64)PairCount;
+    for(u64 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+    {
+        haversine_pair Pair = Pairs[PairIndex];
+        f64 EarthRadius = QUESTIONABLE_EARTH_RADIUS;
+        f64 Dist = ReferenceHaversine(Pair.X0, Pair.Y0, Pair.X1, Pair.Y1, EarthRadius);
+        Sum += SumCoef*Dist;
+    }
+    
+    return Sum;
+}
+
+inline u64 ReferenceVerifyHaversine(haversine_setup Setup)
+{
+    u64 PairCount = Setup.PairCount;
+    haversine_pair *Pairs = Setup.Pairs;
+    f64 *Answers = Setup.Answers;
+    
+    u64 ErrorCount = 0;
+    
+    for(u64 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+    {
+        haversine_pair Pair = Pairs[PairIndex];
+        f64 EarthRadius = QUESTIONABLE_EARTH_RADIUS;
+        f64 Dist = ReferenceHaversine(Pair.X0, Pair.Y0, Pair.X1, Pair.Y1, EarthRadius);
+        if(!ApproxAreEqual(Dist, Answers[PairIndex]))
+        {
+            ++ErrorCount;
+        }
+    }
+    
+    return ErrorCount;
+}
+
+inline f64 ReferenceSumHaversineColumns(haversine_setup Setup)
+{
+    u64 PairCount = Setup.PairCount;
+    haversine_columns Columns = Setup.Columns;
+    
+    f64 Sum = 0;
+    
+    f64 SumCoef = 1 / (f64)PairCount;
+    for(u64 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+    {
+        f64 EarthRadius = QUESTIONABLE_EARTH_RADIUS;
+        f64 Dist = ReferenceHaversine(Columns.X0[PairIndex], Columns.Y0[PairIndex],
+                                      Columns.X1[PairIndex], Columns.Y1[PairIndex], EarthRadius);
+        Sum += SumCoef*Dist;
+    }
+    
+    return Sum;
+}
+
+inline b32 IsValid(haversine_setup Setup)
+{
+    b32 Result = Setup.Valid;
+    return Result;
+}
+
+static haversine_columns GetColumns(u8 *Base, u64 ColumnStride)
+{
+    haversine_columns Result = {};
+    Result.X0 = (f64 *)(Base + HaversineColumn_X0*ColumnStride);
+    Result.Y0 = (f64 *)(Base + HaversineColumn_Y0*ColumnStride);
+    Result.X1 = (f64 *)(Base + HaversineColumn_X1*ColumnStride);
+    Result.Y1 = (f64 *)(Base + HaversineColumn_Y1*ColumnStride);
+    
+    return Result;
+}
+
+static b32 IsHaversineBinaryFile(char *FileName)
+{
+    b32 Result = false;
+    
+    FILE *File = fopen(FileName, "rb");
+    if(File)
+    {
+        haversine_binary_header Header = {};
+        if(fread(&Header, sizeof(Header), 1, File) == 1)
+        {
+            Result = (Header.MagicValue == HAVERSINE_BINARY_MAGIC);
+        }
+        
+        fclose(File);
+    }
+    
+    return Result;
+}
+
+static b32 CheckAnswerCount(haversine_setup *Setup, u64 AnswerCount)
+{
+    b32 Result = (AnswerCount == (Setup->PairCount + 1));
+    if(!Result)
+    {
+        fprintf(stderr, "ERROR: Source data has %llu pairs, but answer file has %llu values (should have %llu).\n",
+                Setup->PairCount, AnswerCount, Setup->PairCount + 1);
+    }
+    
+    return Result;
+}
+
+static void SetUpHaversineJSON(haversine_setup *Result, char *PairsJSONFileName, char *AnswerFileName)
+{
+    Result->JSONBuffer = ReadEntireFile(PairsJSONFileName);
+    if(AnswerFileName)
+    {
+        Result->AnswerBuffer = ReadEntireFile(AnswerFileName);
+    }
+    
+    u32 MinimumJSONPairEncoding = 16; // NOTE(casey): There should be no way to define a pair in JSON without substantially more characters than this
+    u64 MaxPairCount = Result->JSONBuffer.Count / MinimumJSONPairEncoding;
+    Result->ParsedPairsBuffer = AllocateBuffer(sizeof(haversine_pair) * MaxPairCount);
+    
+    if(IsValid(Result->JSONBuffer) && (!AnswerFileName || IsValid(Result->AnswerBuffer)) && IsValid(Result->ParsedPairsBuffer))
+    {
+        Result->Pairs = (haversine_pair *)Result->ParsedPairsBuffer.Data;
+        Result->PairCount = ParseHaversinePairs(Result->JSONBuffer, MaxPairCount, Result->Pairs);
+        
+        u64 AnswerCount = Result->AnswerBuffer.Count / sizeof(f64);
+        if(!AnswerFileName || CheckAnswerCount(Result, AnswerCount))
+        {
+            // NOTE(casey): Code that wants columns shouldn't have to care where the pairs came from,
+            // so we transpose them here. This is cheap compared to the parse.
+            u64 ColumnStride = GetHaversineColumnStride(Result->PairCount);
+            Result->ColumnsBuffer = AllocateBuffer(HaversineColumn_Count*ColumnStride);
+            if(IsValid(Result->ColumnsBuffer))
+            {
+                Result->Columns = GetColumns(Result->ColumnsBuffer.Data, ColumnStride);
+                for(u64 PairIndex = 0; PairIndex < Result->PairCount; ++PairIndex)
+                {
+                    haversine_pair Pair = Result->Pairs[PairIndex];
+                    Result->Columns.X0[PairIndex] = Pair.X0;
+                    Result->Columns.Y0[PairIndex] = Pair.Y0;
+                    Result->Columns.X1[PairIndex] = Pair.X1;
+                    Result->Columns.Y1[PairIndex] = Pair.Y1;
+                }
+                
+                if(AnswerFileName)
+                {
+                    Result->Answers = (f64 *)Result->AnswerBuffer.Data;
+                    Result->SumAnswer = Result->Answers[Result->PairCount];
+                }
+                
+                u64 Megabyte = 1024*1024;
+                fprintf(stdout, "Source JSON: %llumb\n", Result->JSONBuffer.Count/Megabyte);
+                
+                Result->Valid = (Result->PairCount != 0);
+            }
+        }
+    }
+}
+
+static void SetUpHaversineBinary(haversine_setup *Result, char *PairsBinaryFileName, char *AnswerFileName)
+{
+    /* NOTE(casey): Nothing here touches the pair data itself. The columns are used
+       directly out of the mapped file, so setup costs a few system calls no matter
+       how many pairs there are. */
+    
+    Result->Mapped = true;
+    Result->MappedPairs = OpenMemoryMappedFile(PairsBinaryFileName);
+    u64 PairsFileSize = GetFileSize(PairsBinaryFileName);
+    if(IsValid(Result->MappedPairs) && PairsFileSize)
+    {
+        SetMapRegion(&Result->MappedPairs, 0, PairsFileSize);
+    }
+    
+    u64 AnswersFileSize = 0;
+    if(AnswerFileName)
+    {
+        Result->MappedAnswersOpen = true;
+        Result->MappedAnswers = OpenMemoryMappedFile(AnswerFileName);
+        AnswersFileSize = GetFileSize(AnswerFileName);
+        if(IsValid(Result->MappedAnswers) && AnswersFileSize)
+        {
+            SetMapRegion(&Result->MappedAnswers, 0, AnswersFileSize);
+        }
+    }
+    
+    if(IsValid(Result->MappedPairs.Memory) && (!AnswerFileName || IsValid(Result->MappedAnswers.Memory)))
+    {
+        haversine_binary_header *Header = (haversine_binary_header *)Result->MappedPairs.Memory.Data;
+        if(IsValid(Header, PairsFileSize))
+        {
+            Result->BinaryHeader = Header;
+            Result->PairCount = Header->PairCount;
+            Result->Columns = GetColumns((u8 *)(Header + 1), Header->ColumnStride);
+            
+            u64 AnswerCount = AnswersFileSize / sizeof(f64);
+            if(!AnswerFileName || CheckAnswerCount(Result, AnswerCount))
+            {
+                if(AnswerFileName)
+                {
+                    Result->Answers = (f64 *)Result->MappedAnswers.Memory.Data;
+                    Result->SumAnswer = Result->Answers[Result->PairCount];
+                    if(Result->SumAnswer != Header->ExpectedSum)
+                    {
+                        fprintf(stderr, "WARNING: Binary pair file expects a sum of %.16f, but the answer file has %.16f.\n",
+                                Header->ExpectedSum, Result->SumAnswer);
+                    }
+                }
+                
+                u64 Megabyte = 1024*1024;
+                fprintf(stdout, "Source binary: %llumb (mapped)\n", PairsFileSize/Megabyte);
+                
+                Result->Valid = (Result->PairCount != 0);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: \"%s\" is not a valid binary pair file.\n", PairsBinaryFileName);
+        }
+    }
+    else
+    {
+        if(AnswerFileName)
+        {
+            fprintf(stderr, "ERROR: Unable to map \"%s\" and \"%s\".\n", PairsBinaryFileName, AnswerFileName);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Unable to map \"%s\".\n", PairsBinaryFileName);
+        }
+    }
+}
+
+inline haversine_setup SetUpHaversine(char *PairsFileName, char *AnswerFileName)
+{
+    // NOTE(casey): AnswerFileName can be 0, for code that gets its answers some other way. Answers will be 0 then.
+    haversine_setup Result = {};
+    
+    if(IsHaversineBinaryFile(PairsFileName))
+    {
+        SetUpHaversineBinary(&Result, PairsFileName, AnswerFileName);
+    }
+    else
+    {
+        SetUpHaversineJSON(&Result, PairsFileName, AnswerFileName);
+    }
+    
+    if(Result.Valid)
+    {
+        Result.ParsedByteCount = (sizeof(haversine_pair)*Result.PairCount);
+        
+        u64 Megabyte = 1024*1024;
+        fprintf(stdout, "Parsed: %llumb (%llu pairs)\n", Result.ParsedByteCount/Megabyte, Result.PairCount);
+    }
+    
+    return Result;
+}
+
+inline b32 BuildPairsFromColumns(haversine_setup *Setup)
+{
+    /* NOTE(casey): Binary pair files only have columns. Anything that still wants an
+       array of haversine_pair has to pay for an interleaving pass first. */
+    
+    if(!Setup->Pairs && Setup->Valid)
+    {
+        Setup->ParsedPairsBuffer = AllocateBuffer(sizeof(haversine_pair)*Setup->PairCount);
+        if(IsValid(Setup->ParsedPairsBuffer))
+        {
+            haversine_columns Columns = Setup->Columns;
+            haversine_pair *Pairs = (haversine_pair *)Setup->ParsedPairsBuffer.Data;
+            for(u64 PairIndex = 0; PairIndex < Setup->PairCount; ++PairIndex)
+            {
+                haversine_pair *Pair = Pairs + PairIndex;
+                Pair->X0 = Columns.X0[PairIndex];
+                Pair->Y0 = Columns.Y0[PairIndex];
+                Pair->X1 = Columns.X1[PairIndex];
+                Pair->Y1 = Columns.Y1[PairIndex];
+            }
+            
+            Setup->Pairs = Pairs;
+        }
+    }
+    
+    b32 Result = (Setup->Pairs != 0);
+    return Result;
+}
+
+inline b32 BuildColumns32(haversine_setup *Setup)
+{
+    /* NOTE(casey): Single-precision copies of the columns, for kernels that can live
+       with float coordinates. They take half the memory, so they take half the bandwidth. */
+    
+    if(!Setup->Columns32.X0 && Setup->Valid)
+    {
+        u64 Mask = HAVERSINE_COLUMN_ALIGNMENT - 1;
+        u64 ColumnStride = (Setup->PairCount*sizeof(f32) + Mask) & ~Mask;
+        Setup->Columns32Buffer = AllocateBuffer(HaversineColumn_Count*ColumnStride);
+        if(IsValid(Setup->Columns32Buffer))
+        {
+            u8 *Base = Setup->Columns32Buffer.Data;
+            haversine_columns32 Columns32 = {};
+            Columns32.X0 = (f32 *)(Base + HaversineColumn_X0*ColumnStride);
+            Columns32.Y0 = (f32 *)(Base + HaversineColumn_Y0*ColumnStride);
+            Columns32.X1 = (f32 *)(Base + HaversineColumn_X1*ColumnStride);
+            Columns32.Y1 = (f32 *)(Base + HaversineColumn_Y1*ColumnStride);
+            
+            haversine_columns Columns = Setup->Columns;
+            for(u64 PairIndex = 0; PairIndex < Setup->PairCount; ++PairIndex)
+            {
+                Columns32.X0[PairIndex] = (f32)Columns.X0[PairIndex];
+                Columns32.Y0[PairIndex] = (f32)Columns.Y0[PairIndex];
+                Columns32.X1[PairIndex] = (f32)Columns.X1[PairIndex];
+                Columns32.Y1[PairIndex] = (f32)Columns.Y1[PairIndex];
+            }
+            
+            Setup->Columns32 = Columns32;
+        }
+    }
+    
+    b32 Result = (Setup->Columns32.X0 != 0);
+    return Result;
+}
+
+inline b32 VerifyHaversineChecksum(haversine_setup Setup)
+{
+    // NOTE(casey): This touches every byte of the pair data, so it is not part of setup
+    b32 Result = true;
+    
+    haversine_binary_header *Header = Setup.BinaryHeader;
+    if(Header)
+    {
+        u64 Checksum = 0;
+        u64 *Values = (u64 *)(Header + 1);
+        u64 ValueCount = (HaversineColumn_Count*Header->ColumnStride) / sizeof(u64);
+        for(u64 ValueIndex = 0; ValueIndex < ValueCount; ++ValueIndex)
+        {
+            Checksum += Values[ValueIndex];
+        }
+        
+        Result = (Checksum == Header->Checksum);
+    }
+    
+    return Result;
+}
+
+inline void FreeHaversine(haversine_setup *Setup)
+{
+    FreeBuffer(&Setup->JSONBuffer);
+    FreeBuffer(&Setup->ParsedPairsBuffer);
+    FreeBuffer(&Setup->ColumnsBuffer);
+    FreeBuffer(&Setup->Columns32Buffer);
+    FreeBuffer(&Setup->AnswerBuffer);
+    
+    if(Setup->Mapped)
+    {
+        CloseMemoryMappedFile(&Setup->MappedPairs);
+        if(Setup->MappedAnswersOpen)
+        {
+            CloseMemoryMappedFile(&Setup->MappedAnswers);
+        }
+    }
+    
+    *Setup = {};
+}
@@ -0,0 +1,110 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 204
+   ======================================================================== */
+
+/* NOTE(casey): _CRT_SECURE_NO_WARNINGS is here because otherwise we cannot
+   call fopen(). If we replace fopen() with fopen_s() to avoid the warning,
+   then the code doesn't compile on Linux anymore, since fopen_s() does not
+   exist there.
+
+   What exactly the CRT maintainers were thinking when they made this choice,
+   I have no idea. */
+#define _CRT_SECURE_NO_WARNINGS
+
+#define __STDC_WANT_LIB_EXT1__ 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef int32_t b32;
+
+typedef float f32;
+typedef double f64;
+
+#define ArrayCount(Array) (sizeof(Array)/sizeof((Array)[0]))
+
+#include "listing_0125_buffer.cpp"
+#include "listing_0169_os_platform.cpp"
+#include "listing_0203_columnar_haversine.cpp"
+
+static void TestSetUp(char *PairsFileName, char *AnswerFileName)
+{
+    fprintf(stdout, "\n--- %s ---\n", PairsFileName);
+    
+    u64 StartFaults = ReadOSPageFaultCount();
+    u64 StartTime = ReadCPUTimer();
+    haversine_setup Setup = SetUpHaversine(PairsFileName, AnswerFileName);
+    u64 SetUpTime = ReadCPUTimer() - StartTime;
+    u64 SetUpFaults = ReadOSPageFaultCount() - StartFaults;
+    
+    if(IsValid(Setup))
+    {
+        u64 CPUTimerFreq = GetCPUTimerFreq();
+        fprintf(stdout, "SetUpHaversine: %fms (%llu page faults)\n",
+                1000.0*(f64)SetUpTime/(f64)CPUTimerFreq, SetUpFaults);
+        
+        if(Setup.BinaryHeader)
+        {
+            StartTime = ReadCPUTimer();
+            b32 ChecksumValid = VerifyHaversineChecksum(Setup);
+            u64 ChecksumTime = ReadCPUTimer() - StartTime;
+            fprintf(stdout, "Checksum: %s (%fms)\n", ChecksumValid ? "valid" : "INVALID",
+                    1000.0*(f64)ChecksumTime/(f64)CPUTimerFreq);
+        }
+        
+        f64 Sum = ReferenceSumHaversineColumns(Setup);
+        fprintf(stdout, "Sum: %.16f (%+.24f)\n", Sum, Sum - Setup.SumAnswer);
+        if(!ApproxAreEqual(Sum, Setup.SumAnswer))
+        {
+            fprintf(stderr, "WARNING: Sum mismatch\n");
+        }
+    }
+    
+    FreeHaversine(&Setup);
+}
+
+int main(int ArgCount, char **Args)
+{
+    InitializeOSPlatform();
+    
+    if(ArgCount == 4)
+    {
+        TestSetUp(Args[1], Args[3]);
+        TestSetUp(Args[2], Args[3]);
+    }
+    else
+    {
+        fprintf(stderr, "Usage: %s [haversine JSON file] [haversine binary file] [haversine answer file]\n", Args[0]);
+    }
+    
+    (void)&ReferenceSumHaversine;
+    (void)&ReferenceVerifyHaversine;
+    (void)&BuildPairsFromColumns;
+    
+    return 0;
+}
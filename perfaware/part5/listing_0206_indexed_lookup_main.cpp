@@ -0,0 +1,192 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 206
+   ======================================================================== */
+
+/* NOTE(casey): _CRT_SECURE_NO_WARNINGS is here because otherwise we cannot
+   call fopen(). If we replace fopen() with fopen_s() to avoid the warning,
+   then the code doesn't compile on Linux anymore, since fopen_s() does not
+   exist there.
+
+   What exactly the CRT maintainers were thinking when they made this choice,
+   I have no idea. */
+#define _CRT_SECURE_NO_WARNINGS
+
+#define __STDC_WANT_LIB_EXT1__ 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef int32_t b32;
+
+typedef float f32;
+typedef double f64;
+
+#define ArrayCount(Array) (sizeof(Array)/sizeof((Array)[0]))
+
+struct haversine_pair
+{
+    f64 X0, Y0;
+    f64 X1, Y1;
+};
+
+#include "listing_0125_buffer.cpp"
+#include "listing_0169_os_platform.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+#include "listing_0205_indexed_lookup_json_parser.cpp"
+
+#define LOOKUPS_PER_TEST 4096
+#define MAX_LABEL_SIZE 32
+
+typedef json_element *lookup_func(json_element *Object, buffer ElementName);
+
+struct test_function
+{
+    char const *Name;
+    lookup_func *Lookup;
+};
+static test_function TestFunctions[] =
+{
+    {"LookupElementLinear", LookupElementLinear},
+    {"LookupElement", LookupElement},
+};
+
+static buffer MakeWideObjectJSON(u64 LabelCount, u8 *Labels)
+{
+    // NOTE(casey): {"key0": 0, "key1": 1, ...} - every label is written into Labels as well, at MAX_LABEL_SIZE stride
+    buffer Result = AllocateBuffer(LabelCount*(2*MAX_LABEL_SIZE) + 16);
+    if(IsValid(Result))
+    {
+        char *At = (char *)Result.Data;
+        *At++ = '{';
+        for(u64 LabelIndex = 0; LabelIndex < LabelCount; ++LabelIndex)
+        {
+            char *Label = (char *)Labels + LabelIndex*MAX_LABEL_SIZE;
+            snprintf(Label, MAX_LABEL_SIZE, "key%llu", LabelIndex);
+            At += sprintf(At, "%s\"%s\": %llu", LabelIndex ? ", " : "", Label, LabelIndex);
+        }
+        *At++ = '}';
+
+        Result.Count = (u64)(At - (char *)Result.Data);
+    }
+
+    return Result;
+}
+
+int main(void)
+{
+    InitializeOSPlatform();
+
+    u64 MaxLabelCount = 4096;
+    buffer LabelBuffer = AllocateBuffer(MaxLabelCount*MAX_LABEL_SIZE);
+    buffer ExpectedBuffer = AllocateBuffer(MaxLabelCount*sizeof(json_element *));
+    repetition_test_series TestSeries = AllocateTestSeries(ArrayCount(TestFunctions), 64);
+    if(IsValid(LabelBuffer) && IsValid(ExpectedBuffer) && IsValid(TestSeries))
+    {
+        json_element **Expected = (json_element **)ExpectedBuffer.Data;
+
+        SetRowLabelLabel(&TestSeries, "Labels");
+        for(u64 LabelCount = 2; LabelCount <= MaxLabelCount; LabelCount *= 2)
+        {
+            buffer JSONBuffer = MakeWideObjectJSON(LabelCount, LabelBuffer.Data);
+            json_element *Object = ParseJSON(JSONBuffer);
+
+            u64 ElementIndex = 0;
+            for(json_element *Element = Object ? Object->FirstSubElement : 0; Element; Element = Element->NextSibling)
+            {
+                Expected[ElementIndex++] = Element;
+            }
+
+            if(ElementIndex == LabelCount)
+            {
+                SetRowLabel(&TestSeries, "%llu", LabelCount);
+                for(u32 TestFunctionIndex = 0; TestFunctionIndex < ArrayCount(TestFunctions); ++TestFunctionIndex)
+                {
+                    test_function Function = TestFunctions[TestFunctionIndex];
+
+                    SetColumnLabel(&TestSeries, "%s", Function.Name);
+
+                    repetition_tester Tester = {};
+                    NewTestWave(&TestSeries, &Tester, LOOKUPS_PER_TEST, GetCPUTimerFreq());
+
+                    b32 Passed = true;
+                    while(IsTesting(&TestSeries, &Tester))
+                    {
+                        u64 MismatchCount = 0;
+
+                        BeginTime(&Tester);
+                        for(u64 LookupIndex = 0; LookupIndex < LOOKUPS_PER_TEST; ++LookupIndex)
+                        {
+                            // NOTE(casey): Stride through the labels so every lookup hits a different one
+                            u64 LabelIndex = (LookupIndex*7919) % LabelCount;
+                            buffer Name = {};
+                            Name.Data = LabelBuffer.Data + LabelIndex*MAX_LABEL_SIZE;
+                            Name.Count = strlen((char *)Name.Data);
+
+                            json_element *Element = Function.Lookup(Object, Name);
+                            MismatchCount += (Element != Expected[LabelIndex]);
+                        }
+                        CountBytes(&Tester, LOOKUPS_PER_TEST);
+                        EndTime(&Tester);
+
+                        if(MismatchCount)
+                        {
+                            Passed = false;
+                        }
+                    }
+
+                    if(!Passed)
+                    {
+                        fprintf(stderr, "WARNING: %s returned the wrong element\n", Function.Name);
+                    }
+                }
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: Parsed %llu labels, expected %llu\n", ElementIndex, LabelCount);
+            }
+
+            FreeJSON(Object);
+            FreeBuffer(&JSONBuffer);
+        }
+
+        // NOTE(casey): Each test does LOOKUPS_PER_TEST lookups, so this prints nanoseconds per lookup
+        PrintCSVForValue(&TestSeries, StatValue_Seconds, stdout, 1000000000.0 / (f64)LOOKUPS_PER_TEST);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate test memory\n");
+    }
+
+    FreeBuffer(&LabelBuffer);
+    FreeBuffer(&ExpectedBuffer);
+    FreeTestSeries(&TestSeries);
+
+    (void)&ParseHaversinePairs;
+
+    return 0;
+}
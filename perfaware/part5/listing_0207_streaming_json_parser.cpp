@@ -0,0 +1,579 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 207
+   ======================================================================== */
+
+/* NOTE(casey): This is a push parser - instead of handing it the entire file, you hand it
+   whatever bytes you happen to have, in pieces of any size, and it picks up exactly where it
+   left off. Tokens that fit inside a chunk are used in place. Only a token that straddles a
+   chunk boundary gets copied into PartialToken, so memory use is fixed no matter how large
+   the input is. */
+#define JSON_STREAM_MAX_TOKEN_SIZE 256
+#define JSON_STREAM_MAX_DEPTH 64
+
+typedef void haversine_pair_callback(void *Context, haversine_pair Pair);
+
+enum json_stream_token_state : u32
+{
+    StreamToken_None,
+    StreamToken_String,
+    StreamToken_Number,
+    StreamToken_Keyword,
+};
+
+enum json_stream_expect : u32
+{
+    StreamExpect_Value,
+    StreamExpect_ValueOrClose,
+    StreamExpect_Label,
+    StreamExpect_LabelOrClose,
+    StreamExpect_Colon,
+    StreamExpect_CommaOrClose,
+    StreamExpect_End,
+};
+
+enum json_stream_label : u32
+{
+    StreamLabel_Other,
+    StreamLabel_Pairs,
+    StreamLabel_X0,
+    StreamLabel_Y0,
+    StreamLabel_X1,
+    StreamLabel_Y1,
+};
+
+struct json_stream_parser
+{
+    haversine_pair_callback *Callback;
+    void *CallbackContext;
+
+    b32 HadError;
+    u64 PairCount;
+
+    // NOTE(casey): Tokenizer state
+    json_stream_token_state TokenState;
+    b32 Escaped;
+    u32 PartialTokenCount;
+    u8 PartialToken[JSON_STREAM_MAX_TOKEN_SIZE];
+
+    // NOTE(casey): Structure state
+    json_stream_expect Expect;
+    json_stream_label Label;
+    u32 Depth;
+    u8 Containers[JSON_STREAM_MAX_DEPTH];
+
+    // NOTE(casey): Haversine record state - zero depth means "not inside one"
+    u32 PairsArrayDepth;
+    u32 PairObjectDepth;
+    u32 PairFieldMask;
+    haversine_pair Pair;
+};
+
+static json_stream_parser BeginJSONStream(haversine_pair_callback *Callback, void *CallbackContext)
+{
+    json_stream_parser Result = {};
+    Result.Callback = Callback;
+    Result.CallbackContext = CallbackContext;
+    Result.Expect = StreamExpect_Value;
+
+    return Result;
+}
+
+static void StreamError(json_stream_parser *Parser, buffer Value, char const *Message)
+{
+    if(!Parser->HadError)
+    {
+        Parser->HadError = true;
+        fprintf(stderr, "ERROR: \"%.*s\" - %s\n", (u32)Value.Count, (char *)Value.Data, Message);
+    }
+}
+
+static f64 ConvertJSONValueToF64(buffer Source)
+{
+    // NOTE(casey): This is ConvertElementToF64 without the lookup, so streamed pairs come out bit-identical to parsed ones
+    u64 At = 0;
+
+    f64 Sign = ConvertJSONSign(Source, &At);
+    f64 Number = ConvertJSONNumber(Source, &At);
+
+    if(IsInBounds(Source, At) && (Source.Data[At] == '.'))
+    {
+        ++At;
+        f64 C = 1.0 / 10.0;
+        while(IsInBounds(Source, At))
+        {
+            u8 Char = Source.Data[At] - (u8)'0';
+            if(Char < 10)
+            {
+                Number = Number + C*(f64)Char;
+                C *= 1.0 / 10.0;
+                ++At;
+            }
+            else
+            {
+                break;
+            }
+        }
+    }
+
+    if(IsInBounds(Source, At) && ((Source.Data[At] == 'e') || (Source.Data[At] == 'E')))
+    {
+        ++At;
+        if(IsInBounds(Source, At) && (Source.Data[At] == '+'))
+        {
+            ++At;
+        }
+
+        f64 ExponentSign = ConvertJSONSign(Source, &At);
+        f64 Exponent = ExponentSign*ConvertJSONNumber(Source, &At);
+        Number *= pow(10.0, Exponent);
+    }
+
+    f64 Result = Sign*Number;
+    return Result;
+}
+
+static json_stream_label ClassifyStreamLabel(json_stream_parser *Parser, buffer Label)
+{
+    json_stream_label Result = StreamLabel_Other;
+
+    if(Parser->PairObjectDepth && (Parser->Depth == Parser->PairObjectDepth))
+    {
+        if(AreEqual(Label, CONSTANT_STRING("x0"))) {Result = StreamLabel_X0;}
+        else if(AreEqual(Label, CONSTANT_STRING("y0"))) {Result = StreamLabel_Y0;}
+        else if(AreEqual(Label, CONSTANT_STRING("x1"))) {Result = StreamLabel_X1;}
+        else if(AreEqual(Label, CONSTANT_STRING("y1"))) {Result = StreamLabel_Y1;}
+    }
+    else if((Parser->Depth == 1) && AreEqual(Label, CONSTANT_STRING("pairs")))
+    {
+        Result = StreamLabel_Pairs;
+    }
+
+    return Result;
+}
+
+static void EndStreamValue(json_stream_parser *Parser)
+{
+    Parser->Label = StreamLabel_Other;
+    Parser->Expect = Parser->Depth ? StreamExpect_CommaOrClose : StreamExpect_End;
+}
+
+static void StoreStreamPairField(json_stream_parser *Parser, buffer Value)
+{
+    u32 FieldIndex = Parser->Label - StreamLabel_X0;
+    u32 FieldBit = (1 << FieldIndex);
+
+    // NOTE(casey): If a label is repeated, the first one wins, same as LookupElement
+    if(!(Parser->PairFieldMask & FieldBit))
+    {
+        f64 *Fields = &Parser->Pair.X0;
+        Fields[FieldIndex] = ConvertJSONValueToF64(Value);
+        Parser->PairFieldMask |= FieldBit;
+    }
+}
+
+static void HandleStreamOpen(json_stream_parser *Parser, json_token_type Type, buffer Value)
+{
+    if((Parser->Expect == StreamExpect_Value) || (Parser->Expect == StreamExpect_ValueOrClose))
+    {
+        if(Parser->Depth < JSON_STREAM_MAX_DEPTH)
+        {
+            b32 IsPairsArray = ((Type == Token_open_bracket) && (Parser->Label == StreamLabel_Pairs));
+            b32 IsPairObject = ((Type == Token_open_brace) &&
+                                Parser->PairsArrayDepth && (Parser->Depth == Parser->PairsArrayDepth));
+
+            Parser->Containers[Parser->Depth++] = Value.Data[0];
+            Parser->Label = StreamLabel_Other;
+
+            if(Type == Token_open_brace)
+            {
+                Parser->Expect = StreamExpect_LabelOrClose;
+            }
+            else
+            {
+                Parser->Expect = StreamExpect_ValueOrClose;
+            }
+
+            if(IsPairsArray)
+            {
+                Parser->PairsArrayDepth = Parser->Depth;
+            }
+
+            if(IsPairObject)
+            {
+                Parser->PairObjectDepth = Parser->Depth;
+                Parser->PairFieldMask = 0;
+                Parser->Pair = {};
+            }
+        }
+        else
+        {
+            StreamError(Parser, Value, "JSON nested too deeply");
+        }
+    }
+    else
+    {
+        StreamError(Parser, Value, "Unexpected token in JSON");
+    }
+}
+
+static void HandleStreamClose(json_stream_parser *Parser, json_token_type Type, buffer Value)
+{
+    u8 Open = (Type == Token_close_brace) ? '{' : '[';
+    b32 CanClose = ((Parser->Expect == StreamExpect_CommaOrClose) ||
+                    ((Type == Token_close_brace) && (Parser->Expect == StreamExpect_LabelOrClose)) ||
+                    ((Type == Token_close_bracket) && (Parser->Expect == StreamExpect_ValueOrClose)));
+
+    if(CanClose && Parser->Depth && (Parser->Containers[Parser->Depth - 1] == Open))
+    {
+        if(Parser->Depth == Parser->PairObjectDepth)
+        {
+            // NOTE(casey): Missing fields stay 0.0, which is also what ConvertElementToF64 does
+            Parser->Callback(Parser->CallbackContext, Parser->Pair);
+            ++Parser->PairCount;
+            Parser->PairObjectDepth = 0;
+        }
+        else if(Parser->Depth == Parser->PairsArrayDepth)
+        {
+            Parser->PairsArrayDepth = 0;
+        }
+
+        --Parser->Depth;
+        EndStreamValue(Parser);
+    }
+    else
+    {
+        StreamError(Parser, Value, "Unexpected token in JSON");
+    }
+}
+
+static void HandleStreamToken(json_stream_parser *Parser, json_token_type Type, buffer Value)
+{
+    switch(Type)
+    {
+        case Token_open_brace:
+        case Token_open_bracket:
+        {
+            HandleStreamOpen(Parser, Type, Value);
+        } break;
+
+        case Token_close_brace:
+        case Token_close_bracket:
+        {
+            HandleStreamClose(Parser, Type, Value);
+        } break;
+
+        case Token_comma:
+        {
+            if(Parser->Expect == StreamExpect_CommaOrClose)
+            {
+                Parser->Expect = (Parser->Containers[Parser->Depth - 1] == '{') ? StreamExpect_Label : StreamExpect_Value;
+            }
+            else
+            {
+                StreamError(Parser, Value, "Unexpected token in JSON");
+            }
+        } break;
+
+        case Token_colon:
+        {
+            if(Parser->Expect == StreamExpect_Colon)
+            {
+                Parser->Expect = StreamExpect_Value;
+            }
+            else
+            {
+                StreamError(Parser, Value, "Expected colon after field name");
+            }
+        } break;
+
+        case Token_string_literal:
+        {
+            if((Parser->Expect == StreamExpect_Label) || (Parser->Expect == StreamExpect_LabelOrClose))
+            {
+                Parser->Label = ClassifyStreamLabel(Parser, Value);
+                Parser->Expect = StreamExpect_Colon;
+            }
+            else if((Parser->Expect == StreamExpect_Value) || (Parser->Expect == StreamExpect_ValueOrClose))
+            {
+                EndStreamValue(Parser);
+            }
+            else
+            {
+                StreamError(Parser, Value, "Unexpected token in JSON");
+            }
+        } break;
+
+        case Token_number:
+        case Token_true:
+        case Token_false:
+        case Token_null:
+        {
+            if((Parser->Expect == StreamExpect_Value) || (Parser->Expect == StreamExpect_ValueOrClose))
+            {
+                if((Type == Token_number) && (Parser->Label >= StreamLabel_X0))
+                {
+                    StoreStreamPairField(Parser, Value);
+                }
+                EndStreamValue(Parser);
+            }
+            else
+            {
+                StreamError(Parser, Value, "Unexpected token in JSON");
+            }
+        } break;
+
+        default:
+        {
+            StreamError(Parser, Value, "Unexpected token in JSON");
+        } break;
+    }
+}
+
+static b32 IsJSONNumberChar(u8 Val)
+{
+    b32 Result = (((Val >= '0') && (Val <= '9')) ||
+                  (Val == '-') || (Val == '+') || (Val == '.') || (Val == 'e') || (Val == 'E'));
+    return Result;
+}
+
+static b32 IsJSONKeywordChar(u8 Val)
+{
+    b32 Result = ((Val >= 'a') && (Val <= 'z'));
+    return Result;
+}
+
+static u64 ScanStreamToken(json_stream_parser *Parser, buffer Chunk, u64 At)
+{
+    /* NOTE(casey): Returns the index of the first byte past the current token, or Chunk.Count
+       if the token keeps going into the next chunk. For strings, the returned index is the
+       closing quote. */
+    switch(Parser->TokenState)
+    {
+        case StreamToken_String:
+        {
+            b32 Escaped = Parser->Escaped;
+            while(IsInBounds(Chunk, At))
+            {
+                u8 Val = Chunk.Data[At];
+                if(Escaped)
+                {
+                    Escaped = false;
+                }
+                else if(Val == '\\')
+                {
+                    Escaped = true;
+                }
+                else if(Val == '"')
+                {
+                    break;
+                }
+                ++At;
+            }
+            Parser->Escaped = Escaped;
+        } break;
+
+        case StreamToken_Number:
+        {
+            while(IsInBounds(Chunk, At) && IsJSONNumberChar(Chunk.Data[At]))
+            {
+                ++At;
+            }
+        } break;
+
+        case StreamToken_Keyword:
+        {
+            while(IsInBounds(Chunk, At) && IsJSONKeywordChar(Chunk.Data[At]))
+            {
+                ++At;
+            }
+        } break;
+
+        default:
+        {
+        } break;
+    }
+
+    return At;
+}
+
+static void EndStreamToken(json_stream_parser *Parser, buffer Value)
+{
+    json_token_type Type = Token_error;
+    switch(Parser->TokenState)
+    {
+        case StreamToken_String: {Type = Token_string_literal;} break;
+        case StreamToken_Number: {Type = Token_number;} break;
+
+        case StreamToken_Keyword:
+        {
+            if(AreEqual(Value, CONSTANT_STRING("true"))) {Type = Token_true;}
+            else if(AreEqual(Value, CONSTANT_STRING("false"))) {Type = Token_false;}
+            else if(AreEqual(Value, CONSTANT_STRING("null"))) {Type = Token_null;}
+        } break;
+
+        default:
+        {
+        } break;
+    }
+
+    Parser->TokenState = StreamToken_None;
+    Parser->PartialTokenCount = 0;
+
+    HandleStreamToken(Parser, Type, Value);
+}
+
+static void SavePartialToken(json_stream_parser *Parser, buffer Chunk, u64 Start)
+{
+    u64 Count = Chunk.Count - Start;
+    if((Parser->PartialTokenCount + Count) <= sizeof(Parser->PartialToken))
+    {
+        memcpy(Parser->PartialToken + Parser->PartialTokenCount, Chunk.Data + Start, Count);
+        Parser->PartialTokenCount += (u32)Count;
+    }
+    else
+    {
+        buffer Partial = {Parser->PartialTokenCount, Parser->PartialToken};
+        StreamError(Parser, Partial, "JSON token too long for streaming parser");
+    }
+}
+
+static void PushJSONStream(json_stream_parser *Parser, buffer Chunk)
+{
+    u64 At = 0;
+
+    if(!Parser->HadError && (Parser->TokenState != StreamToken_None))
+    {
+        // NOTE(casey): Finish the token that was cut off at the end of the previous chunk
+        u64 End = ScanStreamToken(Parser, Chunk, 0);
+        SavePartialToken(Parser, {End, Chunk.Data}, 0);
+        if(!Parser->HadError && IsInBounds(Chunk, End))
+        {
+            buffer Value = {Parser->PartialTokenCount, Parser->PartialToken};
+            At = End + (Parser->TokenState == StreamToken_String);
+            EndStreamToken(Parser, Value);
+        }
+        else
+        {
+            At = Chunk.Count;
+        }
+    }
+
+    while(!Parser->HadError && IsInBounds(Chunk, At))
+    {
+        u8 Val = Chunk.Data[At];
+        buffer Single = {1, Chunk.Data + At};
+
+        switch(Val)
+        {
+            case ' ': case '\t': case '\n': case '\r': {++At;} break;
+
+            case '{': {HandleStreamToken(Parser, Token_open_brace, Single); ++At;} break;
+            case '[': {HandleStreamToken(Parser, Token_open_bracket, Single); ++At;} break;
+            case '}': {HandleStreamToken(Parser, Token_close_brace, Single); ++At;} break;
+            case ']': {HandleStreamToken(Parser, Token_close_bracket, Single); ++At;} break;
+            case ',': {HandleStreamToken(Parser, Token_comma, Single); ++At;} break;
+            case ':': {HandleStreamToken(Parser, Token_colon, Single); ++At;} break;
+
+            default:
+            {
+                u64 Start = At;
+                if(Val == '"')
+                {
+                    Parser->TokenState = StreamToken_String;
+                    Parser->Escaped = false;
+                    Start = ++At;
+                }
+                else if((Val == '-') || ((Val >= '0') && (Val <= '9')))
+                {
+                    Parser->TokenState = StreamToken_Number;
+                }
+                else if(IsJSONKeywordChar(Val))
+                {
+                    Parser->TokenState = StreamToken_Keyword;
+                }
+                else
+                {
+                    StreamError(Parser, Single, "Unexpected character in JSON");
+                    break;
+                }
+
+                u64 End = ScanStreamToken(Parser, Chunk, At);
+                if(IsInBounds(Chunk, End))
+                {
+                    buffer Value = {End - Start, Chunk.Data + Start};
+                    At = End + (Parser->TokenState == StreamToken_String);
+                    EndStreamToken(Parser, Value);
+                }
+                else
+                {
+                    SavePartialToken(Parser, Chunk, Start);
+                    At = Chunk.Count;
+                }
+            } break;
+        }
+    }
+}
+
+static b32 EndJSONStream(json_stream_parser *Parser)
+{
+    if(!Parser->HadError)
+    {
+        if((Parser->TokenState == StreamToken_Number) || (Parser->TokenState == StreamToken_Keyword))
+        {
+            // NOTE(casey): A bare number or keyword can only be terminated by the end of the input
+            buffer Value = {Parser->PartialTokenCount, Parser->PartialToken};
+            EndStreamToken(Parser, Value);
+        }
+
+        if((Parser->TokenState != StreamToken_None) || (Parser->Expect != StreamExpect_End))
+        {
+            buffer Nothing = {};
+            StreamError(Parser, Nothing, "JSON ended unexpectedly");
+        }
+    }
+
+    b32 Result = !Parser->HadError;
+    return Result;
+}
+
+inline u64 StreamHaversinePairs(FILE *Source, buffer ChunkBuffer, haversine_pair_callback *Callback, void *CallbackContext)
+{
+    // NOTE(casey): Works on anything fread can read from, including pipes, so the input never has to fit in memory
+    u64 PairCount = 0;
+
+    json_stream_parser Parser = BeginJSONStream(Callback, CallbackContext);
+    while(!Parser.HadError)
+    {
+        u64 ReadCount = fread(ChunkBuffer.Data, 1, ChunkBuffer.Count, Source);
+        if(ReadCount == 0)
+        {
+            break;
+        }
+
+        buffer Chunk = {ReadCount, ChunkBuffer.Data};
+        PushJSONStream(&Parser, Chunk);
+    }
+
+    if(ferror(Source))
+    {
+        fprintf(stderr, "ERROR: Unable to read JSON stream\n");
+    }
+    else if(EndJSONStream(&Parser))
+    {
+        PairCount = Parser.PairCount;
+    }
+
+    return PairCount;
+}
@@ -0,0 +1,219 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 208
+   ======================================================================== */
+
+/* NOTE(casey): _CRT_SECURE_NO_WARNINGS is here because otherwise we cannot
+   call fopen(). If we replace fopen() with fopen_s() to avoid the warning,
+   then the code doesn't compile on Linux anymore, since fopen_s() does not
+   exist there.
+
+   What exactly the CRT maintainers were thinking when they made this choice,
+   I have no idea. */
+#define _CRT_SECURE_NO_WARNINGS
+
+#define __STDC_WANT_LIB_EXT1__ 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef int32_t b32;
+
+typedef float f32;
+typedef double f64;
+
+#define ArrayCount(Array) (sizeof(Array)/sizeof((Array)[0]))
+
+#include "listing_0125_buffer.cpp"
+#include "listing_0169_os_platform.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+#include "listing_0172_reference_haversine.cpp"
+#include "listing_0207_streaming_json_parser.cpp"
+
+struct stream_check
+{
+    haversine_pair *Expected;
+    u64 ExpectedCount;
+
+    u64 PairIndex;
+    u64 MismatchCount;
+    f64 Sum;
+};
+
+static void CheckStreamedPair(void *Context, haversine_pair Pair)
+{
+    // NOTE(casey): Nothing is stored - each pair is compared and summed as soon as it is parsed
+    stream_check *Check = (stream_check *)Context;
+
+    if((Check->PairIndex >= Check->ExpectedCount) ||
+       (memcmp(&Pair, Check->Expected + Check->PairIndex, sizeof(Pair)) != 0))
+    {
+        ++Check->MismatchCount;
+    }
+    ++Check->PairIndex;
+
+    Check->Sum += ReferenceHaversine(Pair.X0, Pair.Y0, Pair.X1, Pair.Y1, QUESTIONABLE_EARTH_RADIUS);
+}
+
+static u64 StreamFromFile(char *FileName, buffer JSON, buffer ChunkBuffer, stream_check *Check)
+{
+    (void)JSON;
+
+    u64 PairCount = 0;
+
+    FILE *File = fopen(FileName, "rb");
+    if(File)
+    {
+        PairCount = StreamHaversinePairs(File, ChunkBuffer, CheckStreamedPair, Check);
+        fclose(File);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to open \"%s\".\n", FileName);
+    }
+
+    return PairCount;
+}
+
+static u64 StreamFromMemory(char *FileName, buffer JSON, buffer ChunkBuffer, stream_check *Check)
+{
+    // NOTE(casey): Same chunking as StreamFromFile, but without fread, so only the parser is being timed
+    (void)FileName;
+
+    u64 PairCount = 0;
+
+    json_stream_parser Parser = BeginJSONStream(CheckStreamedPair, Check);
+    for(u64 At = 0; At < JSON.Count; At += ChunkBuffer.Count)
+    {
+        buffer Chunk = {ChunkBuffer.Count, JSON.Data + At};
+        if(Chunk.Count > (JSON.Count - At))
+        {
+            Chunk.Count = JSON.Count - At;
+        }
+        PushJSONStream(&Parser, Chunk);
+    }
+
+    if(EndJSONStream(&Parser))
+    {
+        PairCount = Parser.PairCount;
+    }
+
+    return PairCount;
+}
+
+typedef u64 stream_func(char *FileName, buffer JSON, buffer ChunkBuffer, stream_check *Check);
+
+struct test_function
+{
+    char const *Name;
+    stream_func *Func;
+};
+static test_function TestFunctions[] =
+{
+    {"StreamFromFile", StreamFromFile},
+    {"StreamFromMemory", StreamFromMemory},
+};
+
+int main(int ArgCount, char **Args)
+{
+    InitializeOSPlatform();
+
+    if(ArgCount == 3)
+    {
+        char *JSONFileName = Args[1];
+
+        u64 MaxChunkSize = 1024*1024;
+        haversine_setup Setup = SetUpHaversine(Args[1], Args[2]);
+        buffer ChunkBuffer = AllocateBuffer(MaxChunkSize);
+        repetition_test_series TestSeries = AllocateTestSeries(ArrayCount(TestFunctions), 64);
+        if(IsValid(Setup) && IsValid(ChunkBuffer) && IsValid(TestSeries))
+        {
+            u64 FileSize = Setup.JSONBuffer.Count;
+
+            SetRowLabelLabel(&TestSeries, "ChunkSize");
+            for(u64 ChunkSize = 1; ChunkSize <= MaxChunkSize; ChunkSize *= 16)
+            {
+                SetRowLabel(&TestSeries, "%llu", ChunkSize);
+                for(u32 TestFunctionIndex = 0; TestFunctionIndex < ArrayCount(TestFunctions); ++TestFunctionIndex)
+                {
+                    test_function Function = TestFunctions[TestFunctionIndex];
+
+                    SetColumnLabel(&TestSeries, "%s", Function.Name);
+
+                    repetition_tester Tester = {};
+                    NewTestWave(&TestSeries, &Tester, FileSize, GetCPUTimerFreq());
+
+                    b32 Passed = true;
+                    while(IsTesting(&TestSeries, &Tester))
+                    {
+                        stream_check Check = {};
+                        Check.Expected = Setup.Pairs;
+                        Check.ExpectedCount = Setup.PairCount;
+
+                        buffer Chunk = {ChunkSize, ChunkBuffer.Data};
+
+                        BeginTime(&Tester);
+                        u64 PairCount = Function.Func(JSONFileName, Setup.JSONBuffer, Chunk, &Check);
+                        CountBytes(&Tester, FileSize);
+                        EndTime(&Tester);
+
+                        f64 Average = PairCount ? (Check.Sum / (f64)PairCount) : 0.0;
+                        if((PairCount != Setup.PairCount) || Check.MismatchCount ||
+                           !ApproxAreEqual(Average, Setup.SumAnswer))
+                        {
+                            Passed = false;
+                        }
+                    }
+
+                    if(!Passed)
+                    {
+                        fprintf(stderr, "WARNING: Streamed pairs do not match SetUpHaversine\n");
+                    }
+                }
+            }
+
+            PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Test data size must be non-zero\n");
+        }
+
+        FreeHaversine(&Setup);
+        FreeBuffer(&ChunkBuffer);
+        FreeTestSeries(&TestSeries);
+    }
+    else
+    {
+        fprintf(stderr, "Usage: %s [haversine JSON file] [haversine answer file]\n", Args[0]);
+    }
+
+    (void)&ReferenceSumHaversine;
+    (void)&ReferenceVerifyHaversine;
+
+    return 0;
+}
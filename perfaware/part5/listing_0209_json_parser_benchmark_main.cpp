@@ -0,0 +1,490 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 209
+   ======================================================================== */
+
+/* NOTE(casey): _CRT_SECURE_NO_WARNINGS is here because otherwise we cannot
+   call fopen(). If we replace fopen() with fopen_s() to avoid the warning,
+   then the code doesn't compile on Linux anymore, since fopen_s() does not
+   exist there.
+
+   What exactly the CRT maintainers were thinking when they made this choice,
+   I have no idea. */
+#define _CRT_SECURE_NO_WARNINGS
+
+#define __STDC_WANT_LIB_EXT1__ 1
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef int32_t b32;
+
+typedef float f32;
+typedef double f64;
+
+#define U64Max UINT64_MAX
+
+#define ArrayCount(Array) (sizeof(Array)/sizeof((Array)[0]))
+
+struct haversine_pair
+{
+    f64 X0, Y0;
+    f64 X1, Y1;
+};
+
+#include "listing_0125_buffer.cpp"
+#include "listing_0169_os_platform.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+
+/* NOTE(casey): The profiled parser variants expect TimeBlock/TimeFunction from one of the
+   part 2 profilers, but those pull in their own copy of the platform metrics, which collides
+   with the platform layer the repetition tester needs. So this is the anchor profiler from
+   listing 91 with nothing else attached. Build with PROFILER=0 to compare the parsers with
+   all instrumentation compiled out. */
+#ifndef PROFILER
+#define PROFILER 1
+#endif
+
+#if PROFILER
+
+struct profile_anchor
+{
+    u64 TSCElapsedExclusive; // NOTE(casey): Does NOT include children
+    u64 TSCElapsedInclusive; // NOTE(casey): DOES include children
+    u64 HitCount;
+    char const *Label;
+};
+static profile_anchor GlobalProfilerAnchors[4096];
+static u32 GlobalProfilerParent;
+
+struct profile_block
+{
+    profile_block(char const *Label_, u32 AnchorIndex_)
+    {
+        ParentIndex = GlobalProfilerParent;
+
+        AnchorIndex = AnchorIndex_;
+        Label = Label_;
+
+        profile_anchor *Anchor = GlobalProfilerAnchors + AnchorIndex;
+        OldTSCElapsedInclusive = Anchor->TSCElapsedInclusive;
+
+        GlobalProfilerParent = AnchorIndex;
+        StartTSC = ReadCPUTimer();
+    }
+
+    ~profile_block(void)
+    {
+        u64 Elapsed = ReadCPUTimer() - StartTSC;
+        GlobalProfilerParent = ParentIndex;
+
+        profile_anchor *Parent = GlobalProfilerAnchors + ParentIndex;
+        profile_anchor *Anchor = GlobalProfilerAnchors + AnchorIndex;
+
+        Parent->TSCElapsedExclusive -= Elapsed;
+        Anchor->TSCElapsedExclusive += Elapsed;
+        Anchor->TSCElapsedInclusive = OldTSCElapsedInclusive + Elapsed;
+        ++Anchor->HitCount;
+
+        Anchor->Label = Label;
+    }
+
+    char const *Label;
+    u64 OldTSCElapsedInclusive;
+    u64 StartTSC;
+    u32 ParentIndex;
+    u32 AnchorIndex;
+};
+
+#define NameConcat2(A, B) A##B
+#define NameConcat(A, B) NameConcat2(A, B)
+#define TimeBlock(Name) profile_block NameConcat(Block, __LINE__)(Name, __COUNTER__ + 1);
+
+#else
+
+#define TimeBlock(...)
+
+#endif
+
+#define TimeFunction TimeBlock(__func__)
+
+/* NOTE(casey): Every parser variant calls malloc/calloc directly, so counting allocations
+   is just a matter of redirecting those names while the parsers are being compiled. */
+static u64 GlobalAllocationCount;
+
+inline void *CountedMalloc(size_t Size)
+{
+    ++GlobalAllocationCount;
+    return malloc(Size);
+}
+
+inline void *CountedCalloc(size_t Count, size_t Size)
+{
+    ++GlobalAllocationCount;
+    return calloc(Count, Size);
+}
+
+#define malloc(Size) CountedMalloc(Size)
+#define calloc(Count, Size) CountedCalloc(Count, Size)
+
+/* NOTE(casey): Each variant is a copy of the same parser, so they each get their own namespace.
+   Even the baseline needs one, because otherwise argument-dependent lookup on buffer would
+   find its functions from inside every other namespace too. */
+namespace parser_0069 {
+#include "listing_0069_lookup_json_parser.cpp"
+}
+namespace parser_0077 {
+#include "listing_0077_profiled_lookup_json_parser.cpp"
+}
+namespace parser_0079 {
+#include "listing_0079_timedblock_lookup_json_parser.cpp"
+}
+namespace parser_0083 {
+#include "listing_0083_recursive_timed_lookup_json_parser.cpp"
+}
+namespace parser_0089 {
+#include "listing_0089_allfuncs_lookup_json_parser.cpp"
+}
+namespace parser_0094 {
+#include "listing_0094_profiled_lookup_json_parser.cpp"
+}
+namespace parser_0205 {
+#include "listing_0205_indexed_lookup_json_parser.cpp"
+}
+namespace parser_0207 {
+// NOTE(casey): The streaming parser shares the number conversion from listing 69
+#include "listing_0069_lookup_json_parser.cpp"
+#include "listing_0207_streaming_json_parser.cpp"
+}
+
+#undef malloc
+#undef calloc
+
+struct stream_pair_store
+{
+    u64 MaxPairCount;
+    u64 PairCount;
+    haversine_pair *Pairs;
+};
+
+static void StoreStreamedPair(void *Context, haversine_pair Pair)
+{
+    stream_pair_store *Store = (stream_pair_store *)Context;
+    if(Store->PairCount < Store->MaxPairCount)
+    {
+        Store->Pairs[Store->PairCount++] = Pair;
+    }
+}
+
+static u64 ParseHaversinePairsStreaming(buffer InputJSON, u64 MaxPairCount, haversine_pair *Pairs)
+{
+    stream_pair_store Store = {MaxPairCount, 0, Pairs};
+
+    parser_0207::json_stream_parser Parser = parser_0207::BeginJSONStream(StoreStreamedPair, &Store);
+    parser_0207::PushJSONStream(&Parser, InputJSON);
+
+    u64 Result = parser_0207::EndJSONStream(&Parser) ? Store.PairCount : 0;
+    return Result;
+}
+
+typedef u64 parse_pairs_func(buffer InputJSON, u64 MaxPairCount, haversine_pair *Pairs);
+
+struct test_function
+{
+    char const *Name;
+    parse_pairs_func *Func;
+};
+static test_function TestFunctions[] =
+{
+    {"0069", parser_0069::ParseHaversinePairs},
+    {"0077", parser_0077::ParseHaversinePairs},
+    {"0079", parser_0079::ParseHaversinePairs},
+    {"0083", parser_0083::ParseHaversinePairs},
+    {"0089", parser_0089::ParseHaversinePairs},
+    {"0094", parser_0094::ParseHaversinePairs},
+    {"0205 indexed", parser_0205::ParseHaversinePairs},
+    {"0207 streaming", ParseHaversinePairsStreaming},
+};
+
+//
+// NOTE(casey): In-memory version of the generator from listing 66
+//
+
+struct random_series
+{
+    u64 A, B, C, D;
+};
+
+static u64 RotateLeft(u64 V, int Shift)
+{
+    u64 Result = ((V << Shift) | (V >> (64-Shift)));
+    return Result;
+}
+
+static u64 RandomU64(random_series *Series)
+{
+    u64 A = Series->A;
+    u64 B = Series->B;
+    u64 C = Series->C;
+    u64 D = Series->D;
+
+    u64 E = A - RotateLeft(B, 27);
+
+    A = (B ^ RotateLeft(C, 17));
+    B = (C + D);
+    C = (D + E);
+    D = (E + A);
+
+    Series->A = A;
+    Series->B = B;
+    Series->C = C;
+    Series->D = D;
+
+    return D;
+}
+
+static random_series Seed(u64 Value)
+{
+    random_series Series = {};
+
+    // NOTE(casey): This is the seed pattern for JSF generators, as per the original post
+    Series.A = 0xf1ea5eed;
+    Series.B = Value;
+    Series.C = Value;
+    Series.D = Value;
+
+    u32 Count = 20;
+    while(Count--)
+    {
+        RandomU64(&Series);
+    }
+
+    return Series;
+}
+
+static f64 RandomInRange(random_series *Series, f64 Min, f64 Max)
+{
+    f64 t = (f64)RandomU64(Series) / (f64)U64Max;
+    f64 Result = (1.0 - t)*Min + t*Max;
+
+    return Result;
+}
+
+static f64 RandomDegree(random_series *Series, f64 Center, f64 Radius, f64 MaxAllowed)
+{
+    f64 MinVal = Center - Radius;
+    if(MinVal < -MaxAllowed)
+    {
+        MinVal = -MaxAllowed;
+    }
+
+    f64 MaxVal = Center + Radius;
+    if(MaxVal > MaxAllowed)
+    {
+        MaxVal = MaxAllowed;
+    }
+
+    f64 Result = RandomInRange(Series, MinVal, MaxVal);
+    return Result;
+}
+
+static buffer GenerateHaversineJSON(b32 Cluster, u64 SeedValue, u64 PairCount)
+{
+    // NOTE(casey): Same output as the generator, so the parsers see exactly what they would see from disk
+    u64 MaxPairSize = 128;
+    buffer Result = AllocateBuffer(PairCount*MaxPairSize + 64);
+    if(IsValid(Result))
+    {
+        u64 ClusterCountLeft = Cluster ? 0 : U64Max;
+        f64 MaxAllowedX = 180;
+        f64 MaxAllowedY = 90;
+
+        f64 XCenter = 0;
+        f64 YCenter = 0;
+        f64 XRadius = MaxAllowedX;
+        f64 YRadius = MaxAllowedY;
+
+        random_series Series = Seed(SeedValue);
+        u64 ClusterCountMax = 1 + (PairCount / 64);
+
+        char *At = (char *)Result.Data;
+        At += sprintf(At, "{\"pairs\":[\n");
+        for(u64 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+        {
+            if(ClusterCountLeft-- == 0)
+            {
+                ClusterCountLeft = ClusterCountMax;
+                XCenter = RandomInRange(&Series, -MaxAllowedX, MaxAllowedX);
+                YCenter = RandomInRange(&Series, -MaxAllowedY, MaxAllowedY);
+                XRadius = RandomInRange(&Series, 0, MaxAllowedX);
+                YRadius = RandomInRange(&Series, 0, MaxAllowedY);
+            }
+
+            f64 X0 = RandomDegree(&Series, XCenter, XRadius, MaxAllowedX);
+            f64 Y0 = RandomDegree(&Series, YCenter, YRadius, MaxAllowedY);
+            f64 X1 = RandomDegree(&Series, XCenter, XRadius, MaxAllowedX);
+            f64 Y1 = RandomDegree(&Series, YCenter, YRadius, MaxAllowedY);
+
+            char const *JSONSep = (PairIndex == (PairCount - 1)) ? "\n" : ",\n";
+            At += sprintf(At, "    {\"x0\":%.16f, \"y0\":%.16f, \"x1\":%.16f, \"y1\":%.16f}%s", X0, Y0, X1, Y1, JSONSep);
+        }
+        At += sprintf(At, "]}\n");
+
+        Result.Count = (u64)(At - (char *)Result.Data);
+    }
+
+    return Result;
+}
+
+static void PrintCSVForAllocations(repetition_test_series *Series, f64 *AllocationsPerMB, FILE *Dest)
+{
+    // NOTE(casey): Same layout as PrintCSVForValue - the tester doesn't track allocations, so they are recorded separately
+    fprintf(Dest, "%s", Series->RowLabelLabel.Chars);
+    for(u32 ColumnIndex = 0; ColumnIndex < Series->ColumnCount; ++ColumnIndex)
+    {
+        fprintf(Dest, ",%s", Series->ColumnLabels[ColumnIndex].Chars);
+    }
+    fprintf(Dest, "\n");
+
+    for(u32 RowIndex = 0; RowIndex < Series->RowIndex; ++RowIndex)
+    {
+        fprintf(Dest, "%s", Series->RowLabels[RowIndex].Chars);
+        for(u32 ColumnIndex = 0; ColumnIndex < Series->ColumnCount; ++ColumnIndex)
+        {
+            fprintf(Dest, ",%f", AllocationsPerMB[RowIndex*Series->ColumnCount + ColumnIndex]);
+        }
+        fprintf(Dest, "\n");
+    }
+}
+
+int main(void)
+{
+    InitializeOSPlatform();
+
+    u64 PairCounts[] = {1000, 64*1000, 1000*1000};
+    char const *DistributionNames[] = {"uniform", "cluster"};
+
+    u32 MaxRowCount = ArrayCount(PairCounts)*ArrayCount(DistributionNames);
+    u64 MaxPairCount = PairCounts[ArrayCount(PairCounts) - 1];
+
+    buffer ReferenceBuffer = AllocateBuffer(MaxPairCount*sizeof(haversine_pair));
+    buffer TestBuffer = AllocateBuffer(MaxPairCount*sizeof(haversine_pair));
+    buffer AllocationBuffer = AllocateBuffer(MaxRowCount*ArrayCount(TestFunctions)*sizeof(f64));
+    repetition_test_series TestSeries = AllocateTestSeries(ArrayCount(TestFunctions), MaxRowCount);
+    if(IsValid(ReferenceBuffer) && IsValid(TestBuffer) && IsValid(AllocationBuffer) && IsValid(TestSeries))
+    {
+        haversine_pair *ReferencePairs = (haversine_pair *)ReferenceBuffer.Data;
+        haversine_pair *TestPairs = (haversine_pair *)TestBuffer.Data;
+        f64 *AllocationsPerMB = (f64 *)AllocationBuffer.Data;
+
+        SetRowLabelLabel(&TestSeries, "Input");
+        for(u32 DistributionIndex = 0; DistributionIndex < ArrayCount(DistributionNames); ++DistributionIndex)
+        {
+            for(u32 SizeIndex = 0; SizeIndex < ArrayCount(PairCounts); ++SizeIndex)
+            {
+                u64 PairCount = PairCounts[SizeIndex];
+                char const *DistributionName = DistributionNames[DistributionIndex];
+
+                buffer JSON = GenerateHaversineJSON(DistributionIndex == 1, 12345 + SizeIndex, PairCount);
+                u64 ReferenceCount = parser_0069::ParseHaversinePairs(JSON, PairCount, ReferencePairs);
+                if(IsValid(JSON) && (ReferenceCount == PairCount))
+                {
+                    u32 RowIndex = TestSeries.RowIndex;
+                    SetRowLabel(&TestSeries, "%s %llu", DistributionName, PairCount);
+                    for(u32 TestFunctionIndex = 0; TestFunctionIndex < ArrayCount(TestFunctions); ++TestFunctionIndex)
+                    {
+                        test_function Function = TestFunctions[TestFunctionIndex];
+
+                        SetColumnLabel(&TestSeries, "%s", Function.Name);
+
+                        repetition_tester Tester = {};
+                        NewTestWave(&TestSeries, &Tester, JSON.Count, GetCPUTimerFreq());
+
+                        b32 Passed = true;
+                        u64 AllocationCount = 0;
+                        while(IsTesting(&TestSeries, &Tester))
+                        {
+                            memset(TestPairs, 0, PairCount*sizeof(haversine_pair));
+                            u64 StartAllocationCount = GlobalAllocationCount;
+
+                            BeginTime(&Tester);
+                            u64 TestCount = Function.Func(JSON, PairCount, TestPairs);
+                            CountBytes(&Tester, JSON.Count);
+                            EndTime(&Tester);
+
+                            AllocationCount = GlobalAllocationCount - StartAllocationCount;
+
+                            if((TestCount != PairCount) ||
+                               (memcmp(TestPairs, ReferencePairs, PairCount*sizeof(haversine_pair)) != 0))
+                            {
+                                Passed = false;
+                            }
+                        }
+
+                        f64 Megabytes = (f64)JSON.Count / (1024.0*1024.0);
+                        AllocationsPerMB[RowIndex*TestSeries.ColumnCount + TestFunctionIndex] = (f64)AllocationCount / Megabytes;
+
+                        if(!Passed)
+                        {
+                            fprintf(stderr, "WARNING: %s pairs do not match listing 69\n", Function.Name);
+                        }
+                    }
+                }
+                else
+                {
+                    fprintf(stderr, "ERROR: Unable to generate %s input with %llu pairs\n", DistributionName, PairCount);
+                }
+
+                FreeBuffer(&JSON);
+            }
+        }
+
+        fprintf(stdout, "\nGB/s:\n");
+        PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout);
+
+        // NOTE(casey): Page faults are from the fastest run, which has usually recycled the previous run's memory
+        fprintf(stdout, "\nPage faults:\n");
+        PrintCSVForValue(&TestSeries, RepValue_MemPageFaults, stdout);
+
+        fprintf(stdout, "\nAllocations per MB:\n");
+        PrintCSVForAllocations(&TestSeries, AllocationsPerMB, stdout);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate test memory\n");
+    }
+
+    FreeBuffer(&ReferenceBuffer);
+    FreeBuffer(&TestBuffer);
+    FreeBuffer(&AllocationBuffer);
+    FreeTestSeries(&TestSeries);
+
+    // NOTE(casey): Parser 207 streams the file itself, so its whole-buffer ParseHaversinePairs isn't benchmarked here
+    (void)&parser_0207::ParseHaversinePairs;
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 212
+   ======================================================================== */
+
+/* NOTE(casey): This produces exactly what printf("%.16f") produces, but only for the one
+   precision the generator uses, so it can skip nearly everything printf has to do.
+
+   A double is M*2^E for a 53-bit integer M. Multiplying by 10^16 gives M*10^16*2^E, and
+   M*10^16 fits in 107 bits, so one 64x64->128 multiply computes it exactly. Shifting right
+   by -E then gives the 16-digit fixed-point result, and the bits shifted out say exactly how
+   to round it. Ties go to even, which is what the C runtime does in the default rounding
+   mode. Anything too large to fit the result in 64 bits (or not finite) goes to snprintf. */
+
+#define FIXED16_SCALE 10000000000000000ULL // NOTE(casey): 10^16
+#define FIXED16_MAX_FAST_VALUE 1000.0
+#define FIXED16_MAX_TEXT 336 // NOTE(casey): Enough for "%.16f" of any double, including the snprintf path
+
+inline u64 MultiplyU64(u64 A, u64 B, u64 *High)
+{
+#if _MSC_VER
+    u64 Result = _umul128(A, B, High);
+#else
+    unsigned __int128 Product = (unsigned __int128)A*B;
+    *High = (u64)(Product >> 64);
+    u64 Result = (u64)Product;
+#endif
+    return Result;
+}
+
+static u64 ScaleRoundF64(u64 Mantissa, u32 Shift)
+{
+    // NOTE(casey): Returns round(Mantissa*10^16 / 2^Shift), rounding ties to even
+    u64 Result = 0;
+
+    if(Shift < 108)
+    {
+        u64 High;
+        u64 Low = MultiplyU64(Mantissa, FIXED16_SCALE, &High);
+
+        // NOTE(casey): Compare the shifted-out bits against exactly one half
+        b32 AboveHalf = false;
+        b32 AtHalf = false;
+        if(Shift == 0)
+        {
+            Result = Low;
+        }
+        else if(Shift < 64)
+        {
+            Result = (High << (64 - Shift)) | (Low >> Shift);
+            u64 Remainder = Low & ((1ULL << Shift) - 1);
+            u64 Half = 1ULL << (Shift - 1);
+            AboveHalf = (Remainder > Half);
+            AtHalf = (Remainder == Half);
+        }
+        else if(Shift == 64)
+        {
+            Result = High;
+            AboveHalf = (Low > (1ULL << 63));
+            AtHalf = (Low == (1ULL << 63));
+        }
+        else
+        {
+            u32 HighShift = Shift - 64;
+            Result = High >> HighShift;
+            u64 RemainderHigh = High & ((1ULL << HighShift) - 1);
+            u64 HalfHigh = 1ULL << (HighShift - 1);
+            AboveHalf = ((RemainderHigh > HalfHigh) || ((RemainderHigh == HalfHigh) && (Low != 0)));
+            AtHalf = ((RemainderHigh == HalfHigh) && (Low == 0));
+        }
+
+        if(AboveHalf || (AtHalf && (Result & 1)))
+        {
+            ++Result;
+        }
+    }
+
+    return Result;
+}
+
+inline char *WriteDigits8(char *Dest, u64 Value)
+{
+    // NOTE(casey): Exactly 8 digits, zero-padded
+    for(u32 Index = 8; Index--;)
+    {
+        Dest[Index] = (char)('0' + (Value % 10));
+        Value /= 10;
+    }
+
+    return Dest + 8;
+}
+
+inline u32 FormatF64Fixed16(char *Dest, f64 Value)
+{
+    // NOTE(casey): Dest must have room for FIXED16_MAX_TEXT characters. Returns the length, without a terminator.
+    u32 Result = 0;
+
+    u64 Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+
+    b32 Negative = (b32)(Bits >> 63);
+    u32 BiasedExponent = (u32)((Bits >> 52) & 0x7ff);
+    u64 Fraction = Bits & ((1ULL << 52) - 1);
+
+    f64 Magnitude = Negative ? -Value : Value;
+    if((BiasedExponent != 0x7ff) && (Magnitude < FIXED16_MAX_FAST_VALUE))
+    {
+        // NOTE(casey): Denormals have no implicit leading bit and use the minimum exponent
+        u64 Mantissa = BiasedExponent ? (Fraction | (1ULL << 52)) : Fraction;
+        u32 Shift = BiasedExponent ? (1075 - BiasedExponent) : 1074;
+
+        u64 Scaled = ScaleRoundF64(Mantissa, Shift);
+        u64 Whole = Scaled / FIXED16_SCALE;
+        u64 Fractional = Scaled % FIXED16_SCALE;
+
+        char *At = Dest;
+        if(Negative)
+        {
+            *At++ = '-';
+        }
+
+        // NOTE(casey): Whole is always less than 1000 here
+        if(Whole >= 100) {*At++ = (char)('0' + Whole / 100);}
+        if(Whole >= 10) {*At++ = (char)('0' + (Whole / 10) % 10);}
+        *At++ = (char)('0' + Whole % 10);
+
+        *At++ = '.';
+        At = WriteDigits8(At, Fractional / 100000000);
+        At = WriteDigits8(At, Fractional % 100000000);
+
+        Result = (u32)(At - Dest);
+    }
+    else
+    {
+        int Count = snprintf(Dest, FIXED16_MAX_TEXT, "%.16f", Value);
+        Result = (Count > 0) ? (u32)Count : 0;
+        if(Result >= FIXED16_MAX_TEXT)
+        {
+            Result = FIXED16_MAX_TEXT - 1;
+        }
+    }
+
+    return Result;
+}
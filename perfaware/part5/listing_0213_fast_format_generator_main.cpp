@@ -0,0 +1,473 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+   
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+   
+   Please see https://computerenhance.com for more information
+   
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 213
+   ======================================================================== */
+
+/* NOTE(casey): _CRT_SECURE_NO_WARNINGS is here because otherwise we cannot
+   call fopen(). If we replace fopen() with fopen_s() to avoid the warning,
+   then the code doesn't compile on Linux anymore, since fopen_s() does not
+   exist there.
+   
+   What exactly the CRT maintainers were thinking when they made this choice,
+   I have no idea. */
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include <string.h>
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+typedef uint8_t u8;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int32_t b32;
+typedef double f64;
+#define U64Max UINT64_MAX
+
+#include "listing_0125_buffer.cpp"
+#include "listing_0210_os_platform.cpp"
+#include "listing_0065_haversine_formula.cpp"
+#include "listing_0201_haversine_binary_format.cpp"
+#include "listing_0212_fixed_f64_format.cpp"
+
+/* NOTE(casey): The pairs are generated in fixed-size chunks. Each chunk gets its own random
+   series, seeded from the base seed and the chunk index, so the contents of a chunk do not
+   depend on which thread made it or how many threads there are. Clusters are seeded the same
+   way from their cluster index, so a chunk that starts halfway through a cluster can still
+   recreate it. The output is therefore identical for a given seed regardless of thread count,
+   but it is NOT the same output that listing 66 produces for that seed. */
+#define GENERATOR_CHUNK_PAIR_COUNT (16*1024)
+#define GENERATOR_MAX_PAIR_TEXT 128
+#define GENERATOR_MAX_THREAD_COUNT 256
+
+struct random_series
+{
+    u64 A, B, C, D;
+};
+
+static u64 RotateLeft(u64 V, int Shift)
+{
+    u64 Result = ((V << Shift) | (V >> (64-Shift)));
+    return Result;
+}
+
+static u64 RandomU64(random_series *Series)
+{
+    u64 A = Series->A;
+    u64 B = Series->B;
+    u64 C = Series->C;
+    u64 D = Series->D;
+    
+    u64 E = A - RotateLeft(B, 27);
+    
+    A = (B ^ RotateLeft(C, 17));
+    B = (C + D);
+    C = (D + E);
+    D = (E + A);
+    
+    Series->A = A;
+    Series->B = B;
+    Series->C = C;
+    Series->D = D;
+    
+    return D;
+}
+
+static random_series SeedStream(u64 Value, u64 StreamIndex)
+{
+    random_series Series = {};
+    
+    // NOTE(casey): This is the seed pattern for JSF generators, with the stream index mixed into two of the words
+    Series.A = 0xf1ea5eed;
+    Series.B = Value;
+    Series.C = Value ^ (StreamIndex*0x9e3779b97f4a7c15ULL);
+    Series.D = Value + StreamIndex;
+    
+    u32 Count = 20;
+    while(Count--)
+    {
+        RandomU64(&Series);
+    }
+    
+    return Series;
+}
+
+static f64 RandomInRange(random_series *Series, f64 Min, f64 Max)
+{
+    f64 t = (f64)RandomU64(Series) / (f64)U64Max;
+    f64 Result = (1.0 - t)*Min + t*Max;
+    
+    return Result;
+}
+
+static FILE *Open(long long unsigned PairCount, char const *Label, char const *Extension)
+{
+    char Temp[256];
+    sprintf(Temp, "data_%llu_%s.%s", PairCount, Label, Extension);
+    FILE *Result = fopen(Temp, "wb");
+    if(!Result)
+    {
+        fprintf(stderr, "Unable to open \"%s\" for writing.\n", Temp);
+    }
+    
+    return Result;
+}
+
+static f64 RandomDegree(random_series *Series, f64 Center, f64 Radius, f64 MaxAllowed)
+{
+    f64 MinVal = Center - Radius;
+    if(MinVal < -MaxAllowed)
+    {
+        MinVal = -MaxAllowed;
+    }
+    
+    f64 MaxVal = Center + Radius;
+    if(MaxVal > MaxAllowed)
+    {
+        MaxVal = MaxAllowed;
+    }
+    
+    f64 Result = RandomInRange(Series, MinVal, MaxVal);
+    return Result;
+}
+
+inline char *WriteConstant(char *Dest, char const *String, u64 Length)
+{
+    memcpy(Dest, String, Length);
+    return Dest + Length;
+}
+#define WriteLiteral(Dest, String) WriteConstant(Dest, String, sizeof(String) - 1)
+
+static char *WritePairJSON(char *At, f64 X0, f64 Y0, f64 X1, f64 Y1, b32 IsLast)
+{
+    // NOTE(casey): Byte-for-byte the same line listing 66 writes with fprintf
+    At = WriteLiteral(At, "    {\"x0\":");
+    At += FormatF64Fixed16(At, X0);
+    At = WriteLiteral(At, ", \"y0\":");
+    At += FormatF64Fixed16(At, Y0);
+    At = WriteLiteral(At, ", \"x1\":");
+    At += FormatF64Fixed16(At, X1);
+    At = WriteLiteral(At, ", \"y1\":");
+    At += FormatF64Fixed16(At, Y1);
+    At = IsLast ? WriteLiteral(At, "}\n") : WriteLiteral(At, "},\n");
+    
+    return At;
+}
+
+struct generator_cluster
+{
+    f64 XCenter, YCenter;
+    f64 XRadius, YRadius;
+};
+
+struct generator_chunk_slot
+{
+    u64 volatile ReadyChunkIndex; // NOTE(casey): Chunk index + 1, once the chunk has been generated into this slot
+    
+    u64 PairCount;
+    u64 TextSize;
+    buffer Text;
+    f64 *Answers;
+    f64 *Values; // NOTE(casey): X0, Y0, X1, Y1 for each pair, for the binary file
+};
+
+struct generator_state
+{
+    b32 Cluster;
+    u64 SeedValue;
+    u64 PairCount;
+    u64 ChunkCount;
+    u64 ClusterCountMax;
+    
+    u64 volatile NextChunkIndex;
+    u64 volatile WrittenChunkCount;
+    
+    u32 SlotCount;
+    generator_chunk_slot *Slots;
+};
+
+static f64 const MaxAllowedX = 180;
+static f64 const MaxAllowedY = 90;
+
+static generator_cluster GetCluster(u64 SeedValue, u64 ClusterIndex)
+{
+    // NOTE(casey): Odd streams are clusters, even streams are chunks, so they never share a series
+    random_series Series = SeedStream(SeedValue, 2*ClusterIndex + 1);
+    
+    generator_cluster Result = {};
+    Result.XCenter = RandomInRange(&Series, -MaxAllowedX, MaxAllowedX);
+    Result.YCenter = RandomInRange(&Series, -MaxAllowedY, MaxAllowedY);
+    Result.XRadius = RandomInRange(&Series, 0, MaxAllowedX);
+    Result.YRadius = RandomInRange(&Series, 0, MaxAllowedY);
+    
+    return Result;
+}
+
+static void GenerateChunk(generator_state *State, u64 ChunkIndex, generator_chunk_slot *Slot)
+{
+    u64 FirstPairIndex = ChunkIndex*GENERATOR_CHUNK_PAIR_COUNT;
+    u64 PairCount = State->PairCount - FirstPairIndex;
+    if(PairCount > GENERATOR_CHUNK_PAIR_COUNT)
+    {
+        PairCount = GENERATOR_CHUNK_PAIR_COUNT;
+    }
+    
+    random_series Series = SeedStream(State->SeedValue, 2*ChunkIndex);
+    
+    generator_cluster Cluster = {0, 0, MaxAllowedX, MaxAllowedY};
+    u64 ClusterIndex = U64Max;
+    
+    char *Text = (char *)Slot->Text.Data;
+    for(u64 Index = 0; Index < PairCount; ++Index)
+    {
+        u64 PairIndex = FirstPairIndex + Index;
+        if(State->Cluster)
+        {
+            // NOTE(casey): Same cluster boundaries as listing 66 - a new cluster every ClusterCountMax + 1 pairs
+            u64 PairClusterIndex = PairIndex / (State->ClusterCountMax + 1);
+            if(ClusterIndex != PairClusterIndex)
+            {
+                ClusterIndex = PairClusterIndex;
+                Cluster = GetCluster(State->SeedValue, ClusterIndex);
+            }
+        }
+        
+        f64 X0 = RandomDegree(&Series, Cluster.XCenter, Cluster.XRadius, MaxAllowedX);
+        f64 Y0 = RandomDegree(&Series, Cluster.YCenter, Cluster.YRadius, MaxAllowedY);
+        f64 X1 = RandomDegree(&Series, Cluster.XCenter, Cluster.XRadius, MaxAllowedX);
+        f64 Y1 = RandomDegree(&Series, Cluster.YCenter, Cluster.YRadius, MaxAllowedY);
+        
+        f64 EarthRadius = 6372.8;
+        Slot->Answers[Index] = ReferenceHaversine(X0, Y0, X1, Y1, EarthRadius);
+        
+        f64 *Values = Slot->Values + 4*Index;
+        Values[0] = X0;
+        Values[1] = Y0;
+        Values[2] = X1;
+        Values[3] = Y1;
+        
+        Text = WritePairJSON(Text, X0, Y0, X1, Y1, PairIndex == (State->PairCount - 1));
+    }
+    
+    Slot->PairCount = PairCount;
+    Slot->TextSize = (u64)(Text - (char *)Slot->Text.Data);
+}
+
+THREAD_ENTRY_POINT(GeneratorThread, Parameter)
+{
+    generator_state *State = (generator_state *)Parameter;
+    
+    for(;;)
+    {
+        u64 ChunkIndex = AtomicAddU64(&State->NextChunkIndex, 1);
+        if(ChunkIndex >= State->ChunkCount)
+        {
+            break;
+        }
+        
+        // NOTE(casey): Don't get more than SlotCount chunks ahead of the writer
+        while(ChunkIndex >= (State->WrittenChunkCount + State->SlotCount)) {_mm_pause();}
+        
+        EXCESSIVE_FENCE;
+        
+        generator_chunk_slot *Slot = State->Slots + (ChunkIndex % State->SlotCount);
+        GenerateChunk(State, ChunkIndex, Slot);
+        
+        EXCESSIVE_FENCE;
+        
+        Slot->ReadyChunkIndex = ChunkIndex + 1;
+    }
+    
+    return 0;
+}
+
+int main(int ArgCount, char **Args)
+{
+    InitializeOSPlatform();
+    
+    if((ArgCount == 4) || (ArgCount == 5))
+    {
+        b32 Cluster = false;
+        
+        char const *MethodName = Args[1];
+        if(strcmp(MethodName, "cluster") == 0)
+        {
+            Cluster = true;
+        }
+        else if(strcmp(MethodName, "uniform") != 0)
+        {
+            MethodName = "uniform";
+            fprintf(stderr, "WARNING: Unrecognized method name. Using 'uniform'.\n");
+        }
+        
+        u64 SeedValue = atoll(Args[2]);
+        
+        u32 ThreadCount = (ArgCount == 5) ? (u32)atoi(Args[4]) : GetCPUCoreCount();
+        if(ThreadCount < 1)
+        {
+            ThreadCount = 1;
+        }
+        if(ThreadCount > GENERATOR_MAX_THREAD_COUNT)
+        {
+            ThreadCount = GENERATOR_MAX_THREAD_COUNT;
+        }
+        
+        u64 MaxPairCount = (1ULL << 34);
+        u64 PairCount = atoll(Args[3]);
+        if(PairCount < MaxPairCount)
+        {
+            generator_state State = {};
+            State.Cluster = Cluster;
+            State.SeedValue = SeedValue;
+            State.PairCount = PairCount;
+            State.ChunkCount = (PairCount + GENERATOR_CHUNK_PAIR_COUNT - 1) / GENERATOR_CHUNK_PAIR_COUNT;
+            State.ClusterCountMax = 1 + (PairCount / 64);
+            
+            // NOTE(casey): Two slots per thread, so a thread can generate its next chunk while the writer is still busy with its last one
+            State.SlotCount = 2*ThreadCount;
+            State.Slots = (generator_chunk_slot *)calloc(State.SlotCount, sizeof(generator_chunk_slot));
+            
+            b32 SlotsValid = (State.Slots != 0);
+            for(u32 SlotIndex = 0; SlotsValid && (SlotIndex < State.SlotCount); ++SlotIndex)
+            {
+                generator_chunk_slot *Slot = State.Slots + SlotIndex;
+                Slot->Text = AllocateBuffer(GENERATOR_CHUNK_PAIR_COUNT*GENERATOR_MAX_PAIR_TEXT);
+                Slot->Answers = (f64 *)malloc(GENERATOR_CHUNK_PAIR_COUNT*sizeof(f64));
+                Slot->Values = (f64 *)malloc(4*GENERATOR_CHUNK_PAIR_COUNT*sizeof(f64));
+                SlotsValid = (IsValid(Slot->Text) && Slot->Answers && Slot->Values);
+            }
+            
+            FILE *FlexJSON = Open(PairCount, "flex", "json");
+            FILE *HaverAnswers = Open(PairCount, "haveranswer", "f64");
+            FILE *BinaryPairs = Open(PairCount, "pairs", "bin");
+            haversine_binary_writer *Writer = (haversine_binary_writer *)malloc(sizeof(haversine_binary_writer));
+            if(FlexJSON && HaverAnswers && BinaryPairs && Writer && SlotsValid)
+            {
+                u64 StartTime = ReadCPUTimer();
+                
+                u32 StartedCount = 0;
+                thread_handle Threads[GENERATOR_MAX_THREAD_COUNT] = {};
+                for(u32 ThreadIndex = 0; ThreadIndex < ThreadCount; ++ThreadIndex)
+                {
+                    Threads[ThreadIndex] = CreateAndStartThread(GeneratorThread, &State);
+                    StartedCount += (IsValidThread(Threads[ThreadIndex]) != 0);
+                }
+                
+                // NOTE(casey): Only changes for the single-threaded fallback. State.SlotCount stays the allocated count, so every slot still gets freed
+                u32 ActiveSlotCount = State.SlotCount;
+                if(StartedCount == 0)
+                {
+                    // NOTE(casey): Without any workers the writer would wait forever, so just generate on this thread
+                    fprintf(stderr, "WARNING: Unable to start generator threads. Generating on the main thread.\n");
+                    ActiveSlotCount = 1;
+                }
+                
+                BeginHaversineBinary(Writer, BinaryPairs, PairCount);
+                
+                fprintf(FlexJSON, "{\"pairs\":[\n");
+                
+                /* NOTE(casey): The main thread is the writer. It takes the chunks strictly in
+                   order, and accumulates the sum one pair at a time in that same order, so the
+                   expected sum comes out bit-identical no matter how the chunks were scheduled. */
+                f64 Sum = 0;
+                f64 SumCoef = 1.0 / (f64)PairCount;
+                for(u64 ChunkIndex = 0; ChunkIndex < State.ChunkCount; ++ChunkIndex)
+                {
+                    generator_chunk_slot *Slot = State.Slots + (ChunkIndex % ActiveSlotCount);
+                    if(StartedCount == 0)
+                    {
+                        GenerateChunk(&State, ChunkIndex, Slot);
+                        Slot->ReadyChunkIndex = ChunkIndex + 1;
+                    }
+                    while(Slot->ReadyChunkIndex != (ChunkIndex + 1)) {_mm_pause();}
+                    
+                    EXCESSIVE_FENCE;
+                    
+                    fwrite(Slot->Text.Data, Slot->TextSize, 1, FlexJSON);
+                    fwrite(Slot->Answers, sizeof(f64), Slot->PairCount, HaverAnswers);
+                    for(u64 Index = 0; Index < Slot->PairCount; ++Index)
+                    {
+                        Sum += SumCoef*Slot->Answers[Index];
+                        
+                        f64 *Values = Slot->Values + 4*Index;
+                        WriteHaversinePair(Writer, Values[0], Values[1], Values[2], Values[3]);
+                    }
+                    
+                    EXCESSIVE_FENCE;
+                    
+                    State.WrittenChunkCount = ChunkIndex + 1;
+                }
+                
+                fprintf(FlexJSON, "]}\n");
+                fwrite(&Sum, sizeof(Sum), 1, HaverAnswers);
+                
+                if(!EndHaversineBinary(Writer, Sum))
+                {
+                    fprintf(stderr, "ERROR: Unable to write binary pair file.\n");
+                }
+                
+                for(u32 ThreadIndex = 0; ThreadIndex < ThreadCount; ++ThreadIndex)
+                {
+                    if(IsValidThread(Threads[ThreadIndex]))
+                    {
+                        WaitForThread(Threads[ThreadIndex]);
+                    }
+                }
+                
+                f64 Seconds = (f64)(ReadCPUTimer() - StartTime) / (f64)GetCPUTimerFreq();
+                
+                fprintf(stdout, "Method: %s\n", MethodName);
+                fprintf(stdout, "Random seed: %llu\n", SeedValue);
+                fprintf(stdout, "Pair count: %llu\n", PairCount);
+                fprintf(stdout, "Thread count: %u\n", ThreadCount);
+                fprintf(stdout, "Expected sum: %.16f\n", Sum);
+                fprintf(stdout, "Generated in: %.3fs\n", Seconds);
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: Unable to set up the generator.\n");
+            }
+            
+            if(FlexJSON) fclose(FlexJSON);
+            if(HaverAnswers) fclose(HaverAnswers);
+            if(BinaryPairs) fclose(BinaryPairs);
+            if(Writer) free(Writer);
+            
+            for(u32 SlotIndex = 0; State.Slots && (SlotIndex < State.SlotCount); ++SlotIndex)
+            {
+                generator_chunk_slot *Slot = State.Slots + SlotIndex;
+                FreeBuffer(&Slot->Text);
+                free(Slot->Answers);
+                free(Slot->Values);
+            }
+            free(State.Slots);
+        }
+        else
+        {
+            fprintf(stderr, "To avoid accidentally generating massive files, number of pairs must be less than %llu.\n", MaxPairCount);
+        }
+    }
+    else
+    {
+        fprintf(stderr, "Usage: %s [uniform/cluster] [random seed] [number of coordinate pairs to generate] [thread count - optional]\n", Args[0]);
+    }
+    
+    return 0;
+}
@@ -0,0 +1,136 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 214
+   ======================================================================== */
+
+/* NOTE(casey): This is the combined haversine test from listing 194, but built on
+   the columnar setup from listing 203. It accepts either a JSON or a binary pair
+   file, and every test function can use either Setup.Pairs or Setup.Columns,
+   whichever suits it. */
+
+#include "listing_0250_math_prelude.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+#include "listing_0203_columnar_haversine.cpp"
+#include "listing_0188_arcsine_extc.cpp"
+#include "listing_0192_haversine_replacement.cpp"
+
+struct test_function
+{
+    char const *Name;
+    haversine_compute_func *Compute;
+    f64 Tolerance; // NOTE(casey): If this is 0, the sum has to pass ApproxAreEqual instead
+};
+
+static b32 IsWithinTolerance(test_function Function, f64 TestSum, f64 ReferenceSum)
+{
+    b32 Result = Function.Tolerance ? (fabs(TestSum - ReferenceSum) <= Function.Tolerance) : ApproxAreEqual(TestSum, ReferenceSum);
+    return Result;
+}
+
+/* NOTE(casey): A test runner is how something like a thread pool gets between
+   the tester and the function it is testing. With no runner, the function is
+   called directly. */
+typedef f64 haversine_test_runner(void *Context, haversine_compute_func *Compute, haversine_setup Setup);
+
+static void RunHaversineTestRow(repetition_test_series *TestSeries, haversine_setup Setup,
+                                u32 TestFunctionCount, test_function *TestFunctions,
+                                haversine_test_runner *Runner = 0, void *RunnerContext = 0, f64 *Sums = 0)
+{
+    f64 ReferenceSum = Setup.SumAnswer;
+    
+    for(u32 TestFunctionIndex = 0; TestFunctionIndex < TestFunctionCount; ++TestFunctionIndex)
+    {
+        test_function Function = TestFunctions[TestFunctionIndex];
+        
+        SetColumnLabel(TestSeries, "%s", Function.Name);
+        
+        repetition_tester Tester = {};
+        NewTestWave(TestSeries, &Tester, Setup.ParsedByteCount, GetCPUTimerFreq());
+        
+        u64 SumErrorCount = {};
+        f64 TestSum = {};
+        
+        while(IsTesting(TestSeries, &Tester))
+        {
+            BeginTime(&Tester);
+            TestSum = Runner ? Runner(RunnerContext, Function.Compute, Setup) : Function.Compute(Setup);
+            CountBytes(&Tester, Setup.ParsedByteCount);
+            EndTime(&Tester);
+            
+            SumErrorCount += !IsWithinTolerance(Function, TestSum, ReferenceSum);
+        }
+        
+        printf("             ________________                  ________________\n");
+        fprintf(stdout, "Sum: %+32.24f (%+32.24f)\n", TestSum, TestSum - ReferenceSum);
+        fprintf(stdout, "\n");
+        
+        if(SumErrorCount)
+        {
+            fprintf(stderr, "WARNING: %llu sum mismatches\n", SumErrorCount);
+        }
+        
+        if(Sums)
+        {
+            Sums[TestFunctionIndex] = TestSum;
+        }
+    }
+}
+
+static b32 SetUpHaversineTest(int ArgCount, char **Args, haversine_setup *Setup)
+{
+    InitializeOSPlatform();
+    
+    b32 Result = false;
+    if(ArgCount == 3)
+    {
+        *Setup = SetUpHaversine(Args[1], Args[2]);
+        
+        // NOTE(casey): Binary pair files only come with columns, but the older test functions want pairs
+        Result = (IsValid(*Setup) && BuildPairsFromColumns(Setup));
+        if(!Result)
+        {
+            fprintf(stderr, "ERROR: Test data size must be non-zero\n");
+        }
+    }
+    else
+    {
+        fprintf(stderr, "Usage: %s [haversine JSON or binary file] [haversine answer file]\n", Args[0]);
+    }
+    
+    (void)&ReferenceVerifyHaversine;
+    (void)&VerifyHaversineChecksum;
+    
+    return Result;
+}
+
+inline void CombinedHaversineTest(int ArgCount, char **Args, u32 TestFunctionCount, test_function *TestFunctions)
+{
+    haversine_setup Setup = {};
+    if(SetUpHaversineTest(ArgCount, Args, &Setup))
+    {
+        repetition_test_series TestSeries = AllocateTestSeries(TestFunctionCount, 1);
+        if(IsValid(TestSeries))
+        {
+            SetRowLabelLabel(&TestSeries, "Test");
+            SetRowLabel(&TestSeries, "Haversine");
+            RunHaversineTestRow(&TestSeries, Setup, TestFunctionCount, TestFunctions);
+            
+            PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, 1.0);
+        }
+        
+        FreeTestSeries(&TestSeries);
+    }
+    
+    FreeHaversine(&Setup);
+}
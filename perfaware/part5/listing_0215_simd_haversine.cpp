@@ -0,0 +1,390 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 215
+   ======================================================================== */
+
+/* NOTE(casey): These are SimplifiedHaversineI from listing 195, run on four
+   (AVX2) or eight (AVX-512) pairs at once straight out of the haversine columns.
+   Every conditional in the scalar version was already a select, so each one
+   becomes a compare and a blend. Two independent accumulators are used so
+   that consecutive iterations don't serialize on the final add.
+
+   The Sum* functions return the sum of the arcsines - the half central
+   angles - for the pairs they were given. Scaling by 2*EarthRadius/PairCount
+   is left to the caller, so any range of pairs can be summed on its own and
+   the results added together afterwards.
+
+   All-zero pairs contribute exactly zero, so the leftover pairs at the end
+   are loaded with a mask that zero-fills the unused lanes and run through
+   the same code. */
+
+//
+// NOTE(casey): Scalar - the cores the vector versions below were widened from
+//
+
+inline f64 SineCoreWithPrefix(f64 A, f64 B, f64 C)
+{
+    f64 X = fma(A, B, C);
+    f64 X2 = X*X;
+
+    // NOTE(casey): These minimax coefficients were donated by Demetri Spanos
+    f64 R = 0x1.883c1c5deffbep-49;
+    R = fma(R, X2, -0x1.ae43dc9bf8ba7p-41);
+    R = fma(R, X2, 0x1.6123ce513b09fp-33);
+    R = fma(R, X2, -0x1.ae6454d960ac4p-26);
+    R = fma(R, X2, 0x1.71de3a52aab96p-19);
+    R = fma(R, X2, -0x1.a01a01a014eb6p-13);
+    R = fma(R, X2, 0x1.11111111110c9p-7);
+    R = fma(R, X2, -0x1.5555555555555p-3);
+    R = fma(R, X2, 0x1p0);
+    R *= X;
+
+    return R;
+}
+
+inline f64 ArcsineCoreFromSquared(f64 X2)
+{
+    f64 X = SqrtCE(X2);
+
+    // NOTE(casey): These minimax coefficients were donated by Demetri Spanos
+    f64 R = 0x1.dfc53682725cap-1;
+    R = fma(R, X2, -0x1.bec6daf74ed61p1);
+    R = fma(R, X2, 0x1.8bf4dadaf548cp2);
+    R = fma(R, X2, -0x1.b06f523e74f33p2);
+    R = fma(R, X2, 0x1.4537ddde2d76dp2);
+    R = fma(R, X2, -0x1.6067d334b4792p1);
+    R = fma(R, X2, 0x1.1fb54da575b22p0);
+    R = fma(R, X2, -0x1.57380bcd2890ep-2);
+    R = fma(R, X2, 0x1.69b370aad086ep-4);
+    R = fma(R, X2, -0x1.21438ccc95d62p-8);
+    R = fma(R, X2, 0x1.b8a33b8e380efp-7);
+    R = fma(R, X2, 0x1.c37061f4e5f55p-7);
+    R = fma(R, X2, 0x1.1c875d6c5323dp-6);
+    R = fma(R, X2, 0x1.6e88ce94d1149p-6);
+    R = fma(R, X2, 0x1.f1c73443a02f5p-6);
+    R = fma(R, X2, 0x1.6db6db3184756p-5);
+    R = fma(R, X2, 0x1.3333333380df2p-4);
+    R = fma(R, X2, 0x1.555555555531ep-3);
+    R = fma(R, X2, 0x1p0);
+    R *= X;
+
+    return R;
+}
+
+//
+// NOTE(casey): AVX2
+//
+
+inline __m256d SineCoreWithPrefix4(__m256d A, __m256d B, __m256d C)
+{
+    __m256d X = _mm256_fmadd_pd(A, B, C);
+    __m256d X2 = _mm256_mul_pd(X, X);
+
+    // NOTE(casey): These minimax coefficients were donated by Demetri Spanos
+    __m256d R = _mm256_set1_pd(0x1.883c1c5deffbep-49);
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.ae43dc9bf8ba7p-41));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.6123ce513b09fp-33));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.ae6454d960ac4p-26));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.71de3a52aab96p-19));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.a01a01a014eb6p-13));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.11111111110c9p-7));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.5555555555555p-3));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1p0));
+    R = _mm256_mul_pd(R, X);
+
+    return R;
+}
+
+inline __m256d ArcsineCoreFromSquared4(__m256d X2)
+{
+    __m256d X = _mm256_sqrt_pd(X2);
+
+    // NOTE(casey): These minimax coefficients were donated by Demetri Spanos
+    __m256d R = _mm256_set1_pd(0x1.dfc53682725cap-1);
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.bec6daf74ed61p1));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.8bf4dadaf548cp2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.b06f523e74f33p2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.4537ddde2d76dp2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.6067d334b4792p1));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.1fb54da575b22p0));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.57380bcd2890ep-2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.69b370aad086ep-4));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.21438ccc95d62p-8));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.b8a33b8e380efp-7));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.c37061f4e5f55p-7));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.1c875d6c5323dp-6));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.6e88ce94d1149p-6));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.f1c73443a02f5p-6));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.6db6db3184756p-5));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.3333333380df2p-4));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.555555555531ep-3));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1p0));
+    R = _mm256_mul_pd(R, X);
+
+    return R;
+}
+
+inline __m256d HaversineHalfAngle4(__m256d lon1, __m256d lat1, __m256d lon2, __m256d lat2)
+{
+    __m256d Zero = _mm256_setzero_pd();
+    __m256d SignBit = _mm256_set1_pd(-0.0);
+    __m256d RadC = _mm256_set1_pd(0.01745329251994329577);
+    __m256d NegRadC = _mm256_set1_pd(-0.01745329251994329577);
+    __m256d HalfRadC = _mm256_set1_pd(0.01745329251994329577/2.0);
+    __m256d NegHalfRadC = _mm256_set1_pd(-0.01745329251994329577/2.0);
+    __m256d Pi = _mm256_set1_pd(Pi64);
+    __m256d HalfPi = _mm256_set1_pd(Pi64/2.0);
+    __m256d Deg180 = _mm256_set1_pd(180.0);
+    __m256d Half = _mm256_set1_pd(0.5);
+    __m256d One = _mm256_set1_pd(1.0);
+
+    // NOTE(casey): (lat < 0) ? RadC : -RadC
+    __m256d SLC1 = _mm256_blendv_pd(NegRadC, RadC, _mm256_cmp_pd(lat1, Zero, _CMP_LT_OQ));
+    __m256d SLC2 = _mm256_blendv_pd(NegRadC, RadC, _mm256_cmp_pd(lat2, Zero, _CMP_LT_OQ));
+
+    // NOTE(casey): fabs(lat2 - lat1), fabs(lon2 - lon1)
+    __m256d DLat = _mm256_andnot_pd(SignBit, _mm256_sub_pd(lat2, lat1));
+    __m256d DLon = _mm256_andnot_pd(SignBit, _mm256_sub_pd(lon2, lon1));
+
+    // NOTE(casey): (D < 180) ? HalfRadC : -HalfRadC, and (D < 180) ? 0 : Pi
+    __m256d LatInRange = _mm256_cmp_pd(DLat, Deg180, _CMP_LT_OQ);
+    __m256d LonInRange = _mm256_cmp_pd(DLon, Deg180, _CMP_LT_OQ);
+    __m256d SLC0 = _mm256_blendv_pd(NegHalfRadC, HalfRadC, LatInRange);
+    __m256d SLC3 = _mm256_blendv_pd(NegHalfRadC, HalfRadC, LonInRange);
+    __m256d ALC0 = _mm256_blendv_pd(Pi, Zero, LatInRange);
+    __m256d ALC3 = _mm256_blendv_pd(Pi, Zero, LonInRange);
+
+    __m256d S1 = SineCoreWithPrefix4(SLC1, lat1, HalfPi);
+    __m256d S2 = SineCoreWithPrefix4(SLC2, lat2, HalfPi);
+    __m256d S0 = SineCoreWithPrefix4(SLC0, DLat, ALC0);
+    __m256d S3 = SineCoreWithPrefix4(SLC3, DLon, ALC3);
+
+    __m256d a = _mm256_fmadd_pd(S0, S0, _mm256_mul_pd(_mm256_mul_pd(S1, S2), _mm256_mul_pd(S3, S3)));
+
+    __m256d NeedsTransform = _mm256_cmp_pd(a, Half, _CMP_GT_OQ);
+    __m256d RangeA = _mm256_blendv_pd(a, _mm256_sub_pd(One, a), NeedsTransform);
+    __m256d R = ArcsineCoreFromSquared4(RangeA);
+    __m256d RangeR = _mm256_blendv_pd(R, _mm256_sub_pd(HalfPi, R), NeedsTransform);
+
+    return RangeR;
+}
+
+static f64 SumHaversineHalfAnglesAVX2(u64 PairCount, haversine_columns Columns)
+{
+    __m256d Sum0 = _mm256_setzero_pd();
+    __m256d Sum1 = _mm256_setzero_pd();
+
+    u64 PairIndex = 0;
+    for(; (PairIndex + 8) <= PairCount; PairIndex += 8)
+    {
+        __m256d R0 = HaversineHalfAngle4(_mm256_loadu_pd(Columns.X0 + PairIndex), _mm256_loadu_pd(Columns.Y0 + PairIndex),
+                                         _mm256_loadu_pd(Columns.X1 + PairIndex), _mm256_loadu_pd(Columns.Y1 + PairIndex));
+        __m256d R1 = HaversineHalfAngle4(_mm256_loadu_pd(Columns.X0 + PairIndex + 4), _mm256_loadu_pd(Columns.Y0 + PairIndex + 4),
+                                         _mm256_loadu_pd(Columns.X1 + PairIndex + 4), _mm256_loadu_pd(Columns.Y1 + PairIndex + 4));
+        Sum0 = _mm256_add_pd(Sum0, R0);
+        Sum1 = _mm256_add_pd(Sum1, R1);
+    }
+
+    for(; PairIndex < PairCount; PairIndex += 4)
+    {
+        __m256i Mask = GetLoadMask4(PairCount - PairIndex);
+        __m256d R = HaversineHalfAngle4(_mm256_maskload_pd(Columns.X0 + PairIndex, Mask), _mm256_maskload_pd(Columns.Y0 + PairIndex, Mask),
+                                        _mm256_maskload_pd(Columns.X1 + PairIndex, Mask), _mm256_maskload_pd(Columns.Y1 + PairIndex, Mask));
+        Sum0 = _mm256_add_pd(Sum0, R);
+    }
+
+    __m256d Sum = _mm256_add_pd(Sum0, Sum1);
+    __m128d Sum2 = _mm_add_pd(_mm256_castpd256_pd128(Sum), _mm256_extractf128_pd(Sum, 1));
+    f64 Result = _mm_cvtsd_f64(_mm_add_sd(Sum2, _mm_unpackhi_pd(Sum2, Sum2)));
+
+    return Result;
+}
+
+//
+// NOTE(casey): AVX-512
+//
+
+AVX512_FUNCTION inline __m512d SineCoreWithPrefix8(__m512d A, __m512d B, __m512d C)
+{
+    __m512d X = _mm512_fmadd_pd(A, B, C);
+    __m512d X2 = _mm512_mul_pd(X, X);
+
+    // NOTE(casey): These minimax coefficients were donated by Demetri Spanos
+    __m512d R = _mm512_set1_pd(0x1.883c1c5deffbep-49);
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.ae43dc9bf8ba7p-41));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.6123ce513b09fp-33));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.ae6454d960ac4p-26));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.71de3a52aab96p-19));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.a01a01a014eb6p-13));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.11111111110c9p-7));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.5555555555555p-3));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1p0));
+    R = _mm512_mul_pd(R, X);
+
+    return R;
+}
+
+AVX512_FUNCTION inline __m512d ArcsineCoreFromSquared8(__m512d X2)
+{
+    __m512d X = _mm512_sqrt_pd(X2);
+
+    // NOTE(casey): These minimax coefficients were donated by Demetri Spanos
+    __m512d R = _mm512_set1_pd(0x1.dfc53682725cap-1);
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.bec6daf74ed61p1));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.8bf4dadaf548cp2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.b06f523e74f33p2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.4537ddde2d76dp2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.6067d334b4792p1));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.1fb54da575b22p0));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.57380bcd2890ep-2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.69b370aad086ep-4));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.21438ccc95d62p-8));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.b8a33b8e380efp-7));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.c37061f4e5f55p-7));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.1c875d6c5323dp-6));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.6e88ce94d1149p-6));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.f1c73443a02f5p-6));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.6db6db3184756p-5));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.3333333380df2p-4));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.555555555531ep-3));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1p0));
+    R = _mm512_mul_pd(R, X);
+
+    return R;
+}
+
+AVX512_FUNCTION inline __m512d HaversineHalfAngle8(__m512d lon1, __m512d lat1, __m512d lon2, __m512d lat2)
+{
+    __m512d Zero = _mm512_setzero_pd();
+    __m512d RadC = _mm512_set1_pd(0.01745329251994329577);
+    __m512d NegRadC = _mm512_set1_pd(-0.01745329251994329577);
+    __m512d HalfRadC = _mm512_set1_pd(0.01745329251994329577/2.0);
+    __m512d NegHalfRadC = _mm512_set1_pd(-0.01745329251994329577/2.0);
+    __m512d Pi = _mm512_set1_pd(Pi64);
+    __m512d HalfPi = _mm512_set1_pd(Pi64/2.0);
+    __m512d Deg180 = _mm512_set1_pd(180.0);
+    __m512d Half = _mm512_set1_pd(0.5);
+    __m512d One = _mm512_set1_pd(1.0);
+
+    // NOTE(casey): (lat < 0) ? RadC : -RadC
+    __m512d SLC1 = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(lat1, Zero, _CMP_LT_OQ), NegRadC, RadC);
+    __m512d SLC2 = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(lat2, Zero, _CMP_LT_OQ), NegRadC, RadC);
+
+    // NOTE(casey): fabs(lat2 - lat1), fabs(lon2 - lon1)
+    __m512d DLat = _mm512_abs_pd(_mm512_sub_pd(lat2, lat1));
+    __m512d DLon = _mm512_abs_pd(_mm512_sub_pd(lon2, lon1));
+
+    // NOTE(casey): (D < 180) ? HalfRadC : -HalfRadC, and (D < 180) ? 0 : Pi
+    __mmask8 LatInRange = _mm512_cmp_pd_mask(DLat, Deg180, _CMP_LT_OQ);
+    __mmask8 LonInRange = _mm512_cmp_pd_mask(DLon, Deg180, _CMP_LT_OQ);
+    __m512d SLC0 = _mm512_mask_blend_pd(LatInRange, NegHalfRadC, HalfRadC);
+    __m512d SLC3 = _mm512_mask_blend_pd(LonInRange, NegHalfRadC, HalfRadC);
+    __m512d ALC0 = _mm512_mask_blend_pd(LatInRange, Pi, Zero);
+    __m512d ALC3 = _mm512_mask_blend_pd(LonInRange, Pi, Zero);
+
+    __m512d S1 = SineCoreWithPrefix8(SLC1, lat1, HalfPi);
+    __m512d S2 = SineCoreWithPrefix8(SLC2, lat2, HalfPi);
+    __m512d S0 = SineCoreWithPrefix8(SLC0, DLat, ALC0);
+    __m512d S3 = SineCoreWithPrefix8(SLC3, DLon, ALC3);
+
+    __m512d a = _mm512_fmadd_pd(S0, S0, _mm512_mul_pd(_mm512_mul_pd(S1, S2), _mm512_mul_pd(S3, S3)));
+
+    __mmask8 NeedsTransform = _mm512_cmp_pd_mask(a, Half, _CMP_GT_OQ);
+    __m512d RangeA = _mm512_mask_sub_pd(a, NeedsTransform, One, a);
+    __m512d R = ArcsineCoreFromSquared8(RangeA);
+    __m512d RangeR = _mm512_mask_sub_pd(R, NeedsTransform, HalfPi, R);
+
+    return RangeR;
+}
+
+AVX512_FUNCTION static f64 SumHaversineHalfAnglesAVX512(u64 PairCount, haversine_columns Columns)
+{
+    __m512d Sum0 = _mm512_setzero_pd();
+    __m512d Sum1 = _mm512_setzero_pd();
+
+    u64 PairIndex = 0;
+    for(; (PairIndex + 16) <= PairCount; PairIndex += 16)
+    {
+        __m512d R0 = HaversineHalfAngle8(_mm512_loadu_pd(Columns.X0 + PairIndex), _mm512_loadu_pd(Columns.Y0 + PairIndex),
+                                         _mm512_loadu_pd(Columns.X1 + PairIndex), _mm512_loadu_pd(Columns.Y1 + PairIndex));
+        __m512d R1 = HaversineHalfAngle8(_mm512_loadu_pd(Columns.X0 + PairIndex + 8), _mm512_loadu_pd(Columns.Y0 + PairIndex + 8),
+                                         _mm512_loadu_pd(Columns.X1 + PairIndex + 8), _mm512_loadu_pd(Columns.Y1 + PairIndex + 8));
+        Sum0 = _mm512_add_pd(Sum0, R0);
+        Sum1 = _mm512_add_pd(Sum1, R1);
+    }
+
+    for(; PairIndex < PairCount; PairIndex += 8)
+    {
+        u64 Remaining = PairCount - PairIndex;
+        __mmask8 Mask = (Remaining >= 8) ? (__mmask8)0xff : (__mmask8)((1u << Remaining) - 1);
+        __m512d R = HaversineHalfAngle8(_mm512_maskz_loadu_pd(Mask, Columns.X0 + PairIndex), _mm512_maskz_loadu_pd(Mask, Columns.Y0 + PairIndex),
+                                        _mm512_maskz_loadu_pd(Mask, Columns.X1 + PairIndex), _mm512_maskz_loadu_pd(Mask, Columns.Y1 + PairIndex));
+        Sum0 = _mm512_add_pd(Sum0, R);
+    }
+
+    f64 Result = _mm512_reduce_add_pd(_mm512_add_pd(Sum0, Sum1));
+    return Result;
+}
+
+//
+// NOTE(casey): Per-pair distances, for code that needs each distance rather than the sum
+//
+
+typedef void haversine_distance_func(u64 PairCount, haversine_columns Columns, f64 *Dest);
+
+inline void ComputeHaversineDistancesAVX2(u64 PairCount, haversine_columns Columns, f64 *Dest)
+{
+    __m256d Diameter = _mm256_set1_pd(2.0*QUESTIONABLE_EARTH_RADIUS);
+
+    for(u64 PairIndex = 0; PairIndex < PairCount; PairIndex += 4)
+    {
+        __m256i Mask = GetLoadMask4(PairCount - PairIndex);
+        __m256d R = HaversineHalfAngle4(_mm256_maskload_pd(Columns.X0 + PairIndex, Mask), _mm256_maskload_pd(Columns.Y0 + PairIndex, Mask),
+                                        _mm256_maskload_pd(Columns.X1 + PairIndex, Mask), _mm256_maskload_pd(Columns.Y1 + PairIndex, Mask));
+        _mm256_maskstore_pd(Dest + PairIndex, Mask, _mm256_mul_pd(Diameter, R));
+    }
+}
+
+AVX512_FUNCTION inline void ComputeHaversineDistancesAVX512(u64 PairCount, haversine_columns Columns, f64 *Dest)
+{
+    __m512d Diameter = _mm512_set1_pd(2.0*QUESTIONABLE_EARTH_RADIUS);
+
+    for(u64 PairIndex = 0; PairIndex < PairCount; PairIndex += 8)
+    {
+        u64 Remaining = PairCount - PairIndex;
+        __mmask8 Mask = (Remaining < 8) ? (__mmask8)((1u << Remaining) - 1) : (__mmask8)0xff;
+        __m512d R = HaversineHalfAngle8(_mm512_maskz_loadu_pd(Mask, Columns.X0 + PairIndex), _mm512_maskz_loadu_pd(Mask, Columns.Y0 + PairIndex),
+                                        _mm512_maskz_loadu_pd(Mask, Columns.X1 + PairIndex), _mm512_maskz_loadu_pd(Mask, Columns.Y1 + PairIndex));
+        _mm512_mask_storeu_pd(Dest + PairIndex, Mask, _mm512_mul_pd(Diameter, R));
+    }
+}
+
+//
+// NOTE(casey): Test functions
+//
+
+inline f64 AVX2Haversine(haversine_setup Setup)
+{
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+    f64 Result = SumCoef*SumHaversineHalfAnglesAVX2(Setup.PairCount, Setup.Columns);
+    return Result;
+}
+
+inline f64 AVX512Haversine(haversine_setup Setup)
+{
+    // NOTE(casey): Only call this if CPUSupportsAVX512F() says it's OK
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+    f64 Result = SumCoef*SumHaversineHalfAnglesAVX512(Setup.PairCount, Setup.Columns);
+    return Result;
+}
@@ -0,0 +1,95 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 216
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+
+static f64 SimplifiedHaversineI(haversine_setup Setup)
+{
+    // NOTE(casey): The last scalar variant from listing 195, unchanged
+
+    u64 PairCount = Setup.PairCount;
+    haversine_pair *Pairs = Setup.Pairs;
+
+    f64 Sum = 0;
+
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)PairCount;
+    for(u64 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+    {
+        haversine_pair Pair = Pairs[PairIndex];
+
+        f64 lat1 = Pair.Y0;
+        f64 lat2 = Pair.Y1;
+        f64 lon1 = Pair.X0;
+        f64 lon2 = Pair.X1;
+
+        f64 RadC = 0.01745329251994329577;
+        f64 HalfRadC = RadC/2.0;
+        f64 HalfPi = Pi64/2.0;
+        f64 Deg180 = 180.0;
+
+        f64 SLC1 = (lat1 < 0) ? RadC : -RadC;
+        f64 SLC2 = (lat2 < 0) ? RadC : -RadC;
+
+        f64 DLat = fabs(lat2 - lat1);
+        f64 DLon = fabs(lon2 - lon1);
+        f64 SLC0 = (DLat < Deg180) ? HalfRadC : -HalfRadC;
+        f64 SLC3 = (DLon < Deg180) ? HalfRadC : -HalfRadC;
+        f64 ALC0 = (DLat < Deg180) ? 0 : Pi64;
+        f64 ALC3 = (DLon < Deg180) ? 0 : Pi64;
+
+        f64 S1 = SineCoreWithPrefix(SLC1, lat1, HalfPi);
+        f64 S2 = SineCoreWithPrefix(SLC2, lat2, HalfPi);
+        f64 S0 = SineCoreWithPrefix(SLC0, DLat, ALC0);
+        f64 S3 = SineCoreWithPrefix(SLC3, DLon, ALC3);
+
+        f64 a = fma(S0, S0, S1*S2*S3*S3);
+
+        b32 NeedsTransform = (a > 0.5);
+        f64 RangeA = NeedsTransform ? (1.0 - a) : a;
+        f64 R = ArcsineCoreFromSquared(RangeA);
+        f64 RangeR = NeedsTransform ? (1.57079632679489661923 - R) : R;
+
+        Sum = fma(SumCoef, RangeR, Sum);
+    }
+
+    return Sum;
+}
+
+static test_function TestFunctions[] =
+{
+    {"ReferenceHaversine", ReferenceSumHaversine},
+    {"ReferenceHaversineColumns", ReferenceSumHaversineColumns},
+    {"ReplacementHaversine", ReplacementSumHaversine},
+    {"SimplifiedHaversineI", SimplifiedHaversineI},
+    {"AVX2Haversine", AVX2Haversine},
+
+    // NOTE(casey): This must stay last, so it can be left off on CPUs that don't have AVX-512
+    {"AVX512Haversine", AVX512Haversine},
+};
+
+int main(int ArgCount, char **Args)
+{
+    u32 TestFunctionCount = ArrayCount(TestFunctions);
+    if(!CPUSupportsAVX512F())
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so AVX512Haversine will not be tested.\n");
+        --TestFunctionCount;
+    }
+
+    CombinedHaversineTest(ArgCount, Args, TestFunctionCount, TestFunctions);
+    return 0;
+}
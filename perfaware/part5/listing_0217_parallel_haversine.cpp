@@ -0,0 +1,350 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 217
+   ======================================================================== */
+
+/* NOTE(casey): The pairs are always cut into blocks of the same size, no matter
+   how many threads there are. Whichever thread happens to grab a block, its
+   partial sum lands in that block's slot, and the slots are then added up in
+   a fixed pairwise tree. So the floating point operations - and therefore the
+   result, bit for bit - are the same for one thread or sixty-four.
+
+   Any haversine_compute_func can be run this way, since each block is handed
+   to it as a haversine_setup of its own. Compute functions return the average
+   distance for the pairs they were given, so each partial is weighted back up
+   by its block's pair count before the reduction, and the total is divided by
+   the full pair count at the end.
+
+   Summing is just one kind of block work. Anything else that can be done one
+   block at a time (like verifying the answers) can hand the pool its own
+   haversine_block_func instead. */
+
+#define PARALLEL_HAVERSINE_BLOCK_PAIR_COUNT (16*1024) // NOTE(casey): Keeps every block's columns 64-byte aligned
+#define PARALLEL_HAVERSINE_MAX_THREAD_COUNT 256
+
+typedef void haversine_block_func(void *Context, haversine_setup Block, u64 BlockIndex);
+
+struct haversine_thread_pool
+{
+    u32 WorkerCount;
+    u32 ActiveThreadCount; // NOTE(casey): Includes the calling thread, so 1 means no workers are used
+    thread_handle Workers[PARALLEL_HAVERSINE_MAX_THREAD_COUNT];
+
+    os_semaphore WorkReady;
+    os_semaphore WorkDone;
+
+    // NOTE(casey): Only written by the calling thread while the workers are asleep
+    haversine_block_func *BlockFunc;
+    void *BlockContext;
+    haversine_setup Setup;
+    u64 BlockCount;
+    b32 Quit;
+
+    // NOTE(casey): Used by ParallelSumHaversine
+    haversine_compute_func *Compute;
+    buffer PartialsBuffer;
+
+    u64 volatile NextBlockIndex;
+};
+
+static haversine_setup GetHaversineRange(haversine_setup Setup, u64 FirstPair, u64 PairCount)
+{
+    haversine_setup Result = Setup;
+    Result.PairCount = PairCount;
+    Result.ParsedByteCount = PairCount*sizeof(haversine_pair);
+    if(Result.Pairs)
+    {
+        Result.Pairs += FirstPair;
+    }
+    if(Result.Columns.X0)
+    {
+        Result.Columns.X0 += FirstPair;
+        Result.Columns.Y0 += FirstPair;
+        Result.Columns.X1 += FirstPair;
+        Result.Columns.Y1 += FirstPair;
+    }
+    if(Result.Columns32.X0)
+    {
+        Result.Columns32.X0 += FirstPair;
+        Result.Columns32.Y0 += FirstPair;
+        Result.Columns32.X1 += FirstPair;
+        Result.Columns32.Y1 += FirstPair;
+    }
+    if(Result.Answers)
+    {
+        Result.Answers += FirstPair;
+    }
+
+    return Result;
+}
+
+static haversine_setup GetHaversineBlock(haversine_setup Setup, u64 BlockIndex)
+{
+    u64 FirstPair = BlockIndex*PARALLEL_HAVERSINE_BLOCK_PAIR_COUNT;
+    u64 PairCount = Setup.PairCount - FirstPair;
+    if(PairCount > PARALLEL_HAVERSINE_BLOCK_PAIR_COUNT)
+    {
+        PairCount = PARALLEL_HAVERSINE_BLOCK_PAIR_COUNT;
+    }
+
+    haversine_setup Result = GetHaversineRange(Setup, FirstPair, PairCount);
+    return Result;
+}
+
+static void DoHaversineBlocks(haversine_thread_pool *Pool)
+{
+    for(;;)
+    {
+        u64 BlockIndex = AtomicAddU64(&Pool->NextBlockIndex, 1);
+        if(BlockIndex >= Pool->BlockCount)
+        {
+            break;
+        }
+
+        haversine_setup Block = GetHaversineBlock(Pool->Setup, BlockIndex);
+        Pool->BlockFunc(Pool->BlockContext, Block, BlockIndex);
+    }
+}
+
+THREAD_ENTRY_POINT(HaversineWorkerThread, Parameter)
+{
+    haversine_thread_pool *Pool = (haversine_thread_pool *)Parameter;
+
+    for(;;)
+    {
+        WaitOnSemaphore(&Pool->WorkReady);
+        if(Pool->Quit)
+        {
+            break;
+        }
+
+        DoHaversineBlocks(Pool);
+        SignalSemaphore(&Pool->WorkDone, 1);
+    }
+
+    return 0;
+}
+
+static b32 StartHaversineThreadPool(haversine_thread_pool *Pool, u32 ThreadCount)
+{
+    // NOTE(casey): The pool must not move after this, since the workers hold a pointer to it
+    *Pool = {};
+
+    if(ThreadCount < 1)
+    {
+        ThreadCount = 1;
+    }
+    if(ThreadCount > PARALLEL_HAVERSINE_MAX_THREAD_COUNT)
+    {
+        ThreadCount = PARALLEL_HAVERSINE_MAX_THREAD_COUNT;
+    }
+
+    b32 Result = (InitializeSemaphore(&Pool->WorkReady, PARALLEL_HAVERSINE_MAX_THREAD_COUNT) &&
+                  InitializeSemaphore(&Pool->WorkDone, PARALLEL_HAVERSINE_MAX_THREAD_COUNT));
+    if(Result)
+    {
+        // NOTE(casey): The calling thread always does work too, so it only needs ThreadCount-1 helpers
+        for(u32 WorkerIndex = 0; WorkerIndex < (ThreadCount - 1); ++WorkerIndex)
+        {
+            thread_handle Worker = CreateAndStartThread(HaversineWorkerThread, Pool);
+            if(!IsValidThread(Worker))
+            {
+                fprintf(stderr, "WARNING: Only able to start %u of %u worker threads\n", WorkerIndex, ThreadCount - 1);
+                break;
+            }
+
+            Pool->Workers[Pool->WorkerCount++] = Worker;
+        }
+    }
+
+    Pool->ActiveThreadCount = Pool->WorkerCount + 1;
+    return Result;
+}
+
+static void StopHaversineThreadPool(haversine_thread_pool *Pool)
+{
+    Pool->Quit = true;
+    SignalSemaphore(&Pool->WorkReady, Pool->WorkerCount);
+    for(u32 WorkerIndex = 0; WorkerIndex < Pool->WorkerCount; ++WorkerIndex)
+    {
+        WaitForThread(Pool->Workers[WorkerIndex]);
+    }
+
+    FreeSemaphore(&Pool->WorkReady);
+    FreeSemaphore(&Pool->WorkDone);
+    FreeBuffer(&Pool->PartialsBuffer);
+
+    *Pool = {};
+}
+
+static void SetActiveThreadCount(haversine_thread_pool *Pool, u32 ThreadCount)
+{
+    if(ThreadCount < 1)
+    {
+        ThreadCount = 1;
+    }
+    if(ThreadCount > (Pool->WorkerCount + 1))
+    {
+        ThreadCount = Pool->WorkerCount + 1;
+    }
+
+    Pool->ActiveThreadCount = ThreadCount;
+}
+
+static f64 ReducePairwise(u64 Count, f64 *Values)
+{
+    // NOTE(casey): Always the same tree for the same Count - adjacent pairs, then adjacent pairs of pairs, and so on
+    for(u64 Stride = 1; Stride < Count; Stride *= 2)
+    {
+        for(u64 Index = 0; (Index + Stride) < Count; Index += 2*Stride)
+        {
+            Values[Index] += Values[Index + Stride];
+        }
+    }
+
+    f64 Result = Count ? Values[0] : 0;
+    return Result;
+}
+
+static u64 GetHaversineBlockCount(u64 PairCount)
+{
+    u64 Result = (PairCount + PARALLEL_HAVERSINE_BLOCK_PAIR_COUNT - 1) / PARALLEL_HAVERSINE_BLOCK_PAIR_COUNT;
+    return Result;
+}
+
+static void RunHaversineBlocks(haversine_thread_pool *Pool, haversine_setup Setup, haversine_block_func *BlockFunc, void *BlockContext)
+{
+    // NOTE(casey): Returns once every block of Setup has been handed to BlockFunc exactly once
+    Pool->BlockFunc = BlockFunc;
+    Pool->BlockContext = BlockContext;
+    Pool->Setup = Setup;
+    Pool->BlockCount = GetHaversineBlockCount(Setup.PairCount);
+    Pool->NextBlockIndex = 0;
+
+    u32 HelperCount = Pool->ActiveThreadCount - 1;
+    SignalSemaphore(&Pool->WorkReady, HelperCount);
+    DoHaversineBlocks(Pool);
+    for(u32 HelperIndex = 0; HelperIndex < HelperCount; ++HelperIndex)
+    {
+        WaitOnSemaphore(&Pool->WorkDone);
+    }
+}
+
+static void SumHaversineBlock(void *Context, haversine_setup Block, u64 BlockIndex)
+{
+    haversine_thread_pool *Pool = (haversine_thread_pool *)Context;
+    f64 *Partials = (f64 *)Pool->PartialsBuffer.Data;
+    Partials[BlockIndex] = (f64)Block.PairCount*Pool->Compute(Block);
+}
+
+static f64 ParallelSumHaversine(haversine_thread_pool *Pool, haversine_setup Setup, haversine_compute_func *Compute)
+{
+    f64 Result = 0;
+
+    u64 BlockCount = GetHaversineBlockCount(Setup.PairCount);
+    if(Pool->PartialsBuffer.Count < (BlockCount*sizeof(f64)))
+    {
+        FreeBuffer(&Pool->PartialsBuffer);
+        Pool->PartialsBuffer = AllocateBuffer(BlockCount*sizeof(f64));
+    }
+
+    if(BlockCount && IsValid(Pool->PartialsBuffer))
+    {
+        Pool->Compute = Compute;
+        RunHaversineBlocks(Pool, Setup, SumHaversineBlock, Pool);
+
+        Result = ReducePairwise(BlockCount, (f64 *)Pool->PartialsBuffer.Data) / (f64)Setup.PairCount;
+    }
+
+    return Result;
+}
+
+static f64 ParallelHaversineRunner(void *Context, haversine_compute_func *Compute, haversine_setup Setup)
+{
+    haversine_thread_pool *Pool = (haversine_thread_pool *)Context;
+    f64 Result = ParallelSumHaversine(Pool, Setup, Compute);
+    return Result;
+}
+
+inline void ParallelHaversineTest(int ArgCount, char **Args, u32 TestFunctionCount, test_function *TestFunctions)
+{
+    /* NOTE(casey): The first row is every function run directly, for comparison.
+       After that there is one row per thread count, doubling up to the core count
+       (and always including the core count itself). */
+
+    haversine_setup Setup = {};
+    if(SetUpHaversineTest(ArgCount, Args, &Setup))
+    {
+        u32 CoreCount = GetCPUCoreCount();
+
+        haversine_thread_pool *Pool = (haversine_thread_pool *)calloc(1, sizeof(haversine_thread_pool));
+        buffer SumsBuffer = AllocateBuffer(2*TestFunctionCount*sizeof(f64));
+        repetition_test_series TestSeries = AllocateTestSeries(TestFunctionCount, 2 + 32);
+        if(Pool && IsValid(SumsBuffer) && IsValid(TestSeries) && StartHaversineThreadPool(Pool, CoreCount))
+        {
+            f64 *FirstSums = (f64 *)SumsBuffer.Data;
+            f64 *Sums = FirstSums + TestFunctionCount;
+
+            SetRowLabelLabel(&TestSeries, "Threads");
+            SetRowLabel(&TestSeries, "Direct");
+            RunHaversineTestRow(&TestSeries, Setup, TestFunctionCount, TestFunctions);
+
+            u32 MaxThreadCount = Pool->WorkerCount + 1;
+            for(u32 ThreadCount = 1;; ThreadCount *= 2)
+            {
+                if(ThreadCount > MaxThreadCount)
+                {
+                    ThreadCount = MaxThreadCount;
+                }
+
+                SetActiveThreadCount(Pool, ThreadCount);
+                SetRowLabel(&TestSeries, "%u", ThreadCount);
+                RunHaversineTestRow(&TestSeries, Setup, TestFunctionCount, TestFunctions,
+                                    ParallelHaversineRunner, Pool, (ThreadCount == 1) ? FirstSums : Sums);
+
+                if(ThreadCount > 1)
+                {
+                    for(u32 TestFunctionIndex = 0; TestFunctionIndex < TestFunctionCount; ++TestFunctionIndex)
+                    {
+                        if(memcmp(FirstSums + TestFunctionIndex, Sums + TestFunctionIndex, sizeof(f64)) != 0)
+                        {
+                            fprintf(stderr, "WARNING: %s on %u threads did not reproduce the 1-thread sum exactly\n",
+                                    TestFunctions[TestFunctionIndex].Name, ThreadCount);
+                        }
+                    }
+                }
+
+                if(ThreadCount == MaxThreadCount)
+                {
+                    break;
+                }
+            }
+
+            fprintf(stdout, "\nGB/s:\n");
+            PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, 1.0);
+
+            StopHaversineThreadPool(Pool);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Unable to start the thread pool\n");
+        }
+
+        FreeTestSeries(&TestSeries);
+        FreeBuffer(&SumsBuffer);
+        free(Pool);
+    }
+
+    FreeHaversine(&Setup);
+}
@@ -0,0 +1,46 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 218
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+#include "listing_0217_parallel_haversine.cpp"
+
+static test_function TestFunctions[] =
+{
+    {"ReferenceHaversine", ReferenceSumHaversine},
+    {"ReferenceHaversineColumns", ReferenceSumHaversineColumns},
+    {"ReplacementHaversine", ReplacementSumHaversine},
+    {"AVX2Haversine", AVX2Haversine},
+
+    // NOTE(casey): This must stay last, so it can be left off on CPUs that don't have AVX-512
+    {"AVX512Haversine", AVX512Haversine},
+};
+
+int main(int ArgCount, char **Args)
+{
+    u32 TestFunctionCount = ArrayCount(TestFunctions);
+    if(!CPUSupportsAVX512F())
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so AVX512Haversine will not be tested.\n");
+        --TestFunctionCount;
+    }
+
+    ParallelHaversineTest(ArgCount, Args, TestFunctionCount, TestFunctions);
+
+    (void)&CombinedHaversineTest;
+
+    return 0;
+}
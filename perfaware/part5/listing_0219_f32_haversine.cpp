@@ -0,0 +1,427 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 219
+   ======================================================================== */
+
+/* NOTE(casey): Single-precision versions of the sine and arcsine cores, and of
+   the SIMD haversine kernels from listing 215. The double-precision polynomials
+   are far more accurate than a float can hold, so these were refit with the
+   Remez exchange algorithm (in long double) for minimum relative error. Float
+   needs far fewer terms:
+
+       sin(x) = x*P(x^2) for x in [0, Pi/2] - 5 terms, 5.3e-9 max relative error
+       asin(x) = x*Q(x^2) for x^2 in [0, 1/2] - 8 terms, 1.5e-8 max relative error
+
+   Both are below the half-ulp of a float (2^-24 ~= 6e-8), so rounding the inputs
+   and the arithmetic dominates the error, not the polynomials.
+
+   The per-pair math is all f32, but the sums are widened to f64 before they are
+   accumulated. A million floats summed in float would lose far more than the
+   per-pair error. Even so, the result cannot pass the ApproxAreEqual epsilon,
+   which is tighter than float coordinates can resolve, so these test functions
+   carry their own tolerance - HAVERSINE32_TOLERANCE - as the error budget. */
+
+#define HAVERSINE32_TOLERANCE 0.01 // NOTE(casey): Average distance must be within ten meters of the f64 answer
+
+inline f32 SqrtCE32(f32 ScalarX)
+{
+    __m128 X = _mm_set_ss(ScalarX);
+    __m128 SqrtX = _mm_sqrt_ss(X);
+    f32 Result = _mm_cvtss_f32(SqrtX);
+    return Result;
+}
+
+inline f32 SineCoreWithPrefix32(f32 A, f32 B, f32 C)
+{
+    f32 X = fmaf(A, B, C);
+    f32 X2 = X*X;
+
+    f32 R = 0x1.5d38b6p-19f;
+    R = fmaf(R, X2, -0x1.9f6446p-13f);
+    R = fmaf(R, X2, 0x1.110e7cp-7f);
+    R = fmaf(R, X2, -0x1.555548p-3f);
+    R = fmaf(R, X2, 0x1p0f);
+    R *= X;
+
+    return R;
+}
+
+inline f32 ArcsineCoreFromSquared32(f32 X2)
+{
+    f32 X = SqrtCE32(X2);
+
+    f32 R = 0x1.d0b0eep-4f;
+    R = fmaf(R, X2, -0x1.8bdc02p-4f);
+    R = fmaf(R, X2, 0x1.47b8e8p-4f);
+    R = fmaf(R, X2, 0x1.f2d23cp-7f);
+    R = fmaf(R, X2, 0x1.7ee854p-5f);
+    R = fmaf(R, X2, 0x1.32a01ep-4f);
+    R = fmaf(R, X2, 0x1.55573p-3f);
+    R = fmaf(R, X2, 0x1p0f);
+    R *= X;
+
+    return R;
+}
+
+inline f32 SinCE32(f32 OrigX)
+{
+    f32 HalfPi = (f32)(Pi64/2);
+    f32 PosX = fabsf(OrigX);
+    f32 X = (PosX > HalfPi) ? ((f32)Pi64 - PosX) : PosX;
+
+    f32 R = SineCoreWithPrefix32(1.0f, X, 0.0f);
+
+    f32 Result = (OrigX < 0) ? -R : R;
+    return Result;
+}
+
+inline f32 ASinCE32(f32 OrigX)
+{
+    /* NOTE(casey): Works on squares the whole way, so the transformed range never needs
+       SqrtCE(1 - x*x). 1 - x*x is computed as (1 - x)*(1 + x), because 1 - x is exact for
+       x in [0.5, 1] whereas 1 - x*x throws away most of the bits of x*x near 1. */
+    f32 PosX = fabsf(OrigX);
+    f32 X2 = PosX*PosX;
+
+    b32 NeedsTransform = (X2 > 0.5f);
+    f32 RangeX2 = NeedsTransform ? ((1.0f - PosX)*(1.0f + PosX)) : X2;
+    f32 R = ArcsineCoreFromSquared32(RangeX2);
+    f32 RangeR = NeedsTransform ? ((f32)(Pi64/2) - R) : R;
+
+    f32 Result = (OrigX < 0) ? -RangeR : RangeR;
+    return Result;
+}
+
+inline f32 HaversineHalfAngle32(f32 lon1, f32 lat1, f32 lon2, f32 lat2)
+{
+    // NOTE(casey): SimplifiedHaversineI from listing 195, in f32
+
+    f32 RadC = 0.01745329251994329577f;
+    f32 HalfRadC = RadC/2.0f;
+    f32 Pi = (f32)Pi64;
+    f32 HalfPi = (f32)(Pi64/2.0);
+    f32 Deg180 = 180.0f;
+
+    f32 SLC1 = (lat1 < 0) ? RadC : -RadC;
+    f32 SLC2 = (lat2 < 0) ? RadC : -RadC;
+
+    f32 DLat = fabsf(lat2 - lat1);
+    f32 DLon = fabsf(lon2 - lon1);
+    f32 SLC0 = (DLat < Deg180) ? HalfRadC : -HalfRadC;
+    f32 SLC3 = (DLon < Deg180) ? HalfRadC : -HalfRadC;
+    f32 ALC0 = (DLat < Deg180) ? 0 : Pi;
+    f32 ALC3 = (DLon < Deg180) ? 0 : Pi;
+
+    f32 S1 = SineCoreWithPrefix32(SLC1, lat1, HalfPi);
+    f32 S2 = SineCoreWithPrefix32(SLC2, lat2, HalfPi);
+    f32 S0 = SineCoreWithPrefix32(SLC0, DLat, ALC0);
+    f32 S3 = SineCoreWithPrefix32(SLC3, DLon, ALC3);
+
+    f32 a = fmaf(S0, S0, S1*S2*S3*S3);
+
+    b32 NeedsTransform = (a > 0.5f);
+    f32 RangeA = NeedsTransform ? (1.0f - a) : a;
+    f32 R = ArcsineCoreFromSquared32(RangeA);
+    f32 RangeR = NeedsTransform ? (HalfPi - R) : R;
+
+    return RangeR;
+}
+
+static f64 SumHaversineHalfAngles32(u64 PairCount, haversine_columns32 Columns)
+{
+    f64 Result = 0;
+    for(u64 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+    {
+        Result += HaversineHalfAngle32(Columns.X0[PairIndex], Columns.Y0[PairIndex],
+                                       Columns.X1[PairIndex], Columns.Y1[PairIndex]);
+    }
+
+    return Result;
+}
+
+//
+// NOTE(casey): AVX2
+//
+
+inline __m256 SineCoreWithPrefix8f(__m256 A, __m256 B, __m256 C)
+{
+    __m256 X = _mm256_fmadd_ps(A, B, C);
+    __m256 X2 = _mm256_mul_ps(X, X);
+
+    __m256 R = _mm256_set1_ps(0x1.5d38b6p-19f);
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(-0x1.9f6446p-13f));
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(0x1.110e7cp-7f));
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(-0x1.555548p-3f));
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(0x1p0f));
+    R = _mm256_mul_ps(R, X);
+
+    return R;
+}
+
+inline __m256 ArcsineCoreFromSquared8f(__m256 X2)
+{
+    __m256 X = _mm256_sqrt_ps(X2);
+
+    __m256 R = _mm256_set1_ps(0x1.d0b0eep-4f);
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(-0x1.8bdc02p-4f));
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(0x1.47b8e8p-4f));
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(0x1.f2d23cp-7f));
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(0x1.7ee854p-5f));
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(0x1.32a01ep-4f));
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(0x1.55573p-3f));
+    R = _mm256_fmadd_ps(R, X2, _mm256_set1_ps(0x1p0f));
+    R = _mm256_mul_ps(R, X);
+
+    return R;
+}
+
+inline __m256 SinCE8f(__m256 OrigX)
+{
+    // NOTE(casey): Eight lanes of SinCE32, with the same operations, so it rounds identically
+    __m256 SignBit = _mm256_set1_ps(-0.0f);
+    __m256 HalfPi = _mm256_set1_ps((f32)(Pi64/2));
+
+    __m256 PosX = _mm256_andnot_ps(SignBit, OrigX);
+    __m256 FoldedX = _mm256_sub_ps(_mm256_set1_ps((f32)Pi64), PosX);
+    __m256 X = _mm256_blendv_ps(PosX, FoldedX, _mm256_cmp_ps(PosX, HalfPi, _CMP_GT_OQ));
+
+    __m256 R = SineCoreWithPrefix8f(_mm256_set1_ps(1.0f), X, _mm256_setzero_ps());
+
+    __m256 Negative = _mm256_cmp_ps(OrigX, _mm256_setzero_ps(), _CMP_LT_OQ);
+    __m256 Result = _mm256_xor_ps(R, _mm256_and_ps(Negative, SignBit));
+    return Result;
+}
+
+inline __m256 ASinCE8f(__m256 OrigX)
+{
+    // NOTE(casey): Eight lanes of ASinCE32, with the same operations, so it rounds identically
+    __m256 SignBit = _mm256_set1_ps(-0.0f);
+    __m256 One = _mm256_set1_ps(1.0f);
+
+    __m256 PosX = _mm256_andnot_ps(SignBit, OrigX);
+    __m256 X2 = _mm256_mul_ps(PosX, PosX);
+
+    __m256 NeedsTransform = _mm256_cmp_ps(X2, _mm256_set1_ps(0.5f), _CMP_GT_OQ);
+    __m256 TransformedX2 = _mm256_mul_ps(_mm256_sub_ps(One, PosX), _mm256_add_ps(One, PosX));
+    __m256 RangeX2 = _mm256_blendv_ps(X2, TransformedX2, NeedsTransform);
+    __m256 R = ArcsineCoreFromSquared8f(RangeX2);
+    __m256 RangeR = _mm256_blendv_ps(R, _mm256_sub_ps(_mm256_set1_ps((f32)(Pi64/2)), R), NeedsTransform);
+
+    __m256 Negative = _mm256_cmp_ps(OrigX, _mm256_setzero_ps(), _CMP_LT_OQ);
+    __m256 Result = _mm256_xor_ps(RangeR, _mm256_and_ps(Negative, SignBit));
+    return Result;
+}
+
+inline __m256 HaversineHalfAngle8f(__m256 lon1, __m256 lat1, __m256 lon2, __m256 lat2)
+{
+    __m256 Zero = _mm256_setzero_ps();
+    __m256 SignBit = _mm256_set1_ps(-0.0f);
+    __m256 RadC = _mm256_set1_ps(0.01745329251994329577f);
+    __m256 NegRadC = _mm256_set1_ps(-0.01745329251994329577f);
+    __m256 HalfRadC = _mm256_set1_ps(0.01745329251994329577f/2.0f);
+    __m256 NegHalfRadC = _mm256_set1_ps(-0.01745329251994329577f/2.0f);
+    __m256 Pi = _mm256_set1_ps((f32)Pi64);
+    __m256 HalfPi = _mm256_set1_ps((f32)(Pi64/2.0));
+    __m256 Deg180 = _mm256_set1_ps(180.0f);
+    __m256 Half = _mm256_set1_ps(0.5f);
+    __m256 One = _mm256_set1_ps(1.0f);
+
+    __m256 SLC1 = _mm256_blendv_ps(NegRadC, RadC, _mm256_cmp_ps(lat1, Zero, _CMP_LT_OQ));
+    __m256 SLC2 = _mm256_blendv_ps(NegRadC, RadC, _mm256_cmp_ps(lat2, Zero, _CMP_LT_OQ));
+
+    __m256 DLat = _mm256_andnot_ps(SignBit, _mm256_sub_ps(lat2, lat1));
+    __m256 DLon = _mm256_andnot_ps(SignBit, _mm256_sub_ps(lon2, lon1));
+
+    __m256 LatInRange = _mm256_cmp_ps(DLat, Deg180, _CMP_LT_OQ);
+    __m256 LonInRange = _mm256_cmp_ps(DLon, Deg180, _CMP_LT_OQ);
+    __m256 SLC0 = _mm256_blendv_ps(NegHalfRadC, HalfRadC, LatInRange);
+    __m256 SLC3 = _mm256_blendv_ps(NegHalfRadC, HalfRadC, LonInRange);
+    __m256 ALC0 = _mm256_blendv_ps(Pi, Zero, LatInRange);
+    __m256 ALC3 = _mm256_blendv_ps(Pi, Zero, LonInRange);
+
+    __m256 S1 = SineCoreWithPrefix8f(SLC1, lat1, HalfPi);
+    __m256 S2 = SineCoreWithPrefix8f(SLC2, lat2, HalfPi);
+    __m256 S0 = SineCoreWithPrefix8f(SLC0, DLat, ALC0);
+    __m256 S3 = SineCoreWithPrefix8f(SLC3, DLon, ALC3);
+
+    __m256 a = _mm256_fmadd_ps(S0, S0, _mm256_mul_ps(_mm256_mul_ps(S1, S2), _mm256_mul_ps(S3, S3)));
+
+    __m256 NeedsTransform = _mm256_cmp_ps(a, Half, _CMP_GT_OQ);
+    __m256 RangeA = _mm256_blendv_ps(a, _mm256_sub_ps(One, a), NeedsTransform);
+    __m256 R = ArcsineCoreFromSquared8f(RangeA);
+    __m256 RangeR = _mm256_blendv_ps(R, _mm256_sub_ps(HalfPi, R), NeedsTransform);
+
+    return RangeR;
+}
+
+static f64 SumHaversineHalfAnglesAVX2_32(u64 PairCount, haversine_columns32 Columns)
+{
+    __m256d Sum0 = _mm256_setzero_pd();
+    __m256d Sum1 = _mm256_setzero_pd();
+
+    __m256i Indices = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    for(u64 PairIndex = 0; PairIndex < PairCount; PairIndex += 8)
+    {
+        __m256 R;
+        u64 Remaining = PairCount - PairIndex;
+        if(Remaining >= 8)
+        {
+            R = HaversineHalfAngle8f(_mm256_loadu_ps(Columns.X0 + PairIndex), _mm256_loadu_ps(Columns.Y0 + PairIndex),
+                                     _mm256_loadu_ps(Columns.X1 + PairIndex), _mm256_loadu_ps(Columns.Y1 + PairIndex));
+        }
+        else
+        {
+            // NOTE(casey): All-zero pairs contribute exactly zero, so the unused lanes are just zero-filled
+            __m256i Mask = _mm256_cmpgt_epi32(_mm256_set1_epi32((int)Remaining), Indices);
+            R = HaversineHalfAngle8f(_mm256_maskload_ps(Columns.X0 + PairIndex, Mask), _mm256_maskload_ps(Columns.Y0 + PairIndex, Mask),
+                                     _mm256_maskload_ps(Columns.X1 + PairIndex, Mask), _mm256_maskload_ps(Columns.Y1 + PairIndex, Mask));
+        }
+
+        // NOTE(casey): Widen to f64 before accumulating, one accumulator per half
+        Sum0 = _mm256_add_pd(Sum0, _mm256_cvtps_pd(_mm256_castps256_ps128(R)));
+        Sum1 = _mm256_add_pd(Sum1, _mm256_cvtps_pd(_mm256_extractf128_ps(R, 1)));
+    }
+
+    __m256d Sum = _mm256_add_pd(Sum0, Sum1);
+    __m128d Sum2 = _mm_add_pd(_mm256_castpd256_pd128(Sum), _mm256_extractf128_pd(Sum, 1));
+    f64 Result = _mm_cvtsd_f64(_mm_add_sd(Sum2, _mm_unpackhi_pd(Sum2, Sum2)));
+
+    return Result;
+}
+
+//
+// NOTE(casey): AVX-512
+//
+
+AVX512_FUNCTION inline __m512 SineCoreWithPrefix16f(__m512 A, __m512 B, __m512 C)
+{
+    __m512 X = _mm512_fmadd_ps(A, B, C);
+    __m512 X2 = _mm512_mul_ps(X, X);
+
+    __m512 R = _mm512_set1_ps(0x1.5d38b6p-19f);
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(-0x1.9f6446p-13f));
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(0x1.110e7cp-7f));
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(-0x1.555548p-3f));
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(0x1p0f));
+    R = _mm512_mul_ps(R, X);
+
+    return R;
+}
+
+AVX512_FUNCTION inline __m512 ArcsineCoreFromSquared16f(__m512 X2)
+{
+    __m512 X = _mm512_sqrt_ps(X2);
+
+    __m512 R = _mm512_set1_ps(0x1.d0b0eep-4f);
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(-0x1.8bdc02p-4f));
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(0x1.47b8e8p-4f));
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(0x1.f2d23cp-7f));
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(0x1.7ee854p-5f));
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(0x1.32a01ep-4f));
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(0x1.55573p-3f));
+    R = _mm512_fmadd_ps(R, X2, _mm512_set1_ps(0x1p0f));
+    R = _mm512_mul_ps(R, X);
+
+    return R;
+}
+
+AVX512_FUNCTION inline __m512 HaversineHalfAngle16f(__m512 lon1, __m512 lat1, __m512 lon2, __m512 lat2)
+{
+    __m512 Zero = _mm512_setzero_ps();
+    __m512 RadC = _mm512_set1_ps(0.01745329251994329577f);
+    __m512 NegRadC = _mm512_set1_ps(-0.01745329251994329577f);
+    __m512 HalfRadC = _mm512_set1_ps(0.01745329251994329577f/2.0f);
+    __m512 NegHalfRadC = _mm512_set1_ps(-0.01745329251994329577f/2.0f);
+    __m512 Pi = _mm512_set1_ps((f32)Pi64);
+    __m512 HalfPi = _mm512_set1_ps((f32)(Pi64/2.0));
+    __m512 Deg180 = _mm512_set1_ps(180.0f);
+    __m512 Half = _mm512_set1_ps(0.5f);
+    __m512 One = _mm512_set1_ps(1.0f);
+
+    __m512 SLC1 = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(lat1, Zero, _CMP_LT_OQ), NegRadC, RadC);
+    __m512 SLC2 = _mm512_mask_blend_ps(_mm512_cmp_ps_mask(lat2, Zero, _CMP_LT_OQ), NegRadC, RadC);
+
+    __m512 DLat = _mm512_abs_ps(_mm512_sub_ps(lat2, lat1));
+    __m512 DLon = _mm512_abs_ps(_mm512_sub_ps(lon2, lon1));
+
+    __mmask16 LatInRange = _mm512_cmp_ps_mask(DLat, Deg180, _CMP_LT_OQ);
+    __mmask16 LonInRange = _mm512_cmp_ps_mask(DLon, Deg180, _CMP_LT_OQ);
+    __m512 SLC0 = _mm512_mask_blend_ps(LatInRange, NegHalfRadC, HalfRadC);
+    __m512 SLC3 = _mm512_mask_blend_ps(LonInRange, NegHalfRadC, HalfRadC);
+    __m512 ALC0 = _mm512_mask_blend_ps(LatInRange, Pi, Zero);
+    __m512 ALC3 = _mm512_mask_blend_ps(LonInRange, Pi, Zero);
+
+    __m512 S1 = SineCoreWithPrefix16f(SLC1, lat1, HalfPi);
+    __m512 S2 = SineCoreWithPrefix16f(SLC2, lat2, HalfPi);
+    __m512 S0 = SineCoreWithPrefix16f(SLC0, DLat, ALC0);
+    __m512 S3 = SineCoreWithPrefix16f(SLC3, DLon, ALC3);
+
+    __m512 a = _mm512_fmadd_ps(S0, S0, _mm512_mul_ps(_mm512_mul_ps(S1, S2), _mm512_mul_ps(S3, S3)));
+
+    __mmask16 NeedsTransform = _mm512_cmp_ps_mask(a, Half, _CMP_GT_OQ);
+    __m512 RangeA = _mm512_mask_sub_ps(a, NeedsTransform, One, a);
+    __m512 R = ArcsineCoreFromSquared16f(RangeA);
+    __m512 RangeR = _mm512_mask_sub_ps(R, NeedsTransform, HalfPi, R);
+
+    return RangeR;
+}
+
+AVX512_FUNCTION static f64 SumHaversineHalfAnglesAVX512_32(u64 PairCount, haversine_columns32 Columns)
+{
+    __m512d Sum0 = _mm512_setzero_pd();
+    __m512d Sum1 = _mm512_setzero_pd();
+
+    for(u64 PairIndex = 0; PairIndex < PairCount; PairIndex += 16)
+    {
+        u64 Remaining = PairCount - PairIndex;
+        __mmask16 Mask = (Remaining >= 16) ? (__mmask16)0xffff : (__mmask16)((1u << Remaining) - 1);
+        __m512 R = HaversineHalfAngle16f(_mm512_maskz_loadu_ps(Mask, Columns.X0 + PairIndex), _mm512_maskz_loadu_ps(Mask, Columns.Y0 + PairIndex),
+                                         _mm512_maskz_loadu_ps(Mask, Columns.X1 + PairIndex), _mm512_maskz_loadu_ps(Mask, Columns.Y1 + PairIndex));
+
+        // NOTE(casey): Widen to f64 before accumulating, one accumulator per half
+        __m256 Low = _mm512_castps512_ps256(R);
+        __m256 High = _mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(R), 1));
+        Sum0 = _mm512_add_pd(Sum0, _mm512_cvtps_pd(Low));
+        Sum1 = _mm512_add_pd(Sum1, _mm512_cvtps_pd(High));
+    }
+
+    f64 Result = _mm512_reduce_add_pd(_mm512_add_pd(Sum0, Sum1));
+    return Result;
+}
+
+//
+// NOTE(casey): Test functions - these all need BuildColumns32 to have been called on the setup
+//
+
+inline f64 SimplifiedHaversine32(haversine_setup Setup)
+{
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+    f64 Result = SumCoef*SumHaversineHalfAngles32(Setup.PairCount, Setup.Columns32);
+    return Result;
+}
+
+inline f64 AVX2Haversine32(haversine_setup Setup)
+{
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+    f64 Result = SumCoef*SumHaversineHalfAnglesAVX2_32(Setup.PairCount, Setup.Columns32);
+    return Result;
+}
+
+inline f64 AVX512Haversine32(haversine_setup Setup)
+{
+    // NOTE(casey): Only call this if CPUSupportsAVX512F() says it's OK
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+    f64 Result = SumCoef*SumHaversineHalfAnglesAVX512_32(Setup.PairCount, Setup.Columns32);
+    return Result;
+}
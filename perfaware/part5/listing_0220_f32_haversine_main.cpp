@@ -0,0 +1,118 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 220
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+#include "listing_0219_f32_haversine.cpp"
+
+static test_function TestFunctions[] =
+{
+    {"ReferenceHaversineColumns", ReferenceSumHaversineColumns},
+    {"AVX2Haversine", AVX2Haversine},
+    {"SimplifiedHaversine32", SimplifiedHaversine32, HAVERSINE32_TOLERANCE},
+    {"AVX2Haversine32", AVX2Haversine32, HAVERSINE32_TOLERANCE},
+
+    // NOTE(casey): These must stay last, so they can be left off on CPUs that don't have AVX-512
+    {"AVX512Haversine", AVX512Haversine},
+    {"AVX512Haversine32", AVX512Haversine32, HAVERSINE32_TOLERANCE},
+};
+
+static void TestPrecision32(haversine_setup Setup)
+{
+    /* NOTE(casey): The function tests round each input to f32 first and give the
+       f64 reference the same rounded input, so they measure only the error of the
+       f32 function itself. The haversine test measures everything together,
+       including rounding the coordinates to f32. */
+
+    math_tester Tester = {};
+
+    while(PrecisionTest(&Tester, -Pi64, Pi64))
+    {
+        f32 X = (f32)Tester.InputValue;
+        TestResult(&Tester, sin(X), SinCE(X), "SinCE");
+        TestResult(&Tester, sin(X), SinCE32(X), "SinCE32");
+    }
+
+    while(PrecisionTest(&Tester, 0, 1))
+    {
+        f32 X = (f32)Tester.InputValue;
+        TestResult(&Tester, asin(X), ASinCE(X), "ASinCE");
+        TestResult(&Tester, asin(X), ASinCE32(X), "ASinCE32");
+    }
+
+    while(PrecisionTest(&Tester, 0, 0.5))
+    {
+        f32 X2 = (f32)Tester.InputValue;
+        TestResult(&Tester, asin(sqrt(X2)), ArcsineCoreFromSquared32(X2), "ArcsineCoreFromSquared32");
+    }
+
+    haversine_columns Columns = Setup.Columns;
+    haversine_columns32 Columns32 = Setup.Columns32;
+    while(PrecisionTest(&Tester, 0, (f64)(Setup.PairCount - 1), (u32)Setup.PairCount))
+    {
+        u64 PairIndex = (u64)(Tester.InputValue + 0.5);
+        f64 Expected = ReferenceHaversine(Columns.X0[PairIndex], Columns.Y0[PairIndex],
+                                          Columns.X1[PairIndex], Columns.Y1[PairIndex], QUESTIONABLE_EARTH_RADIUS);
+        f64 Output = 2.0*QUESTIONABLE_EARTH_RADIUS*HaversineHalfAngle32(Columns32.X0[PairIndex], Columns32.Y0[PairIndex],
+                                                                         Columns32.X1[PairIndex], Columns32.Y1[PairIndex]);
+        TestResult(&Tester, Expected, Output, "HaversineHalfAngle32 (km, by pair index)");
+    }
+
+    PrintResults(&Tester);
+}
+
+int main(int ArgCount, char **Args)
+{
+    u32 TestFunctionCount = ArrayCount(TestFunctions);
+    if(!CPUSupportsAVX512F())
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so the AVX-512 kernels will not be tested.\n");
+        TestFunctionCount -= 2;
+    }
+
+    haversine_setup Setup = {};
+    if(SetUpHaversineTest(ArgCount, Args, &Setup))
+    {
+        if(BuildColumns32(&Setup))
+        {
+            TestPrecision32(Setup);
+
+            repetition_test_series TestSeries = AllocateTestSeries(TestFunctionCount, 1);
+            if(IsValid(TestSeries))
+            {
+                fprintf(stdout, "\nf32 error budget: %f km on the average distance\n\n", HAVERSINE32_TOLERANCE);
+
+                SetRowLabelLabel(&TestSeries, "Test");
+                SetRowLabel(&TestSeries, "Haversine");
+                RunHaversineTestRow(&TestSeries, Setup, TestFunctionCount, TestFunctions);
+
+                PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, 1.0);
+            }
+
+            FreeTestSeries(&TestSeries);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Unable to allocate f32 columns\n");
+        }
+    }
+
+    FreeHaversine(&Setup);
+
+    (void)&CombinedHaversineTest;
+
+    return 0;
+}
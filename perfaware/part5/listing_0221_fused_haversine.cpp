@@ -0,0 +1,121 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 221
+   ======================================================================== */
+
+/* NOTE(casey): Fused parse-and-compute. The streaming parser from listing 207
+   hands over pairs one at a time, and they are collected into a small batch of
+   columns. Whenever the batch fills up, the SIMD kernel from listing 215 sums it
+   and it starts over. The batch is 8k, so it never leaves L1, and the full
+   pair array is never written out and then read back in. */
+
+#define FUSED_HAVERSINE_BATCH_PAIR_COUNT 256 // NOTE(casey): 4 columns * 256 * 8 bytes = 8k
+
+typedef f64 haversine_half_angle_sum(u64 PairCount, haversine_columns Columns);
+
+struct fused_haversine
+{
+    haversine_half_angle_sum *SumHalfAngles;
+
+    u64 PairCount;
+    f64 HalfAngleSum;
+
+    u32 BatchCount;
+    f64 X0[FUSED_HAVERSINE_BATCH_PAIR_COUNT];
+    f64 Y0[FUSED_HAVERSINE_BATCH_PAIR_COUNT];
+    f64 X1[FUSED_HAVERSINE_BATCH_PAIR_COUNT];
+    f64 Y1[FUSED_HAVERSINE_BATCH_PAIR_COUNT];
+};
+
+static void BeginFusedHaversine(fused_haversine *Fused, haversine_half_angle_sum *SumHalfAngles)
+{
+    Fused->SumHalfAngles = SumHalfAngles;
+    Fused->PairCount = 0;
+    Fused->HalfAngleSum = 0;
+    Fused->BatchCount = 0;
+}
+
+static void FlushFusedBatch(fused_haversine *Fused)
+{
+    haversine_columns Columns = {Fused->X0, Fused->Y0, Fused->X1, Fused->Y1};
+    Fused->HalfAngleSum += Fused->SumHalfAngles(Fused->BatchCount, Columns);
+    Fused->PairCount += Fused->BatchCount;
+    Fused->BatchCount = 0;
+}
+
+static void AddFusedPair(void *Context, haversine_pair Pair)
+{
+    fused_haversine *Fused = (fused_haversine *)Context;
+
+    u32 Index = Fused->BatchCount++;
+    Fused->X0[Index] = Pair.X0;
+    Fused->Y0[Index] = Pair.Y0;
+    Fused->X1[Index] = Pair.X1;
+    Fused->Y1[Index] = Pair.Y1;
+
+    if(Fused->BatchCount == FUSED_HAVERSINE_BATCH_PAIR_COUNT)
+    {
+        FlushFusedBatch(Fused);
+    }
+}
+
+static f64 EndFusedHaversine(fused_haversine *Fused)
+{
+    if(Fused->BatchCount)
+    {
+        FlushFusedBatch(Fused);
+    }
+
+    f64 Result = 0;
+    if(Fused->PairCount)
+    {
+        Result = (2.0*QUESTIONABLE_EARTH_RADIUS)*Fused->HalfAngleSum / (f64)Fused->PairCount;
+    }
+
+    return Result;
+}
+
+static f64 FusedSumHaversineJSON(buffer JSON, fused_haversine *Fused, haversine_half_angle_sum *SumHalfAngles, u64 *PairCount)
+{
+    // NOTE(casey): Returns 0 (and sets *PairCount to 0) if the JSON was not valid
+    BeginFusedHaversine(Fused, SumHalfAngles);
+
+    json_stream_parser Parser = BeginJSONStream(AddFusedPair, Fused);
+    PushJSONStream(&Parser, JSON);
+    b32 Valid = EndJSONStream(&Parser);
+
+    f64 Result = EndFusedHaversine(Fused);
+    *PairCount = Valid ? Fused->PairCount : 0;
+    if(!Valid)
+    {
+        Result = 0;
+    }
+
+    return Result;
+}
+
+static f64 FusedSumHaversineFile(FILE *Source, buffer ChunkBuffer, fused_haversine *Fused, haversine_half_angle_sum *SumHalfAngles, u64 *PairCount)
+{
+    // NOTE(casey): Memory use is ChunkBuffer plus one batch, no matter how large the file is
+    BeginFusedHaversine(Fused, SumHalfAngles);
+
+    *PairCount = StreamHaversinePairs(Source, ChunkBuffer, AddFusedPair, Fused);
+    f64 Result = EndFusedHaversine(Fused);
+    if(!*PairCount)
+    {
+        Result = 0;
+    }
+
+    return Result;
+}
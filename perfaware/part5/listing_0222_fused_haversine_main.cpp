@@ -0,0 +1,225 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 222
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+#include "listing_0207_streaming_json_parser.cpp"
+#include "listing_0221_fused_haversine.cpp"
+
+#define FUSED_TEST_CHUNK_SIZE (64*1024)
+
+struct materialized_pairs
+{
+    haversine_columns Columns;
+    u64 MaxPairCount;
+    u64 PairCount;
+};
+
+static void AddMaterializedPair(void *Context, haversine_pair Pair)
+{
+    // NOTE(casey): The two-pass way - every pair gets written out to the full columns first
+    materialized_pairs *Materialized = (materialized_pairs *)Context;
+    if(Materialized->PairCount < Materialized->MaxPairCount)
+    {
+        u64 Index = Materialized->PairCount++;
+        Materialized->Columns.X0[Index] = Pair.X0;
+        Materialized->Columns.Y0[Index] = Pair.Y0;
+        Materialized->Columns.X1[Index] = Pair.X1;
+        Materialized->Columns.Y1[Index] = Pair.Y1;
+    }
+}
+
+enum fused_test_source
+{
+    FusedSource_Memory,
+    FusedSource_File,
+
+    FusedSource_Count,
+};
+
+static char const *FusedSourceNames[FusedSource_Count] = {"Memory", "File"};
+
+struct fused_test
+{
+    fused_test_source Source;
+    char *FileName;
+    buffer JSON;
+    buffer ChunkBuffer;
+
+    haversine_half_angle_sum *SumHalfAngles;
+    materialized_pairs Materialized;
+    fused_haversine *Fused;
+};
+
+static f64 StreamThenSum(fused_test *Test, u64 *PairCount)
+{
+    materialized_pairs *Materialized = &Test->Materialized;
+    Materialized->PairCount = 0;
+
+    *PairCount = 0;
+    if(Test->Source == FusedSource_Memory)
+    {
+        json_stream_parser Parser = BeginJSONStream(AddMaterializedPair, Materialized);
+        PushJSONStream(&Parser, Test->JSON);
+        if(EndJSONStream(&Parser))
+        {
+            *PairCount = Parser.PairCount;
+        }
+    }
+    else
+    {
+        FILE *File = fopen(Test->FileName, "rb");
+        if(File)
+        {
+            *PairCount = StreamHaversinePairs(File, Test->ChunkBuffer, AddMaterializedPair, Materialized);
+            fclose(File);
+        }
+    }
+
+    f64 Result = 0;
+    if(*PairCount && (*PairCount == Materialized->PairCount))
+    {
+        Result = (2.0*QUESTIONABLE_EARTH_RADIUS)*Test->SumHalfAngles(Materialized->PairCount, Materialized->Columns) / (f64)Materialized->PairCount;
+    }
+
+    return Result;
+}
+
+static f64 FusedStreamAndSum(fused_test *Test, u64 *PairCount)
+{
+    f64 Result = 0;
+
+    *PairCount = 0;
+    if(Test->Source == FusedSource_Memory)
+    {
+        Result = FusedSumHaversineJSON(Test->JSON, Test->Fused, Test->SumHalfAngles, PairCount);
+    }
+    else
+    {
+        FILE *File = fopen(Test->FileName, "rb");
+        if(File)
+        {
+            Result = FusedSumHaversineFile(File, Test->ChunkBuffer, Test->Fused, Test->SumHalfAngles, PairCount);
+            fclose(File);
+        }
+    }
+
+    return Result;
+}
+
+typedef f64 fused_test_func(fused_test *Test, u64 *PairCount);
+
+struct fused_test_function
+{
+    char const *Name;
+    fused_test_func *Func;
+};
+static fused_test_function FusedTestFunctions[] =
+{
+    {"StreamThenSum", StreamThenSum},
+    {"FusedStreamAndSum", FusedStreamAndSum},
+};
+
+int main(int ArgCount, char **Args)
+{
+    haversine_setup Setup = {};
+    if(SetUpHaversineTest(ArgCount, Args, &Setup))
+    {
+        if(IsValid(Setup.JSONBuffer))
+        {
+            fused_test Test = {};
+            Test.FileName = Args[1];
+            Test.JSON = Setup.JSONBuffer;
+            Test.ChunkBuffer = AllocateBuffer(FUSED_TEST_CHUNK_SIZE);
+            Test.SumHalfAngles = CPUSupportsAVX512F() ? SumHaversineHalfAnglesAVX512 : SumHaversineHalfAnglesAVX2;
+            Test.Fused = (fused_haversine *)calloc(1, sizeof(fused_haversine));
+
+            u64 MaxPairCount = Setup.PairCount;
+            u64 ColumnStride = GetHaversineColumnStride(MaxPairCount);
+            buffer ColumnsBuffer = AllocateBuffer(HaversineColumn_Count*ColumnStride);
+            Test.Materialized.Columns = GetColumns(ColumnsBuffer.Data, ColumnStride);
+            Test.Materialized.MaxPairCount = MaxPairCount;
+
+            repetition_test_series TestSeries = AllocateTestSeries(ArrayCount(FusedTestFunctions), FusedSource_Count);
+            if(IsValid(Test.ChunkBuffer) && Test.Fused && IsValid(ColumnsBuffer) && IsValid(TestSeries))
+            {
+                fprintf(stdout, "Kernel: %s\n", (Test.SumHalfAngles == SumHaversineHalfAnglesAVX2) ? "AVX2" : "AVX-512");
+                fprintf(stdout, "Materialized columns: %llumb\n", ColumnsBuffer.Count / (1024*1024));
+                fprintf(stdout, "Fused batch: %llukb\n", (u64)sizeof(fused_haversine) / 1024);
+
+                SetRowLabelLabel(&TestSeries, "Source");
+                for(u32 SourceIndex = 0; SourceIndex < FusedSource_Count; ++SourceIndex)
+                {
+                    Test.Source = (fused_test_source)SourceIndex;
+                    SetRowLabel(&TestSeries, "%s", FusedSourceNames[SourceIndex]);
+
+                    for(u32 FunctionIndex = 0; FunctionIndex < ArrayCount(FusedTestFunctions); ++FunctionIndex)
+                    {
+                        fused_test_function Function = FusedTestFunctions[FunctionIndex];
+                        SetColumnLabel(&TestSeries, "%s", Function.Name);
+
+                        repetition_tester Tester = {};
+                        NewTestWave(&TestSeries, &Tester, Test.JSON.Count, GetCPUTimerFreq());
+
+                        u64 ErrorCount = 0;
+                        f64 Sum = 0;
+                        while(IsTesting(&TestSeries, &Tester))
+                        {
+                            u64 PairCount = 0;
+
+                            BeginTime(&Tester);
+                            Sum = Function.Func(&Test, &PairCount);
+                            CountBytes(&Tester, Test.JSON.Count);
+                            EndTime(&Tester);
+
+                            ErrorCount += ((PairCount != Setup.PairCount) || !ApproxAreEqual(Sum, Setup.SumAnswer));
+                        }
+
+                        fprintf(stdout, "Sum: %+32.24f (%+32.24f)\n\n", Sum, Sum - Setup.SumAnswer);
+                        if(ErrorCount)
+                        {
+                            fprintf(stderr, "WARNING: %llu pair count or sum mismatches\n", ErrorCount);
+                        }
+                    }
+                }
+
+                fprintf(stdout, "\nJSON GB/s:\n");
+                PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, 1.0);
+            }
+            else
+            {
+                fprintf(stderr, "ERROR: Unable to allocate test memory\n");
+            }
+
+            FreeTestSeries(&TestSeries);
+            FreeBuffer(&ColumnsBuffer);
+            FreeBuffer(&Test.ChunkBuffer);
+            free(Test.Fused);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: The fused test needs a JSON pair file\n");
+        }
+    }
+
+    FreeHaversine(&Setup);
+
+    (void)&CombinedHaversineTest;
+    (void)&AVX2Haversine;
+    (void)&AVX512Haversine;
+
+    return 0;
+}
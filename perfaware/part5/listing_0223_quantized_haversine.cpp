@@ -0,0 +1,354 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 223
+   ======================================================================== */
+
+/* NOTE(casey): Two compact encodings for the pair columns. Both decode to f64
+   right inside the kernel from listing 215, so the math is unchanged and only
+   the bytes read per pair go down.
+
+   Fixed32 - every coordinate is a signed 32-bit count of 2^-23 degrees. That
+   covers +/-256 degrees with a resolution of about 1.3cm on the ground, at 16
+   bytes per pair (half of f64).
+
+   Block16 - the pairs are cut into blocks, and each block stores a base and a
+   step for longitude and for latitude. Every coordinate is then an unsigned
+   16-bit count of steps from the base, so 8 bytes per pair (a quarter of f64).
+   The step depends on how spread out the block is. Clustered data from the
+   generator packs tightly; uniform data is spread over the whole globe and
+   loses a lot more.
+
+   Padding is free in both. Fixed32 pads with zeros, and Block16 pads with code
+   zero, which is the same point for both ends of the pair. Either way the pad
+   pairs have zero length, so the kernels never need a tail loop. */
+
+#define FIXED32_SCALE 8388608.0 // NOTE(casey): 2^23
+#define BLOCK16_PAIR_COUNT 1024
+#define BLOCK16_MAX_CODE 65535
+
+struct haversine_fixed32_columns
+{
+    s32 *X0;
+    s32 *Y0;
+    s32 *X1;
+    s32 *Y1;
+};
+
+struct haversine_block16
+{
+    f64 XBase, XStep;
+    f64 YBase, YStep;
+
+    u16 X0[BLOCK16_PAIR_COUNT];
+    u16 Y0[BLOCK16_PAIR_COUNT];
+    u16 X1[BLOCK16_PAIR_COUNT];
+    u16 Y1[BLOCK16_PAIR_COUNT];
+};
+
+struct haversine_quantized
+{
+    u64 PairCount;
+
+    buffer Fixed32Buffer;
+    u64 Fixed32PaddedCount;
+    haversine_fixed32_columns Fixed32;
+
+    buffer Block16Buffer;
+    u64 Block16Count;
+    haversine_block16 *Blocks16;
+};
+
+//
+// NOTE(casey): Encoding
+//
+
+inline s32 EncodeFixed32(f64 Degrees)
+{
+    s32 Result = (s32)floor(Degrees*FIXED32_SCALE + 0.5);
+    return Result;
+}
+
+inline f64 DecodeFixed32(s32 Code)
+{
+    f64 Result = (f64)Code*(1.0 / FIXED32_SCALE);
+    return Result;
+}
+
+inline u16 EncodeBlock16(f64 Value, f64 Base, f64 Step)
+{
+    f64 Code = Step ? floor((Value - Base)/Step + 0.5) : 0;
+    if(Code < 0) {Code = 0;}
+    if(Code > BLOCK16_MAX_CODE) {Code = BLOCK16_MAX_CODE;}
+
+    u16 Result = (u16)Code;
+    return Result;
+}
+
+inline f64 DecodeBlock16(u16 Code, f64 Base, f64 Step)
+{
+    f64 Result = fma((f64)Code, Step, Base);
+    return Result;
+}
+
+static void GetBlock16Range(f64 *A, f64 *B, u64 Count, f64 *Base, f64 *Step)
+{
+    f64 Min = A[0];
+    f64 Max = A[0];
+    for(u64 Index = 0; Index < Count; ++Index)
+    {
+        if(Min > A[Index]) {Min = A[Index];}
+        if(Max < A[Index]) {Max = A[Index];}
+        if(Min > B[Index]) {Min = B[Index];}
+        if(Max < B[Index]) {Max = B[Index];}
+    }
+
+    *Base = Min;
+    *Step = (Max - Min) / BLOCK16_MAX_CODE;
+}
+
+static b32 BuildQuantizedHaversine(haversine_setup Setup, haversine_quantized *Quantized)
+{
+    *Quantized = {};
+    Quantized->PairCount = Setup.PairCount;
+
+    haversine_columns Columns = Setup.Columns;
+
+    // NOTE(casey): Padded to a multiple of 16 pairs, so both kernels always load whole vectors
+    u64 PaddedCount = (Setup.PairCount + 15) & ~15ull;
+    u64 ColumnStride = PaddedCount*sizeof(s32);
+    Quantized->Fixed32Buffer = AllocateBuffer(HaversineColumn_Count*ColumnStride);
+    if(IsValid(Quantized->Fixed32Buffer))
+    {
+        // NOTE(casey): AllocateBuffer memory comes back zeroed, which is the padding
+        u8 *Base = Quantized->Fixed32Buffer.Data;
+        haversine_fixed32_columns Fixed32 = {};
+        Fixed32.X0 = (s32 *)(Base + HaversineColumn_X0*ColumnStride);
+        Fixed32.Y0 = (s32 *)(Base + HaversineColumn_Y0*ColumnStride);
+        Fixed32.X1 = (s32 *)(Base + HaversineColumn_X1*ColumnStride);
+        Fixed32.Y1 = (s32 *)(Base + HaversineColumn_Y1*ColumnStride);
+
+        for(u64 PairIndex = 0; PairIndex < Setup.PairCount; ++PairIndex)
+        {
+            Fixed32.X0[PairIndex] = EncodeFixed32(Columns.X0[PairIndex]);
+            Fixed32.Y0[PairIndex] = EncodeFixed32(Columns.Y0[PairIndex]);
+            Fixed32.X1[PairIndex] = EncodeFixed32(Columns.X1[PairIndex]);
+            Fixed32.Y1[PairIndex] = EncodeFixed32(Columns.Y1[PairIndex]);
+        }
+
+        Quantized->Fixed32PaddedCount = PaddedCount;
+        Quantized->Fixed32 = Fixed32;
+    }
+
+    u64 BlockCount = (Setup.PairCount + BLOCK16_PAIR_COUNT - 1) / BLOCK16_PAIR_COUNT;
+    Quantized->Block16Buffer = AllocateBuffer(BlockCount*sizeof(haversine_block16));
+    if(IsValid(Quantized->Block16Buffer))
+    {
+        haversine_block16 *Blocks = (haversine_block16 *)Quantized->Block16Buffer.Data;
+        for(u64 BlockIndex = 0; BlockIndex < BlockCount; ++BlockIndex)
+        {
+            haversine_block16 *Block = Blocks + BlockIndex;
+
+            u64 First = BlockIndex*BLOCK16_PAIR_COUNT;
+            u64 Count = Setup.PairCount - First;
+            if(Count > BLOCK16_PAIR_COUNT)
+            {
+                Count = BLOCK16_PAIR_COUNT;
+            }
+
+            GetBlock16Range(Columns.X0 + First, Columns.X1 + First, Count, &Block->XBase, &Block->XStep);
+            GetBlock16Range(Columns.Y0 + First, Columns.Y1 + First, Count, &Block->YBase, &Block->YStep);
+            for(u64 Index = 0; Index < Count; ++Index)
+            {
+                Block->X0[Index] = EncodeBlock16(Columns.X0[First + Index], Block->XBase, Block->XStep);
+                Block->Y0[Index] = EncodeBlock16(Columns.Y0[First + Index], Block->YBase, Block->YStep);
+                Block->X1[Index] = EncodeBlock16(Columns.X1[First + Index], Block->XBase, Block->XStep);
+                Block->Y1[Index] = EncodeBlock16(Columns.Y1[First + Index], Block->YBase, Block->YStep);
+            }
+        }
+
+        Quantized->Block16Count = BlockCount;
+        Quantized->Blocks16 = Blocks;
+    }
+
+    b32 Result = (Quantized->Fixed32.X0 && Quantized->Blocks16);
+    return Result;
+}
+
+static void FreeQuantizedHaversine(haversine_quantized *Quantized)
+{
+    FreeBuffer(&Quantized->Fixed32Buffer);
+    FreeBuffer(&Quantized->Block16Buffer);
+    *Quantized = {};
+}
+
+static haversine_pair GetQuantizedPairFixed32(haversine_quantized *Quantized, u64 PairIndex)
+{
+    haversine_fixed32_columns Fixed32 = Quantized->Fixed32;
+
+    haversine_pair Result;
+    Result.X0 = DecodeFixed32(Fixed32.X0[PairIndex]);
+    Result.Y0 = DecodeFixed32(Fixed32.Y0[PairIndex]);
+    Result.X1 = DecodeFixed32(Fixed32.X1[PairIndex]);
+    Result.Y1 = DecodeFixed32(Fixed32.Y1[PairIndex]);
+    return Result;
+}
+
+static haversine_pair GetQuantizedPairBlock16(haversine_quantized *Quantized, u64 PairIndex)
+{
+    haversine_block16 *Block = Quantized->Blocks16 + (PairIndex / BLOCK16_PAIR_COUNT);
+    u64 Index = PairIndex % BLOCK16_PAIR_COUNT;
+
+    haversine_pair Result;
+    Result.X0 = DecodeBlock16(Block->X0[Index], Block->XBase, Block->XStep);
+    Result.Y0 = DecodeBlock16(Block->Y0[Index], Block->YBase, Block->YStep);
+    Result.X1 = DecodeBlock16(Block->X1[Index], Block->XBase, Block->XStep);
+    Result.Y1 = DecodeBlock16(Block->Y1[Index], Block->YBase, Block->YStep);
+    return Result;
+}
+
+//
+// NOTE(casey): AVX2
+//
+
+inline __m256d LoadFixed32x4(s32 *Source, __m256d Scale)
+{
+    __m256d Result = _mm256_mul_pd(_mm256_cvtepi32_pd(_mm_loadu_si128((__m128i *)Source)), Scale);
+    return Result;
+}
+
+static f64 SumHaversineHalfAnglesFixed32AVX2(u64 PaddedCount, haversine_fixed32_columns Columns)
+{
+    __m256d Scale = _mm256_set1_pd(1.0 / FIXED32_SCALE);
+    __m256d Sum0 = _mm256_setzero_pd();
+    __m256d Sum1 = _mm256_setzero_pd();
+
+    for(u64 PairIndex = 0; PairIndex < PaddedCount; PairIndex += 8)
+    {
+        __m256d R0 = HaversineHalfAngle4(LoadFixed32x4(Columns.X0 + PairIndex, Scale), LoadFixed32x4(Columns.Y0 + PairIndex, Scale),
+                                         LoadFixed32x4(Columns.X1 + PairIndex, Scale), LoadFixed32x4(Columns.Y1 + PairIndex, Scale));
+        __m256d R1 = HaversineHalfAngle4(LoadFixed32x4(Columns.X0 + PairIndex + 4, Scale), LoadFixed32x4(Columns.Y0 + PairIndex + 4, Scale),
+                                         LoadFixed32x4(Columns.X1 + PairIndex + 4, Scale), LoadFixed32x4(Columns.Y1 + PairIndex + 4, Scale));
+        Sum0 = _mm256_add_pd(Sum0, R0);
+        Sum1 = _mm256_add_pd(Sum1, R1);
+    }
+
+    __m256d Sum = _mm256_add_pd(Sum0, Sum1);
+    __m128d Sum2 = _mm_add_pd(_mm256_castpd256_pd128(Sum), _mm256_extractf128_pd(Sum, 1));
+    f64 Result = _mm_cvtsd_f64(_mm_add_sd(Sum2, _mm_unpackhi_pd(Sum2, Sum2)));
+
+    return Result;
+}
+
+inline __m256d LoadBlock16x4(u16 *Source, __m256d Base, __m256d Step)
+{
+    __m128i Codes = _mm_cvtepu16_epi32(_mm_loadl_epi64((__m128i *)Source));
+    __m256d Result = _mm256_fmadd_pd(_mm256_cvtepi32_pd(Codes), Step, Base);
+    return Result;
+}
+
+static f64 SumHaversineHalfAnglesBlock16AVX2(u64 BlockCount, haversine_block16 *Blocks)
+{
+    __m256d Sum0 = _mm256_setzero_pd();
+    __m256d Sum1 = _mm256_setzero_pd();
+
+    for(u64 BlockIndex = 0; BlockIndex < BlockCount; ++BlockIndex)
+    {
+        haversine_block16 *Block = Blocks + BlockIndex;
+        __m256d XBase = _mm256_set1_pd(Block->XBase);
+        __m256d XStep = _mm256_set1_pd(Block->XStep);
+        __m256d YBase = _mm256_set1_pd(Block->YBase);
+        __m256d YStep = _mm256_set1_pd(Block->YStep);
+
+        for(u32 Index = 0; Index < BLOCK16_PAIR_COUNT; Index += 8)
+        {
+            __m256d R0 = HaversineHalfAngle4(LoadBlock16x4(Block->X0 + Index, XBase, XStep), LoadBlock16x4(Block->Y0 + Index, YBase, YStep),
+                                             LoadBlock16x4(Block->X1 + Index, XBase, XStep), LoadBlock16x4(Block->Y1 + Index, YBase, YStep));
+            __m256d R1 = HaversineHalfAngle4(LoadBlock16x4(Block->X0 + Index + 4, XBase, XStep), LoadBlock16x4(Block->Y0 + Index + 4, YBase, YStep),
+                                             LoadBlock16x4(Block->X1 + Index + 4, XBase, XStep), LoadBlock16x4(Block->Y1 + Index + 4, YBase, YStep));
+            Sum0 = _mm256_add_pd(Sum0, R0);
+            Sum1 = _mm256_add_pd(Sum1, R1);
+        }
+    }
+
+    __m256d Sum = _mm256_add_pd(Sum0, Sum1);
+    __m128d Sum2 = _mm_add_pd(_mm256_castpd256_pd128(Sum), _mm256_extractf128_pd(Sum, 1));
+    f64 Result = _mm_cvtsd_f64(_mm_add_sd(Sum2, _mm_unpackhi_pd(Sum2, Sum2)));
+
+    return Result;
+}
+
+//
+// NOTE(casey): AVX-512
+//
+
+AVX512_FUNCTION inline __m512d LoadFixed32x8(s32 *Source, __m512d Scale)
+{
+    __m512d Result = _mm512_mul_pd(_mm512_cvtepi32_pd(_mm256_loadu_si256((__m256i *)Source)), Scale);
+    return Result;
+}
+
+AVX512_FUNCTION static f64 SumHaversineHalfAnglesFixed32AVX512(u64 PaddedCount, haversine_fixed32_columns Columns)
+{
+    __m512d Scale = _mm512_set1_pd(1.0 / FIXED32_SCALE);
+    __m512d Sum0 = _mm512_setzero_pd();
+    __m512d Sum1 = _mm512_setzero_pd();
+
+    for(u64 PairIndex = 0; PairIndex < PaddedCount; PairIndex += 16)
+    {
+        __m512d R0 = HaversineHalfAngle8(LoadFixed32x8(Columns.X0 + PairIndex, Scale), LoadFixed32x8(Columns.Y0 + PairIndex, Scale),
+                                         LoadFixed32x8(Columns.X1 + PairIndex, Scale), LoadFixed32x8(Columns.Y1 + PairIndex, Scale));
+        __m512d R1 = HaversineHalfAngle8(LoadFixed32x8(Columns.X0 + PairIndex + 8, Scale), LoadFixed32x8(Columns.Y0 + PairIndex + 8, Scale),
+                                         LoadFixed32x8(Columns.X1 + PairIndex + 8, Scale), LoadFixed32x8(Columns.Y1 + PairIndex + 8, Scale));
+        Sum0 = _mm512_add_pd(Sum0, R0);
+        Sum1 = _mm512_add_pd(Sum1, R1);
+    }
+
+    f64 Result = _mm512_reduce_add_pd(_mm512_add_pd(Sum0, Sum1));
+    return Result;
+}
+
+AVX512_FUNCTION inline __m512d LoadBlock16x8(u16 *Source, __m512d Base, __m512d Step)
+{
+    __m256i Codes = _mm256_cvtepu16_epi32(_mm_loadu_si128((__m128i *)Source));
+    __m512d Result = _mm512_fmadd_pd(_mm512_cvtepi32_pd(Codes), Step, Base);
+    return Result;
+}
+
+AVX512_FUNCTION static f64 SumHaversineHalfAnglesBlock16AVX512(u64 BlockCount, haversine_block16 *Blocks)
+{
+    __m512d Sum0 = _mm512_setzero_pd();
+    __m512d Sum1 = _mm512_setzero_pd();
+
+    for(u64 BlockIndex = 0; BlockIndex < BlockCount; ++BlockIndex)
+    {
+        haversine_block16 *Block = Blocks + BlockIndex;
+        __m512d XBase = _mm512_set1_pd(Block->XBase);
+        __m512d XStep = _mm512_set1_pd(Block->XStep);
+        __m512d YBase = _mm512_set1_pd(Block->YBase);
+        __m512d YStep = _mm512_set1_pd(Block->YStep);
+
+        for(u32 Index = 0; Index < BLOCK16_PAIR_COUNT; Index += 16)
+        {
+            __m512d R0 = HaversineHalfAngle8(LoadBlock16x8(Block->X0 + Index, XBase, XStep), LoadBlock16x8(Block->Y0 + Index, YBase, YStep),
+                                             LoadBlock16x8(Block->X1 + Index, XBase, XStep), LoadBlock16x8(Block->Y1 + Index, YBase, YStep));
+            __m512d R1 = HaversineHalfAngle8(LoadBlock16x8(Block->X0 + Index + 8, XBase, XStep), LoadBlock16x8(Block->Y0 + Index + 8, YBase, YStep),
+                                             LoadBlock16x8(Block->X1 + Index + 8, XBase, XStep), LoadBlock16x8(Block->Y1 + Index + 8, YBase, YStep));
+            Sum0 = _mm512_add_pd(Sum0, R0);
+            Sum1 = _mm512_add_pd(Sum1, R1);
+        }
+    }
+
+    f64 Result = _mm512_reduce_add_pd(_mm512_add_pd(Sum0, Sum1));
+    return Result;
+}
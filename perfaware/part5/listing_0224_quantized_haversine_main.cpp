@@ -0,0 +1,151 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 224
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+#include "listing_0223_quantized_haversine.cpp"
+
+#define FIXED32_TOLERANCE 0.000001 // NOTE(casey): 1mm on the average distance
+#define BLOCK16_TOLERANCE 0.01 // NOTE(casey): 10m on the average distance, but this one depends heavily on the data
+
+/* NOTE(casey): The compute functions only get a haversine_setup, so the encoded
+   pairs are built once up front and kept here. The GB/s numbers are still in
+   terms of the f64 pairs, so they compare directly with the f64 kernels - the
+   actual bytes read per pair are printed separately. */
+static haversine_quantized GlobalQuantized;
+
+static f64 AVX2HaversineFixed32(haversine_setup Setup)
+{
+    f64 HalfAngleSum = SumHaversineHalfAnglesFixed32AVX2(GlobalQuantized.Fixed32PaddedCount, GlobalQuantized.Fixed32);
+    f64 Result = (2.0*QUESTIONABLE_EARTH_RADIUS)*HalfAngleSum / (f64)Setup.PairCount;
+    return Result;
+}
+
+static f64 AVX2HaversineBlock16(haversine_setup Setup)
+{
+    f64 HalfAngleSum = SumHaversineHalfAnglesBlock16AVX2(GlobalQuantized.Block16Count, GlobalQuantized.Blocks16);
+    f64 Result = (2.0*QUESTIONABLE_EARTH_RADIUS)*HalfAngleSum / (f64)Setup.PairCount;
+    return Result;
+}
+
+AVX512_FUNCTION static f64 AVX512HaversineFixed32(haversine_setup Setup)
+{
+    f64 HalfAngleSum = SumHaversineHalfAnglesFixed32AVX512(GlobalQuantized.Fixed32PaddedCount, GlobalQuantized.Fixed32);
+    f64 Result = (2.0*QUESTIONABLE_EARTH_RADIUS)*HalfAngleSum / (f64)Setup.PairCount;
+    return Result;
+}
+
+AVX512_FUNCTION static f64 AVX512HaversineBlock16(haversine_setup Setup)
+{
+    f64 HalfAngleSum = SumHaversineHalfAnglesBlock16AVX512(GlobalQuantized.Block16Count, GlobalQuantized.Blocks16);
+    f64 Result = (2.0*QUESTIONABLE_EARTH_RADIUS)*HalfAngleSum / (f64)Setup.PairCount;
+    return Result;
+}
+
+static test_function TestFunctions[] =
+{
+    {"ReferenceHaversineColumns", ReferenceSumHaversineColumns},
+    {"AVX2Haversine", AVX2Haversine},
+    {"AVX2HaversineFixed32", AVX2HaversineFixed32, FIXED32_TOLERANCE},
+    {"AVX2HaversineBlock16", AVX2HaversineBlock16, BLOCK16_TOLERANCE},
+
+    // NOTE(casey): These must stay last, so they can be left off on CPUs that don't have AVX-512
+    {"AVX512Haversine", AVX512Haversine},
+    {"AVX512HaversineFixed32", AVX512HaversineFixed32, FIXED32_TOLERANCE},
+    {"AVX512HaversineBlock16", AVX512HaversineBlock16, BLOCK16_TOLERANCE},
+};
+
+static void TestQuantizationError(haversine_setup Setup, haversine_quantized *Quantized)
+{
+    /* NOTE(casey): Per-pair error of the decoded coordinates against the answer
+       file, both in degrees and in km of haversine distance. The kernels add no
+       error of their own beyond what listing 215 already has, so this is all
+       down to the encoding. */
+
+    math_tester Tester = {};
+
+    haversine_columns Columns = Setup.Columns;
+    while(PrecisionTest(&Tester, 0, (f64)(Setup.PairCount - 1), (u32)Setup.PairCount))
+    {
+        u64 PairIndex = (u64)(Tester.InputValue + 0.5);
+        f64 Expected = Setup.Answers[PairIndex];
+
+        haversine_pair Fixed32 = GetQuantizedPairFixed32(Quantized, PairIndex);
+        TestResult(&Tester, Columns.X0[PairIndex], Fixed32.X0, "Fixed32 X0 (degrees)");
+        TestResult(&Tester, Columns.Y0[PairIndex], Fixed32.Y0, "Fixed32 Y0 (degrees)");
+        TestResult(&Tester, Expected, ReferenceHaversine(Fixed32.X0, Fixed32.Y0, Fixed32.X1, Fixed32.Y1, QUESTIONABLE_EARTH_RADIUS),
+                   "Fixed32 (km, by pair index)");
+
+        haversine_pair Block16 = GetQuantizedPairBlock16(Quantized, PairIndex);
+        TestResult(&Tester, Columns.X0[PairIndex], Block16.X0, "Block16 X0 (degrees)");
+        TestResult(&Tester, Columns.Y0[PairIndex], Block16.Y0, "Block16 Y0 (degrees)");
+        TestResult(&Tester, Expected, ReferenceHaversine(Block16.X0, Block16.Y0, Block16.X1, Block16.Y1, QUESTIONABLE_EARTH_RADIUS),
+                   "Block16 (km, by pair index)");
+    }
+
+    PrintResults(&Tester);
+}
+
+int main(int ArgCount, char **Args)
+{
+    u32 TestFunctionCount = ArrayCount(TestFunctions);
+    if(!CPUSupportsAVX512F())
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so the AVX-512 kernels will not be tested.\n");
+        TestFunctionCount -= 3;
+    }
+
+    haversine_setup Setup = {};
+    if(SetUpHaversineTest(ArgCount, Args, &Setup))
+    {
+        if(BuildQuantizedHaversine(Setup, &GlobalQuantized))
+        {
+            TestQuantizationError(Setup, &GlobalQuantized);
+
+            f64 PairCount = (f64)Setup.PairCount;
+            fprintf(stdout, "\nBytes per pair:\n");
+            fprintf(stdout, "  f64:     %.2f\n", (f64)sizeof(haversine_pair));
+            fprintf(stdout, "  Fixed32: %.2f\n", (f64)(GlobalQuantized.Fixed32PaddedCount*4*sizeof(s32)) / PairCount);
+            fprintf(stdout, "  Block16: %.2f\n", (f64)(GlobalQuantized.Block16Count*sizeof(haversine_block16)) / PairCount);
+            fprintf(stdout, "Error budget: %f km (Fixed32), %f km (Block16) on the average distance\n\n",
+                    FIXED32_TOLERANCE, BLOCK16_TOLERANCE);
+
+            repetition_test_series TestSeries = AllocateTestSeries(TestFunctionCount, 1);
+            if(IsValid(TestSeries))
+            {
+                SetRowLabelLabel(&TestSeries, "Test");
+                SetRowLabel(&TestSeries, "Haversine");
+                RunHaversineTestRow(&TestSeries, Setup, TestFunctionCount, TestFunctions);
+
+                PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, 1.0);
+            }
+
+            FreeTestSeries(&TestSeries);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Unable to allocate quantized columns\n");
+        }
+
+        FreeQuantizedHaversine(&GlobalQuantized);
+    }
+
+    FreeHaversine(&Setup);
+
+    (void)&CombinedHaversineTest;
+
+    return 0;
+}
@@ -0,0 +1,224 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 225
+   ======================================================================== */
+
+/* NOTE(casey): ReferenceVerifyHaversine wants the whole answer file in memory
+   and runs libm on every pair, so on a big data set it takes longer than the
+   generator did. This verifier instead maps the answer file one window at a
+   time and hands each window to the thread pool from listing 217, which checks
+   it block by block with the SIMD kernel from listing 215.
+
+   Each block keeps its own mismatch count and its first few mismatches. Once a
+   window is done, the blocks are merged in order and any new mismatches are
+   printed right away - so the report is always the first N by pair index, no
+   matter which threads did what, and it starts long before the run finishes.
+
+   The per-block distance sums also go through the same fixed pairwise
+   reduction as ParallelSumHaversine, so the sum check at the end is
+   reproducible too. */
+
+#define VERIFY_MAX_REPORTED_MISMATCHES 16
+#define VERIFY_WINDOW_BLOCK_COUNT 64 // NOTE(casey): 64 blocks * 16k pairs * 8 bytes = 8mb of answers mapped at a time
+#define VERIFY_BATCH_PAIR_COUNT 256
+
+struct haversine_mismatch
+{
+    u64 PairIndex;
+    f64 Expected;
+    f64 Computed;
+};
+
+struct haversine_verify_block
+{
+    u64 MismatchCount;
+    u32 ReportedCount;
+    haversine_mismatch Reported[VERIFY_MAX_REPORTED_MISMATCHES];
+};
+
+struct haversine_verifier
+{
+    haversine_distance_func *ComputeDistances;
+    u32 MaxReportedCount;
+
+    // NOTE(casey): Per-window state, written by the calling thread before the pool runs
+    u64 WindowFirstPair;
+    u64 WindowFirstBlock;
+    haversine_verify_block *Blocks;
+    f64 *BlockSums; // NOTE(casey): One per block of the whole data set, not just the window
+
+    // NOTE(casey): Results
+    b32 Valid;
+    u64 PairCount;
+    u64 MismatchCount;
+    u32 ReportedCount;
+    haversine_mismatch Reported[VERIFY_MAX_REPORTED_MISMATCHES];
+    f64 Sum;
+    f64 SumAnswer;
+    b32 SumMatches;
+};
+
+//
+// NOTE(casey): Verification
+//
+
+static void AddMismatch(haversine_mismatch *Reported, u32 *ReportedCount, u32 MaxReportedCount, haversine_mismatch Mismatch)
+{
+    if(*ReportedCount < MaxReportedCount)
+    {
+        Reported[(*ReportedCount)++] = Mismatch;
+    }
+}
+
+static void VerifyHaversineBlock(void *Context, haversine_setup Block, u64 BlockIndex)
+{
+    haversine_verifier *Verifier = (haversine_verifier *)Context;
+    haversine_verify_block *Result = Verifier->Blocks + BlockIndex;
+    u64 FirstPair = Verifier->WindowFirstPair + BlockIndex*PARALLEL_HAVERSINE_BLOCK_PAIR_COUNT;
+
+    Result->MismatchCount = 0;
+    Result->ReportedCount = 0;
+
+    f64 Sum = 0;
+    f64 Distances[VERIFY_BATCH_PAIR_COUNT];
+    for(u64 BatchFirst = 0; BatchFirst < Block.PairCount; BatchFirst += VERIFY_BATCH_PAIR_COUNT)
+    {
+        u64 BatchCount = Block.PairCount - BatchFirst;
+        if(BatchCount > VERIFY_BATCH_PAIR_COUNT)
+        {
+            BatchCount = VERIFY_BATCH_PAIR_COUNT;
+        }
+
+        Verifier->ComputeDistances(BatchCount, GetHaversineRange(Block, BatchFirst, BatchCount).Columns, Distances);
+
+        f64 *Answers = Block.Answers + BatchFirst;
+        for(u64 Index = 0; Index < BatchCount; ++Index)
+        {
+            f64 Dist = Distances[Index];
+            Sum += Dist;
+            if(!ApproxAreEqual(Dist, Answers[Index]))
+            {
+                ++Result->MismatchCount;
+                AddMismatch(Result->Reported, &Result->ReportedCount, Verifier->MaxReportedCount,
+                            {FirstPair + BatchFirst + Index, Answers[Index], Dist});
+            }
+        }
+    }
+
+    Verifier->BlockSums[Verifier->WindowFirstBlock + BlockIndex] = Sum;
+}
+
+static void PrintMismatch(FILE *Dest, haversine_mismatch Mismatch)
+{
+    fprintf(Dest, "MISMATCH: Pair %llu: expected %.16f, computed %.16f (%+.16f)\n",
+            Mismatch.PairIndex, Mismatch.Expected, Mismatch.Computed, Mismatch.Computed - Mismatch.Expected);
+}
+
+static haversine_verifier StreamingVerifyHaversine(haversine_thread_pool *Pool, haversine_setup Setup, char *AnswerFileName,
+                                                   haversine_distance_func *ComputeDistances, u32 MaxReportedCount)
+{
+    /* NOTE(casey): Only Setup.Columns is used, so Setup can come from
+       SetUpHaversine with no answer file at all. The answers always come from
+       AnswerFileName, a window at a time. */
+
+    haversine_verifier Verifier = {};
+    Verifier.ComputeDistances = ComputeDistances;
+    Verifier.MaxReportedCount = (MaxReportedCount < VERIFY_MAX_REPORTED_MISMATCHES) ? MaxReportedCount : VERIFY_MAX_REPORTED_MISMATCHES;
+    Verifier.PairCount = Setup.PairCount;
+
+    u64 AnswerFileSize = GetFileSize(AnswerFileName);
+    u64 ExpectedFileSize = (Setup.PairCount + 1)*sizeof(f64);
+    memory_mapped_file AnswerFile = OpenMemoryMappedFile(AnswerFileName);
+
+    u64 BlockCount = GetHaversineBlockCount(Setup.PairCount);
+    buffer BlocksBuffer = AllocateBuffer(VERIFY_WINDOW_BLOCK_COUNT*sizeof(haversine_verify_block));
+    buffer SumsBuffer = AllocateBuffer(BlockCount*sizeof(f64));
+
+    if(!IsValid(AnswerFile))
+    {
+        fprintf(stderr, "ERROR: Unable to open \"%s\".\n", AnswerFileName);
+    }
+    else if(AnswerFileSize != ExpectedFileSize)
+    {
+        fprintf(stderr, "ERROR: \"%s\" is %llu bytes, but %llu pairs need %llu.\n",
+                AnswerFileName, AnswerFileSize, Setup.PairCount, ExpectedFileSize);
+    }
+    else if(BlockCount && IsValid(BlocksBuffer) && IsValid(SumsBuffer))
+    {
+        Verifier.Valid = true;
+        Verifier.Blocks = (haversine_verify_block *)BlocksBuffer.Data;
+        Verifier.BlockSums = (f64 *)SumsBuffer.Data;
+
+        u64 WindowPairCountMax = VERIFY_WINDOW_BLOCK_COUNT*PARALLEL_HAVERSINE_BLOCK_PAIR_COUNT;
+        for(u64 FirstPair = 0; FirstPair < Setup.PairCount; FirstPair += WindowPairCountMax)
+        {
+            u64 WindowPairCount = Setup.PairCount - FirstPair;
+            if(WindowPairCount > WindowPairCountMax)
+            {
+                WindowPairCount = WindowPairCountMax;
+            }
+
+            // NOTE(casey): Windows start on 8mb boundaries, which satisfies every OS's mapping granularity.
+            // The last window also maps the sum that follows the per-pair answers.
+            b32 LastWindow = ((FirstPair + WindowPairCount) == Setup.PairCount);
+            u64 MapSize = (WindowPairCount + (LastWindow ? 1 : 0))*sizeof(f64);
+            SetMapRegion(&AnswerFile, FirstPair*sizeof(f64), MapSize);
+            if(!IsValid(AnswerFile.Memory))
+            {
+                fprintf(stderr, "ERROR: Unable to map \"%s\" at pair %llu.\n", AnswerFileName, FirstPair);
+                Verifier.Valid = false;
+                break;
+            }
+
+            haversine_setup Window = GetHaversineRange(Setup, FirstPair, WindowPairCount);
+            Window.Answers = (f64 *)AnswerFile.Memory.Data;
+
+            Verifier.WindowFirstPair = FirstPair;
+            Verifier.WindowFirstBlock = FirstPair / PARALLEL_HAVERSINE_BLOCK_PAIR_COUNT;
+            RunHaversineBlocks(Pool, Window, VerifyHaversineBlock, &Verifier);
+
+            u64 WindowBlockCount = GetHaversineBlockCount(WindowPairCount);
+            for(u64 BlockIndex = 0; BlockIndex < WindowBlockCount; ++BlockIndex)
+            {
+                haversine_verify_block *Block = Verifier.Blocks + BlockIndex;
+                Verifier.MismatchCount += Block->MismatchCount;
+                for(u32 ReportedIndex = 0; ReportedIndex < Block->ReportedCount; ++ReportedIndex)
+                {
+                    if(Verifier.ReportedCount < Verifier.MaxReportedCount)
+                    {
+                        PrintMismatch(stdout, Block->Reported[ReportedIndex]);
+                    }
+                    AddMismatch(Verifier.Reported, &Verifier.ReportedCount, Verifier.MaxReportedCount, Block->Reported[ReportedIndex]);
+                }
+            }
+
+            if(LastWindow)
+            {
+                Verifier.SumAnswer = Window.Answers[WindowPairCount];
+            }
+        }
+
+        if(Verifier.Valid)
+        {
+            Verifier.Sum = ReducePairwise(BlockCount, Verifier.BlockSums) / (f64)Setup.PairCount;
+            Verifier.SumMatches = ApproxAreEqual(Verifier.Sum, Verifier.SumAnswer);
+        }
+    }
+
+    FreeBuffer(&SumsBuffer);
+    FreeBuffer(&BlocksBuffer);
+    CloseMemoryMappedFile(&AnswerFile);
+
+    return Verifier;
+}
@@ -0,0 +1,103 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 226
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+#include "listing_0217_parallel_haversine.cpp"
+#include "listing_0225_streaming_verify.cpp"
+
+#define REFERENCE_VERIFY_MAX_PAIR_COUNT (16*1024*1024) // NOTE(casey): Past this, the libm comparison takes too long to be worth waiting for
+
+int main(int ArgCount, char **Args)
+{
+    if((ArgCount != 3) && (ArgCount != 4))
+    {
+        fprintf(stderr, "Usage: %s [haversine JSON or binary file] [haversine answer file] [max mismatches to report]\n", Args[0]);
+        return 1;
+    }
+
+    InitializeOSPlatform();
+
+    u32 MaxReportedCount = (ArgCount == 4) ? (u32)atoi(Args[3]) : VERIFY_MAX_REPORTED_MISMATCHES;
+    haversine_distance_func *ComputeDistances = ComputeHaversineDistancesAVX2;
+    if(CPUSupportsAVX512F())
+    {
+        ComputeDistances = ComputeHaversineDistancesAVX512;
+    }
+
+    // NOTE(casey): Only the pairs are loaded up front. The verifier maps the answer file a window at a time on its own.
+    haversine_setup Setup = SetUpHaversine(Args[1], 0);
+    haversine_thread_pool *Pool = (haversine_thread_pool *)calloc(1, sizeof(haversine_thread_pool));
+    if(IsValid(Setup) && Pool && StartHaversineThreadPool(Pool, GetCPUCoreCount()))
+    {
+        u64 CPUFreq = GetCPUTimerFreq();
+        fprintf(stdout, "\nStreaming verify (%s, %u threads):\n",
+                (ComputeDistances == ComputeHaversineDistancesAVX2) ? "AVX2" : "AVX-512", Pool->ActiveThreadCount);
+
+        u64 StartTime = ReadCPUTimer();
+        haversine_verifier Verifier = StreamingVerifyHaversine(Pool, Setup, Args[2], ComputeDistances, MaxReportedCount);
+        u64 EndTime = ReadCPUTimer();
+
+        if(Verifier.Valid)
+        {
+            f64 Seconds = (f64)(EndTime - StartTime) / (f64)CPUFreq;
+            fprintf(stdout, "Mismatches: %llu of %llu pairs", Verifier.MismatchCount, Verifier.PairCount);
+            if(Verifier.MismatchCount > Verifier.ReportedCount)
+            {
+                fprintf(stdout, " (first %u shown)", Verifier.ReportedCount);
+            }
+            fprintf(stdout, "\nSum: %.16f, answer %.16f (%s)\n", Verifier.Sum, Verifier.SumAnswer, Verifier.SumMatches ? "matches" : "MISMATCH");
+            fprintf(stdout, "Time: %.4fs (%.2f million pairs/s)\n", Seconds, (f64)Verifier.PairCount / (1000000.0*Seconds));
+        }
+
+        if(Setup.PairCount > REFERENCE_VERIFY_MAX_PAIR_COUNT)
+        {
+            fprintf(stdout, "\nSkipping ReferenceVerifyHaversine for more than %u pairs.\n", REFERENCE_VERIFY_MAX_PAIR_COUNT);
+        }
+        else if(Verifier.Valid)
+        {
+            // NOTE(casey): The libm comparison is the one thing here that wants every answer in memory at once, so it loads them itself.
+            // The streaming verifier has already checked that the answer file is the right size.
+            Setup.AnswerBuffer = ReadEntireFile(Args[2]);
+            if(IsValid(Setup.AnswerBuffer) && BuildPairsFromColumns(&Setup))
+            {
+                Setup.Answers = (f64 *)Setup.AnswerBuffer.Data;
+                fprintf(stdout, "\nReferenceVerifyHaversine (libm, 1 thread):\n");
+
+                u64 RefStartTime = ReadCPUTimer();
+                u64 RefErrorCount = ReferenceVerifyHaversine(Setup);
+                u64 RefEndTime = ReadCPUTimer();
+
+                f64 Seconds = (f64)(RefEndTime - RefStartTime) / (f64)CPUFreq;
+                fprintf(stdout, "Mismatches: %llu of %llu pairs\n", RefErrorCount, Setup.PairCount);
+                fprintf(stdout, "Time: %.4fs (%.2f million pairs/s)\n", Seconds, (f64)Setup.PairCount / (1000000.0*Seconds));
+            }
+        }
+
+        StopHaversineThreadPool(Pool);
+    }
+    else if(IsValid(Setup))
+    {
+        fprintf(stderr, "ERROR: Unable to start the thread pool\n");
+    }
+
+    free(Pool);
+    FreeHaversine(&Setup);
+
+    (void)&CombinedHaversineTest;
+
+    return 0;
+}
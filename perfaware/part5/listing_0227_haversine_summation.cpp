@@ -0,0 +1,307 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 227
+   ======================================================================== */
+
+/* NOTE(casey): Summation strategies, kept separate from the distance math. The
+   distances come from any haversine_distance_func, a batch at a time, and a
+   haversine_accumulator adds each batch up the way Setup.Summation says to:
+
+   Serial - one running sum, one add after another. Every add waits on the one
+   before it, and the rounding error can grow with the pair count.
+
+   MultiAccumulator - eight independent running sums (two AVX registers),
+   combined at the end. The adds no longer wait on each other, and each sum
+   only sees an eighth of the values.
+
+   Pairwise - each batch is summed as a tree, and the batch sums are combined
+   as a tree too, by treating the batch count as a binary counter. The error
+   grows with log(N) instead of N.
+
+   Kahan - four lanes of compensated summation. Each lane carries the low bits
+   that its last add rounded away into the next add, so the error hardly grows
+   with N at all - at the cost of four flops per value instead of one.
+
+   The strategy is switched on once per batch, not once per value.
+
+   Only compute functions that go through SumHaversineAccumulated honor the
+   setting. The hand-written SIMD sums from listings 215, 219, 221 and 223 keep
+   their own fixed accumulators - the vector lanes are already several
+   independent running sums - and ignore it. */
+
+#define HAVERSINE_ACCUMULATE_BATCH_PAIR_COUNT 256
+#define HAVERSINE_PAIRWISE_LEAF_COUNT 8
+
+struct haversine_accumulator
+{
+    summation_strategy Strategy;
+
+    f64 Sum;
+    f64 Lanes[8];
+    f64 Compensation[4];
+
+    // NOTE(casey): For pairwise, bit N of BatchCount says whether Levels[N] holds the sum of 2^N batches
+    u64 BatchCount;
+    f64 Levels[64];
+};
+
+static char const *SummationStrategyNames[Summation_Count] =
+{
+    "Serial",
+    "MultiAccumulator",
+    "Pairwise",
+    "Kahan",
+};
+
+static haversine_accumulator BeginAccumulation(summation_strategy Strategy)
+{
+    haversine_accumulator Result = {};
+    Result.Strategy = Strategy;
+    return Result;
+}
+
+static f64 SumPairwise(u64 Count, f64 *Values)
+{
+    f64 Result = 0;
+    if(Count <= HAVERSINE_PAIRWISE_LEAF_COUNT)
+    {
+        for(u64 Index = 0; Index < Count; ++Index)
+        {
+            Result += Values[Index];
+        }
+    }
+    else
+    {
+        u64 Half = Count / 2;
+        Result = SumPairwise(Half, Values) + SumPairwise(Count - Half, Values + Half);
+    }
+
+    return Result;
+}
+
+static void AccumulateSerial(haversine_accumulator *Acc, u64 Count, f64 *Values)
+{
+    f64 Sum = Acc->Sum;
+    for(u64 Index = 0; Index < Count; ++Index)
+    {
+        Sum += Values[Index];
+    }
+    Acc->Sum = Sum;
+}
+
+static void AccumulateMulti(haversine_accumulator *Acc, u64 Count, f64 *Values)
+{
+    __m256d Sum0 = _mm256_loadu_pd(Acc->Lanes);
+    __m256d Sum1 = _mm256_loadu_pd(Acc->Lanes + 4);
+
+    u64 Index = 0;
+    for(; (Index + 8) <= Count; Index += 8)
+    {
+        Sum0 = _mm256_add_pd(Sum0, _mm256_loadu_pd(Values + Index));
+        Sum1 = _mm256_add_pd(Sum1, _mm256_loadu_pd(Values + Index + 4));
+    }
+
+    _mm256_storeu_pd(Acc->Lanes, Sum0);
+    _mm256_storeu_pd(Acc->Lanes + 4, Sum1);
+
+    for(; Index < Count; ++Index)
+    {
+        Acc->Lanes[Index & 7] += Values[Index];
+    }
+}
+
+static void AccumulatePairwise(haversine_accumulator *Acc, u64 Count, f64 *Values)
+{
+    // NOTE(casey): Adding one to a binary counter - every level that carries gets merged into the sum on its way up
+    f64 Carry = SumPairwise(Count, Values);
+    u64 Level = 0;
+    while(Acc->BatchCount & (1ull << Level))
+    {
+        Carry = Acc->Levels[Level] + Carry;
+        ++Level;
+    }
+
+    Acc->Levels[Level] = Carry;
+    ++Acc->BatchCount;
+}
+
+inline void KahanAdd(f64 *Sum, f64 *Compensation, f64 Value)
+{
+    f64 Y = Value - *Compensation;
+    f64 T = *Sum + Y;
+    *Compensation = (T - *Sum) - Y;
+    *Sum = T;
+}
+
+static void AccumulateKahan(haversine_accumulator *Acc, u64 Count, f64 *Values)
+{
+    __m256d Sum = _mm256_loadu_pd(Acc->Lanes);
+    __m256d Compensation = _mm256_loadu_pd(Acc->Compensation);
+
+    u64 Index = 0;
+    for(; (Index + 4) <= Count; Index += 4)
+    {
+        __m256d Y = _mm256_sub_pd(_mm256_loadu_pd(Values + Index), Compensation);
+        __m256d T = _mm256_add_pd(Sum, Y);
+        Compensation = _mm256_sub_pd(_mm256_sub_pd(T, Sum), Y);
+        Sum = T;
+    }
+
+    _mm256_storeu_pd(Acc->Lanes, Sum);
+    _mm256_storeu_pd(Acc->Compensation, Compensation);
+
+    for(; Index < Count; ++Index)
+    {
+        KahanAdd(Acc->Lanes + (Index & 3), Acc->Compensation + (Index & 3), Values[Index]);
+    }
+}
+
+static void Accumulate(haversine_accumulator *Acc, u64 Count, f64 *Values)
+{
+    // NOTE(casey): Pairwise only works out to a balanced tree if every batch but the last is the same size
+    switch(Acc->Strategy)
+    {
+        case Summation_MultiAccumulator: {AccumulateMulti(Acc, Count, Values);} break;
+        case Summation_Pairwise: {AccumulatePairwise(Acc, Count, Values);} break;
+        case Summation_Kahan: {AccumulateKahan(Acc, Count, Values);} break;
+        default: {AccumulateSerial(Acc, Count, Values);} break;
+    }
+}
+
+static f64 EndAccumulation(haversine_accumulator *Acc)
+{
+    f64 Result = 0;
+
+    switch(Acc->Strategy)
+    {
+        case Summation_MultiAccumulator:
+        {
+            f64 *L = Acc->Lanes;
+            Result = ((L[0] + L[4]) + (L[1] + L[5])) + ((L[2] + L[6]) + (L[3] + L[7]));
+        } break;
+
+        case Summation_Pairwise:
+        {
+            for(u64 Level = 0; Level < ArrayCount(Acc->Levels); ++Level)
+            {
+                if(Acc->BatchCount & (1ull << Level))
+                {
+                    Result += Acc->Levels[Level];
+                }
+            }
+        } break;
+
+        case Summation_Kahan:
+        {
+            // NOTE(casey): Each lane's true sum is Lanes - Compensation, so both go through one more Kahan pass
+            f64 Compensation = 0;
+            for(u32 Lane = 0; Lane < 4; ++Lane)
+            {
+                KahanAdd(&Result, &Compensation, Acc->Lanes[Lane]);
+                KahanAdd(&Result, &Compensation, -Acc->Compensation[Lane]);
+            }
+        } break;
+
+        default:
+        {
+            Result = Acc->Sum;
+        } break;
+    }
+
+    return Result;
+}
+
+static f64 SumHaversineAccumulated(haversine_setup Setup, haversine_distance_func *ComputeDistances)
+{
+    haversine_accumulator Acc = BeginAccumulation(Setup.Summation);
+    haversine_columns Columns = Setup.Columns;
+
+    f64 Distances[HAVERSINE_ACCUMULATE_BATCH_PAIR_COUNT];
+    for(u64 FirstPair = 0; FirstPair < Setup.PairCount; FirstPair += HAVERSINE_ACCUMULATE_BATCH_PAIR_COUNT)
+    {
+        u64 BatchCount = Setup.PairCount - FirstPair;
+        if(BatchCount > HAVERSINE_ACCUMULATE_BATCH_PAIR_COUNT)
+        {
+            BatchCount = HAVERSINE_ACCUMULATE_BATCH_PAIR_COUNT;
+        }
+
+        haversine_columns Batch = {Columns.X0 + FirstPair, Columns.Y0 + FirstPair, Columns.X1 + FirstPair, Columns.Y1 + FirstPair};
+        ComputeDistances(BatchCount, Batch, Distances);
+        Accumulate(&Acc, BatchCount, Distances);
+    }
+
+    f64 Result = EndAccumulation(&Acc) / (f64)Setup.PairCount;
+    return Result;
+}
+
+static f64 SumAnswersExactly(haversine_setup Setup)
+{
+    /* NOTE(casey): Neumaier's version of Kahan, which also holds up when a value is
+       larger than the running sum. On the answer file's own per-pair distances,
+       this is as close to the exact average as an f64 gets, so it is what the
+       strategies are measured against - the file's sum was itself added up
+       serially by the generator. */
+
+    f64 Sum = 0;
+    f64 Compensation = 0;
+    for(u64 PairIndex = 0; PairIndex < Setup.PairCount; ++PairIndex)
+    {
+        f64 Value = Setup.Answers[PairIndex];
+        f64 T = Sum + Value;
+        if(fabs(Sum) >= fabs(Value))
+        {
+            Compensation += (Sum - T) + Value;
+        }
+        else
+        {
+            Compensation += (Value - T) + Sum;
+        }
+        Sum = T;
+    }
+
+    f64 Result = (Sum + Compensation) / (f64)Setup.PairCount;
+    return Result;
+}
+
+//
+// NOTE(casey): Test functions
+//
+
+static void ComputeHaversineDistancesReference(u64 PairCount, haversine_columns Columns, f64 *Dest)
+{
+    for(u64 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+    {
+        Dest[PairIndex] = ReferenceHaversine(Columns.X0[PairIndex], Columns.Y0[PairIndex],
+                                             Columns.X1[PairIndex], Columns.Y1[PairIndex], QUESTIONABLE_EARTH_RADIUS);
+    }
+}
+
+static f64 ReferenceHaversineAccumulated(haversine_setup Setup)
+{
+    f64 Result = SumHaversineAccumulated(Setup, ComputeHaversineDistancesReference);
+    return Result;
+}
+
+static f64 AVX2HaversineAccumulated(haversine_setup Setup)
+{
+    f64 Result = SumHaversineAccumulated(Setup, ComputeHaversineDistancesAVX2);
+    return Result;
+}
+
+static f64 AVX512HaversineAccumulated(haversine_setup Setup)
+{
+    // NOTE(casey): Only call this if CPUSupportsAVX512F() says it's OK
+    f64 Result = SumHaversineAccumulated(Setup, ComputeHaversineDistancesAVX512);
+    return Result;
+}
@@ -0,0 +1,94 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 228
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+#include "listing_0227_haversine_summation.cpp"
+
+static test_function TestFunctions[] =
+{
+    {"AVX2Haversine", AVX2Haversine},
+    {"ReferenceHaversineAccumulated", ReferenceHaversineAccumulated},
+    {"AVX2HaversineAccumulated", AVX2HaversineAccumulated},
+
+    // NOTE(casey): This must stay last, so it can be left off on CPUs that don't have AVX-512
+    {"AVX512HaversineAccumulated", AVX512HaversineAccumulated},
+};
+
+int main(int ArgCount, char **Args)
+{
+    /* NOTE(casey): One row per summation strategy. AVX2Haversine ignores the
+       strategy, so it is the same in every row and serves as the baseline. */
+
+    u32 TestFunctionCount = ArrayCount(TestFunctions);
+    if(!CPUSupportsAVX512F())
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so AVX512HaversineAccumulated will not be tested.\n");
+        --TestFunctionCount;
+    }
+
+    haversine_setup Setup = {};
+    if(SetUpHaversineTest(ArgCount, Args, &Setup))
+    {
+        f64 ExactSum = SumAnswersExactly(Setup);
+        fprintf(stdout, "Exact average of the answers: %.16f\n", ExactSum);
+        fprintf(stdout, "Answer file's own sum:        %.16f (%+.3e)\n\n", Setup.SumAnswer, Setup.SumAnswer - ExactSum);
+
+        buffer SumsBuffer = AllocateBuffer(Summation_Count*TestFunctionCount*sizeof(f64));
+        repetition_test_series TestSeries = AllocateTestSeries(TestFunctionCount, Summation_Count);
+        if(IsValid(SumsBuffer) && IsValid(TestSeries))
+        {
+            f64 *Sums = (f64 *)SumsBuffer.Data;
+
+            SetRowLabelLabel(&TestSeries, "Summation");
+            for(u32 Strategy = 0; Strategy < Summation_Count; ++Strategy)
+            {
+                Setup.Summation = (summation_strategy)Strategy;
+                SetRowLabel(&TestSeries, "%s", SummationStrategyNames[Strategy]);
+                RunHaversineTestRow(&TestSeries, Setup, TestFunctionCount, TestFunctions, 0, 0, Sums + Strategy*TestFunctionCount);
+            }
+
+            fprintf(stdout, "\nGB/s:\n");
+            PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, 1.0);
+
+            fprintf(stdout, "\nError vs the exact average:\nSummation");
+            for(u32 TestFunctionIndex = 0; TestFunctionIndex < TestFunctionCount; ++TestFunctionIndex)
+            {
+                fprintf(stdout, ",%s", TestFunctions[TestFunctionIndex].Name);
+            }
+            fprintf(stdout, "\n");
+
+            for(u32 Strategy = 0; Strategy < Summation_Count; ++Strategy)
+            {
+                fprintf(stdout, "%s", SummationStrategyNames[Strategy]);
+                for(u32 TestFunctionIndex = 0; TestFunctionIndex < TestFunctionCount; ++TestFunctionIndex)
+                {
+                    fprintf(stdout, ",%+.3e", Sums[Strategy*TestFunctionCount + TestFunctionIndex] - ExactSum);
+                }
+                fprintf(stdout, "\n");
+            }
+        }
+
+        FreeTestSeries(&TestSeries);
+        FreeBuffer(&SumsBuffer);
+    }
+
+    FreeHaversine(&Setup);
+
+    (void)&CombinedHaversineTest;
+
+    return 0;
+}
@@ -0,0 +1,247 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 229
+   ======================================================================== */
+
+/* NOTE(casey): SimplifiedHaversineI picks its constants with four predicates
+   on the inputs - lat1 < 0, lat2 < 0, DLat < 180 and DLon < 180. On pairs in
+   arbitrary order, those are coin flips. This listing radix-partitions the
+   columns on those four bits (a single counting pass, then a single scatter
+   pass, so the order within a class is kept), and then runs each of the 16
+   classes through a kernel that has its constants baked in at compile time.
+
+   The fifth predicate, a > 0.5, depends on the result, so it can't be sorted
+   on up front. It stays a select in the class kernels. Doing it with arithmetic
+   instead (RangeA = min(a, 1 - a), and an fma with +/-1 on R) was measurably
+   slower than letting the compiler have it, since on real data it is rarely
+   taken and predicts well. */
+
+enum haversine_class_bit
+{
+    HaversineClass_Lat1Negative = 0x1,
+    HaversineClass_Lat2Negative = 0x2,
+    HaversineClass_DLatWrapped = 0x4, // NOTE(casey): DLat >= 180
+    HaversineClass_DLonWrapped = 0x8, // NOTE(casey): DLon >= 180
+
+    HaversineClass_Count = 16,
+};
+
+struct haversine_partition
+{
+    buffer ColumnsBuffer;
+    buffer ClassBuffer;
+
+    u64 PairCount;
+    haversine_columns Columns;
+    u64 ClassFirst[HaversineClass_Count + 1]; // NOTE(casey): Class N is pairs [ClassFirst[N], ClassFirst[N+1])
+};
+
+inline u32 GetHaversineClass(f64 X0, f64 Y0, f64 X1, f64 Y1)
+{
+    u32 Result = (((Y0 < 0) ? HaversineClass_Lat1Negative : 0) |
+                  ((Y1 < 0) ? HaversineClass_Lat2Negative : 0) |
+                  ((fabs(Y1 - Y0) < 180.0) ? 0 : HaversineClass_DLatWrapped) |
+                  ((fabs(X1 - X0) < 180.0) ? 0 : HaversineClass_DLonWrapped));
+    return Result;
+}
+
+static b32 AllocatePartition(haversine_partition *Partition, u64 PairCount)
+{
+    *Partition = {};
+
+    u64 ColumnStride = GetHaversineColumnStride(PairCount);
+    Partition->ColumnsBuffer = AllocateBuffer(HaversineColumn_Count*ColumnStride);
+    Partition->ClassBuffer = AllocateBuffer(PairCount);
+
+    b32 Result = (IsValid(Partition->ColumnsBuffer) && IsValid(Partition->ClassBuffer));
+    if(Result)
+    {
+        Partition->PairCount = PairCount;
+        Partition->Columns = GetColumns(Partition->ColumnsBuffer.Data, ColumnStride);
+    }
+
+    return Result;
+}
+
+static void FreePartition(haversine_partition *Partition)
+{
+    FreeBuffer(&Partition->ColumnsBuffer);
+    FreeBuffer(&Partition->ClassBuffer);
+    *Partition = {};
+}
+
+static void PartitionHaversinePairs(haversine_setup Setup, haversine_partition *Partition)
+{
+    // NOTE(casey): Partition must have been allocated for at least Setup.PairCount pairs
+
+    haversine_columns Source = Setup.Columns;
+    haversine_columns Dest = Partition->Columns;
+    u8 *Classes = Partition->ClassBuffer.Data;
+
+    u64 Counts[HaversineClass_Count] = {};
+    for(u64 PairIndex = 0; PairIndex < Setup.PairCount; ++PairIndex)
+    {
+        u32 Class = GetHaversineClass(Source.X0[PairIndex], Source.Y0[PairIndex], Source.X1[PairIndex], Source.Y1[PairIndex]);
+        Classes[PairIndex] = (u8)Class;
+        ++Counts[Class];
+    }
+
+    u64 Next[HaversineClass_Count];
+    u64 First = 0;
+    for(u32 Class = 0; Class < HaversineClass_Count; ++Class)
+    {
+        Partition->ClassFirst[Class] = First;
+        Next[Class] = First;
+        First += Counts[Class];
+    }
+    Partition->ClassFirst[HaversineClass_Count] = First;
+
+    for(u64 PairIndex = 0; PairIndex < Setup.PairCount; ++PairIndex)
+    {
+        u64 DestIndex = Next[Classes[PairIndex]]++;
+        Dest.X0[DestIndex] = Source.X0[PairIndex];
+        Dest.Y0[DestIndex] = Source.Y0[PairIndex];
+        Dest.X1[DestIndex] = Source.X1[PairIndex];
+        Dest.Y1[DestIndex] = Source.Y1[PairIndex];
+    }
+}
+
+//
+// NOTE(casey): Kernels
+//
+
+inline f64 HaversineHalfAngleWithConstants(f64 lon1, f64 lat1, f64 lon2, f64 lat2,
+                                           f64 SLC1, f64 SLC2, f64 SLC0, f64 SLC3, f64 ALC0, f64 ALC3)
+{
+    f64 HalfPi = Pi64/2.0;
+
+    f64 DLat = fabs(lat2 - lat1);
+    f64 DLon = fabs(lon2 - lon1);
+
+    f64 S1 = SineCoreWithPrefix(SLC1, lat1, HalfPi);
+    f64 S2 = SineCoreWithPrefix(SLC2, lat2, HalfPi);
+    f64 S0 = SineCoreWithPrefix(SLC0, DLat, ALC0);
+    f64 S3 = SineCoreWithPrefix(SLC3, DLon, ALC3);
+
+    f64 a = fma(S0, S0, S1*S2*S3*S3);
+
+    b32 NeedsTransform = (a > 0.5);
+    f64 RangeA = NeedsTransform ? (1.0 - a) : a;
+    f64 R = ArcsineCoreFromSquared(RangeA);
+    f64 RangeR = NeedsTransform ? (1.57079632679489661923 - R) : R;
+
+    return RangeR;
+}
+
+template<u32 Class> static f64 SumHaversineClass(u64 PairCount, haversine_columns Columns)
+{
+    f64 RadC = 0.01745329251994329577;
+    f64 HalfRadC = RadC/2.0;
+
+    f64 SLC1 = (Class & HaversineClass_Lat1Negative) ? RadC : -RadC;
+    f64 SLC2 = (Class & HaversineClass_Lat2Negative) ? RadC : -RadC;
+    f64 SLC0 = (Class & HaversineClass_DLatWrapped) ? -HalfRadC : HalfRadC;
+    f64 SLC3 = (Class & HaversineClass_DLonWrapped) ? -HalfRadC : HalfRadC;
+    f64 ALC0 = (Class & HaversineClass_DLatWrapped) ? Pi64 : 0;
+    f64 ALC3 = (Class & HaversineClass_DLonWrapped) ? Pi64 : 0;
+
+    f64 Sum = 0;
+    for(u64 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+    {
+        Sum += HaversineHalfAngleWithConstants(Columns.X0[PairIndex], Columns.Y0[PairIndex], Columns.X1[PairIndex], Columns.Y1[PairIndex],
+                                               SLC1, SLC2, SLC0, SLC3, ALC0, ALC3);
+    }
+
+    return Sum;
+}
+
+typedef f64 haversine_class_sum(u64 PairCount, haversine_columns Columns);
+static haversine_class_sum *HaversineClassSums[HaversineClass_Count] =
+{
+    SumHaversineClass<0>, SumHaversineClass<1>, SumHaversineClass<2>, SumHaversineClass<3>,
+    SumHaversineClass<4>, SumHaversineClass<5>, SumHaversineClass<6>, SumHaversineClass<7>,
+    SumHaversineClass<8>, SumHaversineClass<9>, SumHaversineClass<10>, SumHaversineClass<11>,
+    SumHaversineClass<12>, SumHaversineClass<13>, SumHaversineClass<14>, SumHaversineClass<15>,
+};
+
+static f64 SumHaversineColumnsWithPredicates(u64 PairCount, haversine_columns Columns)
+{
+    // NOTE(casey): The same math as SimplifiedHaversineI, over columns, deciding the constants pair by pair
+
+    f64 RadC = 0.01745329251994329577;
+    f64 HalfRadC = RadC/2.0;
+    f64 HalfPi = Pi64/2.0;
+    f64 Deg180 = 180.0;
+
+    f64 Sum = 0;
+    for(u64 PairIndex = 0; PairIndex < PairCount; ++PairIndex)
+    {
+        f64 lon1 = Columns.X0[PairIndex];
+        f64 lat1 = Columns.Y0[PairIndex];
+        f64 lon2 = Columns.X1[PairIndex];
+        f64 lat2 = Columns.Y1[PairIndex];
+
+        f64 SLC1 = (lat1 < 0) ? RadC : -RadC;
+        f64 SLC2 = (lat2 < 0) ? RadC : -RadC;
+
+        f64 DLat = fabs(lat2 - lat1);
+        f64 DLon = fabs(lon2 - lon1);
+        f64 SLC0 = (DLat < Deg180) ? HalfRadC : -HalfRadC;
+        f64 SLC3 = (DLon < Deg180) ? HalfRadC : -HalfRadC;
+        f64 ALC0 = (DLat < Deg180) ? 0 : Pi64;
+        f64 ALC3 = (DLon < Deg180) ? 0 : Pi64;
+
+        f64 S1 = SineCoreWithPrefix(SLC1, lat1, HalfPi);
+        f64 S2 = SineCoreWithPrefix(SLC2, lat2, HalfPi);
+        f64 S0 = SineCoreWithPrefix(SLC0, DLat, ALC0);
+        f64 S3 = SineCoreWithPrefix(SLC3, DLon, ALC3);
+
+        f64 a = fma(S0, S0, S1*S2*S3*S3);
+
+        b32 NeedsTransform = (a > 0.5);
+        f64 RangeA = NeedsTransform ? (1.0 - a) : a;
+        f64 R = ArcsineCoreFromSquared(RangeA);
+        f64 RangeR = NeedsTransform ? (1.57079632679489661923 - R) : R;
+
+        Sum += RangeR;
+    }
+
+    return Sum;
+}
+
+static f64 SumPartitionedHaversine(haversine_partition *Partition)
+{
+    f64 Sum = 0;
+    for(u32 Class = 0; Class < HaversineClass_Count; ++Class)
+    {
+        u64 First = Partition->ClassFirst[Class];
+        u64 Count = Partition->ClassFirst[Class + 1] - First;
+        if(Count)
+        {
+            haversine_columns Columns = Partition->Columns;
+            haversine_columns ClassColumns = {Columns.X0 + First, Columns.Y0 + First, Columns.X1 + First, Columns.Y1 + First};
+            Sum += HaversineClassSums[Class](Count, ClassColumns);
+        }
+    }
+
+    f64 Result = (2.0*QUESTIONABLE_EARTH_RADIUS)*Sum / (f64)Partition->PairCount;
+    return Result;
+}
+
+static f64 SumPartitionedHaversineWithPredicates(haversine_partition *Partition)
+{
+    f64 Sum = SumHaversineColumnsWithPredicates(Partition->PairCount, Partition->Columns);
+    f64 Result = (2.0*QUESTIONABLE_EARTH_RADIUS)*Sum / (f64)Partition->PairCount;
+    return Result;
+}
@@ -0,0 +1,115 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 230
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+#include "listing_0229_partitioned_haversine.cpp"
+
+/* NOTE(casey): The compute functions only get a haversine_setup, so the
+   partition is allocated once up front and kept here. "Presorted" rows use a
+   partition built before the test starts; "PartitionAnd" rows rebuild it on
+   every repetition, so they include the cost of the sort. */
+static haversine_partition GlobalPartition;
+
+static f64 UnsortedWithPredicates(haversine_setup Setup)
+{
+    f64 Sum = SumHaversineColumnsWithPredicates(Setup.PairCount, Setup.Columns);
+    f64 Result = (2.0*QUESTIONABLE_EARTH_RADIUS)*Sum / (f64)Setup.PairCount;
+    return Result;
+}
+
+static f64 PresortedWithPredicates(haversine_setup Setup)
+{
+    (void)Setup;
+    f64 Result = SumPartitionedHaversineWithPredicates(&GlobalPartition);
+    return Result;
+}
+
+static f64 PresortedClassKernels(haversine_setup Setup)
+{
+    (void)Setup;
+    f64 Result = SumPartitionedHaversine(&GlobalPartition);
+    return Result;
+}
+
+static f64 PartitionAndClassKernels(haversine_setup Setup)
+{
+    PartitionHaversinePairs(Setup, &GlobalPartition);
+    f64 Result = SumPartitionedHaversine(&GlobalPartition);
+    return Result;
+}
+
+static test_function TestFunctions[] =
+{
+    {"UnsortedWithPredicates", UnsortedWithPredicates},
+    {"PresortedWithPredicates", PresortedWithPredicates},
+    {"PresortedClassKernels", PresortedClassKernels},
+    {"PartitionAndClassKernels", PartitionAndClassKernels},
+    {"AVX2Haversine", AVX2Haversine},
+};
+
+int main(int ArgCount, char **Args)
+{
+    haversine_setup Setup = {};
+    if(SetUpHaversineTest(ArgCount, Args, &Setup))
+    {
+        if(AllocatePartition(&GlobalPartition, Setup.PairCount))
+        {
+            PartitionHaversinePairs(Setup, &GlobalPartition);
+
+            fprintf(stdout, "\nPairs per class:\n");
+            for(u32 Class = 0; Class < HaversineClass_Count; ++Class)
+            {
+                u64 Count = GlobalPartition.ClassFirst[Class + 1] - GlobalPartition.ClassFirst[Class];
+                if(Count)
+                {
+                    fprintf(stdout, "  %s%s%s%s: %llu (%.1f%%)\n",
+                            (Class & HaversineClass_Lat1Negative) ? "lat1<0 " : "lat1>=0 ",
+                            (Class & HaversineClass_Lat2Negative) ? "lat2<0 " : "lat2>=0 ",
+                            (Class & HaversineClass_DLatWrapped) ? "DLat>=180 " : "DLat<180 ",
+                            (Class & HaversineClass_DLonWrapped) ? "DLon>=180" : "DLon<180",
+                            Count, 100.0*(f64)Count / (f64)Setup.PairCount);
+                }
+            }
+            fprintf(stdout, "\n");
+
+            u32 TestFunctionCount = ArrayCount(TestFunctions);
+            repetition_test_series TestSeries = AllocateTestSeries(TestFunctionCount, 1);
+            if(IsValid(TestSeries))
+            {
+                SetRowLabelLabel(&TestSeries, "Test");
+                SetRowLabel(&TestSeries, "Haversine");
+                RunHaversineTestRow(&TestSeries, Setup, TestFunctionCount, TestFunctions);
+
+                PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, 1.0);
+            }
+
+            FreeTestSeries(&TestSeries);
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Unable to allocate the partition\n");
+        }
+
+        FreePartition(&GlobalPartition);
+    }
+
+    FreeHaversine(&Setup);
+
+    (void)&CombinedHaversineTest;
+
+    return 0;
+}
@@ -0,0 +1,275 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 231
+   ======================================================================== */
+
+/* NOTE(casey): Batch versions of the listing 190 replacements. Each one takes
+   Count inputs and writes Count outputs, using the same minimax polynomials
+   and the same range reductions as the scalar code, four or eight lanes at a
+   time. The tail is done with masked loads and stores, so Count can be
+   anything and the arrays need no padding.
+
+   SinCE_N and friends go through a table that starts out pointing at the AVX2
+   versions. InitializeMathBatch switches it to AVX-512 if the CPU has it. */
+
+typedef void math_batch_func(u64 Count, f64 const *In, f64 *Out);
+
+//
+// NOTE(casey): AVX2
+//
+
+inline __m256d SinCE4(__m256d OrigX)
+{
+    __m256d SignBit = _mm256_set1_pd(-0.0);
+    __m256d Pi = _mm256_set1_pd(Pi64);
+    __m256d HalfPi = _mm256_set1_pd(Pi64/2);
+
+    __m256d PosX = _mm256_andnot_pd(SignBit, OrigX);
+    __m256d X = _mm256_blendv_pd(PosX, _mm256_sub_pd(Pi, PosX), _mm256_cmp_pd(PosX, HalfPi, _CMP_GT_OQ));
+    __m256d X2 = _mm256_mul_pd(X, X);
+
+    __m256d R = _mm256_set1_pd(0x1.883c1c5deffbep-49);
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.ae43dc9bf8ba7p-41));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.6123ce513b09fp-33));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.ae6454d960ac4p-26));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.71de3a52aab96p-19));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.a01a01a014eb6p-13));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.11111111110c9p-7));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.5555555555555p-3));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1p0));
+    R = _mm256_mul_pd(R, X);
+
+    // NOTE(casey): (OrigX < 0) ? -R : R
+    __m256d Result = _mm256_blendv_pd(R, _mm256_xor_pd(R, SignBit), _mm256_cmp_pd(OrigX, _mm256_setzero_pd(), _CMP_LT_OQ));
+    return Result;
+}
+
+inline __m256d CosCE4(__m256d X)
+{
+    __m256d Result = SinCE4(_mm256_add_pd(X, _mm256_set1_pd(Pi64/2.0)));
+    return Result;
+}
+
+inline __m256d SqrtCE4(__m256d X)
+{
+    __m256d Result = _mm256_sqrt_pd(X);
+    return Result;
+}
+
+inline __m256d ASinCE4(__m256d OrigX)
+{
+    __m256d One = _mm256_set1_pd(1.0);
+
+    // NOTE(casey): 1 - X*X is fused explicitly. With FMA enabled, the scalar version compiles to an fnmadd, and this has to match it without relying on the compiler to contract intrinsics
+    __m256d NeedsTransform = _mm256_cmp_pd(OrigX, _mm256_set1_pd(0.7071067811865475244), _CMP_GT_OQ);
+    __m256d X = _mm256_blendv_pd(OrigX, _mm256_sqrt_pd(_mm256_fnmadd_pd(OrigX, OrigX, One)), NeedsTransform);
+    __m256d X2 = _mm256_mul_pd(X, X);
+
+    __m256d R = _mm256_set1_pd(0x1.dfc53682725cap-1);
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.bec6daf74ed61p1));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.8bf4dadaf548cp2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.b06f523e74f33p2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.4537ddde2d76dp2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.6067d334b4792p1));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.1fb54da575b22p0));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.57380bcd2890ep-2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.69b370aad086ep-4));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.21438ccc95d62p-8));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.b8a33b8e380efp-7));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.c37061f4e5f55p-7));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.1c875d6c5323dp-6));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.6e88ce94d1149p-6));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.f1c73443a02f5p-6));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.6db6db3184756p-5));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.3333333380df2p-4));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.555555555531ep-3));
+    R = _mm256_fmadd_pd(R, X2, One);
+    R = _mm256_mul_pd(R, X);
+
+    __m256d Result = _mm256_blendv_pd(R, _mm256_sub_pd(_mm256_set1_pd(1.57079632679489661923), R), NeedsTransform);
+    return Result;
+}
+
+#define MATH_BATCH_AVX2(Name, Op) \
+    static void Name(u64 Count, f64 const *In, f64 *Out) \
+    { \
+        u64 Index = 0; \
+        for(; (Index + 4) <= Count; Index += 4) \
+        { \
+            _mm256_storeu_pd(Out + Index, Op(_mm256_loadu_pd(In + Index))); \
+        } \
+        if(Index < Count) \
+        { \
+            __m256i Mask = GetLoadMask4(Count - Index); \
+            _mm256_maskstore_pd(Out + Index, Mask, Op(_mm256_maskload_pd(In + Index, Mask))); \
+        } \
+    }
+
+MATH_BATCH_AVX2(SinCE_N_AVX2, SinCE4)
+MATH_BATCH_AVX2(CosCE_N_AVX2, CosCE4)
+MATH_BATCH_AVX2(ASinCE_N_AVX2, ASinCE4)
+MATH_BATCH_AVX2(SqrtCE_N_AVX2, SqrtCE4)
+
+//
+// NOTE(casey): AVX-512
+//
+
+AVX512_FUNCTION inline __m512d SinCE8(__m512d OrigX)
+{
+    __m512d Pi = _mm512_set1_pd(Pi64);
+    __m512d HalfPi = _mm512_set1_pd(Pi64/2);
+
+    __m512d PosX = _mm512_abs_pd(OrigX);
+    __m512d X = _mm512_mask_sub_pd(PosX, _mm512_cmp_pd_mask(PosX, HalfPi, _CMP_GT_OQ), Pi, PosX);
+    __m512d X2 = _mm512_mul_pd(X, X);
+
+    __m512d R = _mm512_set1_pd(0x1.883c1c5deffbep-49);
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.ae43dc9bf8ba7p-41));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.6123ce513b09fp-33));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.ae6454d960ac4p-26));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.71de3a52aab96p-19));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.a01a01a014eb6p-13));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.11111111110c9p-7));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.5555555555555p-3));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1p0));
+    R = _mm512_mul_pd(R, X);
+
+    __m512d Result = _mm512_mask_sub_pd(R, _mm512_cmp_pd_mask(OrigX, _mm512_setzero_pd(), _CMP_LT_OQ), _mm512_setzero_pd(), R);
+    return Result;
+}
+
+AVX512_FUNCTION inline __m512d CosCE8(__m512d X)
+{
+    __m512d Result = SinCE8(_mm512_add_pd(X, _mm512_set1_pd(Pi64/2.0)));
+    return Result;
+}
+
+AVX512_FUNCTION inline __m512d SqrtCE8(__m512d X)
+{
+    __m512d Result = _mm512_sqrt_pd(X);
+    return Result;
+}
+
+AVX512_FUNCTION inline __m512d ASinCE8(__m512d OrigX)
+{
+    __m512d One = _mm512_set1_pd(1.0);
+
+    __mmask8 NeedsTransform = _mm512_cmp_pd_mask(OrigX, _mm512_set1_pd(0.7071067811865475244), _CMP_GT_OQ);
+    __m512d X = _mm512_mask_sqrt_pd(OrigX, NeedsTransform, _mm512_fnmadd_pd(OrigX, OrigX, One)); // NOTE(casey): Fused, as in ASinCE4
+    __m512d X2 = _mm512_mul_pd(X, X);
+
+    __m512d R = _mm512_set1_pd(0x1.dfc53682725cap-1);
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.bec6daf74ed61p1));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.8bf4dadaf548cp2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.b06f523e74f33p2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.4537ddde2d76dp2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.6067d334b4792p1));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.1fb54da575b22p0));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.57380bcd2890ep-2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.69b370aad086ep-4));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.21438ccc95d62p-8));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.b8a33b8e380efp-7));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.c37061f4e5f55p-7));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.1c875d6c5323dp-6));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.6e88ce94d1149p-6));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.f1c73443a02f5p-6));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.6db6db3184756p-5));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.3333333380df2p-4));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.555555555531ep-3));
+    R = _mm512_fmadd_pd(R, X2, One);
+    R = _mm512_mul_pd(R, X);
+
+    __m512d Result = _mm512_mask_sub_pd(R, NeedsTransform, _mm512_set1_pd(1.57079632679489661923), R);
+    return Result;
+}
+
+#define MATH_BATCH_AVX512(Name, Op) \
+    AVX512_FUNCTION static void Name(u64 Count, f64 const *In, f64 *Out) \
+    { \
+        u64 Index = 0; \
+        for(; (Index + 8) <= Count; Index += 8) \
+        { \
+            _mm512_storeu_pd(Out + Index, Op(_mm512_loadu_pd(In + Index))); \
+        } \
+        if(Index < Count) \
+        { \
+            __mmask8 Mask = (__mmask8)((1u << (Count - Index)) - 1); \
+            _mm512_mask_storeu_pd(Out + Index, Mask, Op(_mm512_maskz_loadu_pd(Mask, In + Index))); \
+        } \
+    }
+
+MATH_BATCH_AVX512(SinCE_N_AVX512, SinCE8)
+MATH_BATCH_AVX512(CosCE_N_AVX512, CosCE8)
+MATH_BATCH_AVX512(ASinCE_N_AVX512, ASinCE8)
+MATH_BATCH_AVX512(SqrtCE_N_AVX512, SqrtCE8)
+
+//
+// NOTE(casey): Scalar, for comparison
+//
+
+#define MATH_BATCH_SCALAR(Name, Op) \
+    static void Name(u64 Count, f64 const *In, f64 *Out) \
+    { \
+        for(u64 Index = 0; Index < Count; ++Index) \
+        { \
+            Out[Index] = Op(In[Index]); \
+        } \
+    }
+
+MATH_BATCH_SCALAR(SinCE_N_Scalar, SinCE)
+MATH_BATCH_SCALAR(CosCE_N_Scalar, CosCE)
+MATH_BATCH_SCALAR(ASinCE_N_Scalar, ASinCE)
+MATH_BATCH_SCALAR(SqrtCE_N_Scalar, SqrtCE)
+
+//
+// NOTE(casey): Dispatch
+//
+
+struct math_batch_table
+{
+    char const *Name;
+
+    math_batch_func *SinCE_N;
+    math_batch_func *CosCE_N;
+    math_batch_func *ASinCE_N;
+    math_batch_func *SqrtCE_N;
+};
+
+enum math_batch_kind
+{
+    MathBatch_Scalar,
+    MathBatch_AVX2,
+    MathBatch_AVX512,
+
+    MathBatch_Count,
+};
+
+static math_batch_table MathBatchTables[MathBatch_Count] =
+{
+    {"Scalar", SinCE_N_Scalar, CosCE_N_Scalar, ASinCE_N_Scalar, SqrtCE_N_Scalar},
+    {"AVX2", SinCE_N_AVX2, CosCE_N_AVX2, ASinCE_N_AVX2, SqrtCE_N_AVX2},
+    {"AVX-512", SinCE_N_AVX512, CosCE_N_AVX512, ASinCE_N_AVX512, SqrtCE_N_AVX512},
+};
+
+static math_batch_table GlobalMathBatch = MathBatchTables[MathBatch_AVX2];
+
+inline void InitializeMathBatch(void)
+{
+    GlobalMathBatch = MathBatchTables[CPUSupportsAVX512F() ? MathBatch_AVX512 : MathBatch_AVX2];
+}
+
+inline void SinCE_N(u64 Count, f64 const *In, f64 *Out) {GlobalMathBatch.SinCE_N(Count, In, Out);}
+inline void CosCE_N(u64 Count, f64 const *In, f64 *Out) {GlobalMathBatch.CosCE_N(Count, In, Out);}
+inline void ASinCE_N(u64 Count, f64 const *In, f64 *Out) {GlobalMathBatch.ASinCE_N(Count, In, Out);}
+inline void SqrtCE_N(u64 Count, f64 const *In, f64 *Out) {GlobalMathBatch.SqrtCE_N(Count, In, Out);}
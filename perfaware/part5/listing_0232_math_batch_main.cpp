@@ -0,0 +1,155 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 232
+   ======================================================================== */
+
+#include "listing_0250_math_prelude.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+#include "listing_0231_math_batch.cpp"
+
+#define MATH_BATCH_PRECISION_STEP_COUNT 1000003 // NOTE(casey): Not a multiple of 8, so the masked tails get tested too
+#define MATH_BATCH_TIMING_COUNT 2048 // NOTE(casey): Small enough that input and output both stay in L1
+
+struct math_batch_function
+{
+    char const *Name;
+    math_func *Reference;
+    f64 MinInput;
+    f64 MaxInput;
+    u32 TableOffset; // NOTE(casey): Which math_batch_func in a math_batch_table this is
+};
+
+static math_batch_function BatchFunctions[] =
+{
+    {"SinCE_N", sin, -Pi64, Pi64, offsetof(math_batch_table, SinCE_N)},
+    {"CosCE_N", cos, -Pi64/2, Pi64/2, offsetof(math_batch_table, CosCE_N)},
+    {"ASinCE_N", asin, 0, 1, offsetof(math_batch_table, ASinCE_N)},
+    {"SqrtCE_N", sqrt, 0, 1, offsetof(math_batch_table, SqrtCE_N)},
+};
+
+static math_batch_func *GetBatchFunc(math_batch_table *Table, math_batch_function Function)
+{
+    math_batch_func *Result = *(math_batch_func **)((u8 *)Table + Function.TableOffset);
+    return Result;
+}
+
+static void FillPrecisionInputs(f64 *Dest, u32 StepCount, f64 MinInputValue, f64 MaxInputValue)
+{
+    // NOTE(casey): The same inputs PrecisionTest will step through, in the same order
+    for(u32 StepIndex = 0; StepIndex < StepCount; ++StepIndex)
+    {
+        f64 tStep = (f64)StepIndex / (f64)(StepCount - 1);
+        Dest[StepIndex] = (1.0 - tStep)*MinInputValue + tStep*MaxInputValue;
+    }
+}
+
+int main(void)
+{
+    InitializeOSPlatform();
+    InitializeMathBatch();
+
+    // NOTE(casey): AVX-512 is last, so it can be left off if the CPU doesn't have it
+    math_batch_table *Tables[] = {MathBatchTables + MathBatch_Scalar, MathBatchTables + MathBatch_AVX2, MathBatchTables + MathBatch_AVX512};
+    u32 TableCount = ArrayCount(Tables);
+    if(!CPUSupportsAVX512F())
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so the AVX-512 batch functions will not be tested.\n");
+        --TableCount;
+    }
+
+    fprintf(stdout, "Dispatching to: %s\n\n", GlobalMathBatch.Name);
+
+    u32 StepCount = MATH_BATCH_PRECISION_STEP_COUNT;
+    buffer InputBuffer = AllocateBuffer(StepCount*sizeof(f64));
+    buffer OutputBuffer = AllocateBuffer(ArrayCount(Tables)*StepCount*sizeof(f64));
+    if(IsValid(InputBuffer) && IsValid(OutputBuffer))
+    {
+        f64 *Input = (f64 *)InputBuffer.Data;
+
+        math_tester Tester = {};
+        for(u32 FunctionIndex = 0; FunctionIndex < ArrayCount(BatchFunctions); ++FunctionIndex)
+        {
+            math_batch_function Function = BatchFunctions[FunctionIndex];
+            FillPrecisionInputs(Input, StepCount, Function.MinInput, Function.MaxInput);
+            for(u32 TableIndex = 0; TableIndex < TableCount; ++TableIndex)
+            {
+                GetBatchFunc(Tables[TableIndex], Function)(StepCount, Input, (f64 *)OutputBuffer.Data + TableIndex*StepCount);
+            }
+
+            while(PrecisionTest(&Tester, Function.MinInput, Function.MaxInput, StepCount))
+            {
+                f64 *Output = (f64 *)OutputBuffer.Data + Tester.StepIndex;
+                f64 Expected = Function.Reference(Tester.InputValue);
+                for(u32 TableIndex = 0; TableIndex < TableCount; ++TableIndex)
+                {
+                    TestResult(&Tester, Expected, Output[TableIndex*StepCount], "%s %s", Function.Name, Tables[TableIndex]->Name);
+                }
+
+                // NOTE(casey): The vector versions should agree with the scalar one, not just with libm
+                for(u32 TableIndex = 1; TableIndex < TableCount; ++TableIndex)
+                {
+                    TestResult(&Tester, Output[0], Output[TableIndex*StepCount], "%s %s vs Scalar", Function.Name, Tables[TableIndex]->Name);
+                }
+            }
+        }
+
+        PrintResults(&Tester);
+
+        repetition_test_series TestSeries = AllocateTestSeries(TableCount, ArrayCount(BatchFunctions));
+        if(IsValid(TestSeries))
+        {
+            u32 Count = MATH_BATCH_TIMING_COUNT;
+            f64 *Output = (f64 *)OutputBuffer.Data;
+
+            SetRowLabelLabel(&TestSeries, "Function");
+            for(u32 FunctionIndex = 0; FunctionIndex < ArrayCount(BatchFunctions); ++FunctionIndex)
+            {
+                math_batch_function Function = BatchFunctions[FunctionIndex];
+                FillPrecisionInputs(Input, Count, Function.MinInput, Function.MaxInput);
+
+                SetRowLabel(&TestSeries, "%s", Function.Name);
+                for(u32 TableIndex = 0; TableIndex < TableCount; ++TableIndex)
+                {
+                    math_batch_func *BatchFunc = GetBatchFunc(Tables[TableIndex], Function);
+                    SetColumnLabel(&TestSeries, "%s", Tables[TableIndex]->Name);
+
+                    // NOTE(casey): "Bytes" are elements here, so the GB/s column comes out in elements
+                    repetition_tester RepTester = {};
+                    NewTestWave(&TestSeries, &RepTester, Count, GetCPUTimerFreq());
+                    while(IsTesting(&TestSeries, &RepTester))
+                    {
+                        BeginTime(&RepTester);
+                        BatchFunc(Count, Input, Output);
+                        CountBytes(&RepTester, Count);
+                        EndTime(&RepTester);
+                    }
+                }
+            }
+
+            fprintf(stdout, "\nMillion elements/s:\n");
+            PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, (1024.0*1024.0*1024.0) / 1000000.0);
+        }
+
+        FreeTestSeries(&TestSeries);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate test buffers\n");
+    }
+
+    FreeBuffer(&InputBuffer);
+    FreeBuffer(&OutputBuffer);
+
+    return 0;
+}
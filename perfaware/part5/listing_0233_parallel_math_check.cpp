@@ -0,0 +1,219 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 233
+   ======================================================================== */
+
+/* NOTE(casey): A parallel version of the PrecisionTest/TestResult loop from
+   listing 175. Instead of being called once per input, the code under test is
+   a precision_batch_func that fills in the reference and every candidate for
+   a whole batch of inputs at once, so candidates can be evaluated with SIMD.
+
+   The input steps are cut into fixed-size chunks, which threads grab one at a
+   time. Every chunk gets its own private math_test_result per candidate, and
+   at the end the chunks are merged in step order. Inputs are computed with the
+   exact same expression PrecisionTest uses, and a later max only replaces an
+   earlier one if it is strictly larger, so MaxDiff, DiffCount and the values
+   at the max come out identical to the serial tester. TotalDiff is added up
+   per chunk first, so it can differ from the serial one in the last bits, but
+   it does not depend on the thread count. */
+
+#define PARALLEL_PRECISION_CHUNK_STEP_COUNT (64*1024)
+#define PARALLEL_PRECISION_BATCH_COUNT 256
+#define PARALLEL_PRECISION_MAX_CANDIDATE_COUNT 32
+
+// NOTE(casey): Candidate N's outputs go in Outputs[N*PARALLEL_PRECISION_BATCH_COUNT + InputIndex]
+typedef void precision_batch_func(void *Context, u32 Count, f64 const *Inputs, f64 *Expected, f64 *Outputs);
+
+struct parallel_precision_test
+{
+    precision_batch_func *Func;
+    void *Context;
+    u32 CandidateCount;
+
+    f64 MinInputValue;
+    f64 MaxInputValue;
+    u32 StepCount;
+
+    u64 ChunkCount;
+    math_test_result *ChunkResults; // NOTE(casey): ChunkCount*CandidateCount of them, chunk-major
+    u64 volatile NextChunkIndex;
+};
+
+static void RunPrecisionChunks(parallel_precision_test *Test)
+{
+    f64 Inputs[PARALLEL_PRECISION_BATCH_COUNT];
+    f64 Expected[PARALLEL_PRECISION_BATCH_COUNT];
+    f64 Outputs[PARALLEL_PRECISION_MAX_CANDIDATE_COUNT*PARALLEL_PRECISION_BATCH_COUNT];
+
+    f64 MinInputValue = Test->MinInputValue;
+    f64 MaxInputValue = Test->MaxInputValue;
+    u32 StepCount = Test->StepCount;
+
+    for(;;)
+    {
+        u64 ChunkIndex = AtomicAddU64(&Test->NextChunkIndex, 1);
+        if(ChunkIndex >= Test->ChunkCount)
+        {
+            break;
+        }
+
+        math_test_result *Results = Test->ChunkResults + ChunkIndex*Test->CandidateCount;
+        u32 ChunkFirst = (u32)(ChunkIndex*PARALLEL_PRECISION_CHUNK_STEP_COUNT);
+        u32 ChunkEnd = ChunkFirst + PARALLEL_PRECISION_CHUNK_STEP_COUNT;
+        if((ChunkEnd < ChunkFirst) || (ChunkEnd > StepCount))
+        {
+            ChunkEnd = StepCount;
+        }
+
+        for(u32 BatchFirst = ChunkFirst; BatchFirst < ChunkEnd; BatchFirst += PARALLEL_PRECISION_BATCH_COUNT)
+        {
+            u32 BatchCount = ChunkEnd - BatchFirst;
+            if(BatchCount > PARALLEL_PRECISION_BATCH_COUNT)
+            {
+                BatchCount = PARALLEL_PRECISION_BATCH_COUNT;
+            }
+
+            // NOTE(casey): This has to stay exactly the same expression as in PrecisionTest
+            for(u32 Index = 0; Index < BatchCount; ++Index)
+            {
+                f64 tStep = (f64)(BatchFirst + Index) / (f64)(StepCount - 1);
+                Inputs[Index] = (1.0 - tStep)*MinInputValue + tStep*MaxInputValue;
+            }
+
+            Test->Func(Test->Context, BatchCount, Inputs, Expected, Outputs);
+
+            for(u32 CandidateIndex = 0; CandidateIndex < Test->CandidateCount; ++CandidateIndex)
+            {
+                math_test_result *Result = Results + CandidateIndex;
+                f64 *Output = Outputs + CandidateIndex*PARALLEL_PRECISION_BATCH_COUNT;
+                for(u32 Index = 0; Index < BatchCount; ++Index)
+                {
+                    f64 Diff = fabs(Expected[Index] - Output[Index]);
+                    Result->TotalDiff += Diff;
+                    ++Result->DiffCount;
+
+                    if(Result->MaxDiff < Diff)
+                    {
+                        Result->MaxDiff = Diff;
+                        Result->InputValueAtMaxDiff = Inputs[Index];
+                        Result->OutputValueAtMaxDiff = Output[Index];
+                        Result->ExpectedValueAtMaxDiff = Expected[Index];
+                    }
+                }
+            }
+        }
+    }
+}
+
+THREAD_ENTRY_POINT(PrecisionTestThread, Parameter)
+{
+    parallel_precision_test *Test = (parallel_precision_test *)Parameter;
+    RunPrecisionChunks(Test);
+    return 0;
+}
+
+static void FinishMergedPrecisionTest(math_tester *Tester, u32 ResultCount)
+{
+    // NOTE(casey): Let PrecisionTest close out the test as if it had just run its last step,
+    // so merged results are counted and printed exactly the way the serial tester does it.
+    // The results have already been written, so only the step count matters, not the inputs.
+    Tester->Testing = true;
+    Tester->StepIndex = 0;
+    Tester->ResultOffset = ResultCount;
+    PrecisionTest(Tester, 0, 0, 1);
+}
+
+inline void ParallelPrecisionTest(math_tester *Tester, f64 MinInputValue, f64 MaxInputValue, u32 StepCount,
+                                  u32 ThreadCount, precision_batch_func *Func, void *Context,
+                                  u32 CandidateCount, char const **Labels)
+{
+    /* NOTE(casey): Adds CandidateCount results to Tester, labeled with Labels,
+       just as if each candidate had had its own TestResult call inside a
+       PrecisionTest loop with these same arguments. */
+
+    if(CandidateCount > PARALLEL_PRECISION_MAX_CANDIDATE_COUNT)
+    {
+        fprintf(stderr, "WARNING: Only the first %u of %u candidates can be tested at once\n",
+                PARALLEL_PRECISION_MAX_CANDIDATE_COUNT, CandidateCount);
+        CandidateCount = PARALLEL_PRECISION_MAX_CANDIDATE_COUNT;
+    }
+
+    parallel_precision_test Test = {};
+    Test.Func = Func;
+    Test.Context = Context;
+    Test.CandidateCount = CandidateCount;
+    Test.MinInputValue = MinInputValue;
+    Test.MaxInputValue = MaxInputValue;
+    Test.StepCount = StepCount;
+    Test.ChunkCount = ((u64)StepCount + PARALLEL_PRECISION_CHUNK_STEP_COUNT - 1) / PARALLEL_PRECISION_CHUNK_STEP_COUNT;
+
+    buffer ChunkResultsBuffer = AllocateBuffer(Test.ChunkCount*CandidateCount*sizeof(math_test_result));
+    if(IsValid(ChunkResultsBuffer) && CandidateCount)
+    {
+        Test.ChunkResults = (math_test_result *)ChunkResultsBuffer.Data;
+
+        thread_handle Workers[256];
+        u32 WorkerCount = 0;
+        while(((WorkerCount + 1) < ThreadCount) && (WorkerCount < ArrayCount(Workers)))
+        {
+            thread_handle Worker = CreateAndStartThread(PrecisionTestThread, &Test);
+            if(!IsValidThread(Worker))
+            {
+                break;
+            }
+            Workers[WorkerCount++] = Worker;
+        }
+
+        RunPrecisionChunks(&Test);
+        for(u32 WorkerIndex = 0; WorkerIndex < WorkerCount; ++WorkerIndex)
+        {
+            WaitForThread(Workers[WorkerIndex]);
+        }
+
+        for(u32 CandidateIndex = 0; CandidateIndex < CandidateCount; ++CandidateIndex)
+        {
+            u32 ResultIndex = Tester->ResultCount + CandidateIndex;
+            math_test_result *Result = &Tester->ErrorResult;
+            if(ResultIndex < ArrayCount(Tester->Results))
+            {
+                Result = Tester->Results + ResultIndex;
+            }
+
+            *Result = {};
+            snprintf(Result->Label, sizeof(Result->Label), "%s", Labels[CandidateIndex]);
+
+            for(u64 ChunkIndex = 0; ChunkIndex < Test.ChunkCount; ++ChunkIndex)
+            {
+                math_test_result *Chunk = Test.ChunkResults + ChunkIndex*CandidateCount + CandidateIndex;
+                Result->TotalDiff += Chunk->TotalDiff;
+                Result->DiffCount += Chunk->DiffCount;
+                if(Result->MaxDiff < Chunk->MaxDiff)
+                {
+                    Result->MaxDiff = Chunk->MaxDiff;
+                    Result->InputValueAtMaxDiff = Chunk->InputValueAtMaxDiff;
+                    Result->OutputValueAtMaxDiff = Chunk->OutputValueAtMaxDiff;
+                    Result->ExpectedValueAtMaxDiff = Chunk->ExpectedValueAtMaxDiff;
+                }
+            }
+        }
+
+        FinishMergedPrecisionTest(Tester, CandidateCount);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate precision test results\n");
+    }
+
+    FreeBuffer(&ChunkResultsBuffer);
+}
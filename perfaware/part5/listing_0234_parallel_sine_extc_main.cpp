@@ -0,0 +1,228 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 234
+   ======================================================================== */
+
+/* NOTE(casey): The coefficient count sweep from listing 186, on the parallel
+   tester. With a small enough step count, it also runs the original serial
+   loop and checks that the two agree. */
+
+#include "listing_0250_math_prelude.cpp"
+#include "listing_0184_sine_coefficients.inl"
+#include "listing_0185_sine_extc.cpp"
+#include "listing_0233_parallel_math_check.cpp"
+
+#define SERIAL_COMPARE_MAX_STEP_COUNT 10000000
+
+struct sine_candidate
+{
+    u32 CCount;
+    f64 *C;
+    math_func *Func; // NOTE(casey): Used instead of C when it's set
+};
+
+struct sine_sweep
+{
+    u32 CandidateCount;
+    sine_candidate Candidates[3];
+    char Labels[3][64];
+    char const *LabelPointers[3];
+};
+
+static void OddPowerPolynomialC_N(u32 CCount, f64 *C, u32 Count, f64 const *In, f64 *Out)
+{
+    // NOTE(casey): Four lanes of OddPowerPolynomialC, with the same fma sequence, so it rounds identically
+    for(u32 Index = 0; Index < Count; Index += 4)
+    {
+        __m256i Mask = GetLoadMask4(Count - Index);
+        __m256d X = _mm256_maskload_pd(In + Index, Mask);
+        __m256d X2 = _mm256_mul_pd(X, X);
+
+        u32 CIndex = CCount;
+        __m256d R = _mm256_set1_pd(C[--CIndex]);
+        while(CIndex)
+        {
+            R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(C[--CIndex]));
+        }
+        R = _mm256_mul_pd(R, X);
+
+        _mm256_maskstore_pd(Out + Index, Mask, R);
+    }
+}
+
+static void SineSweepBatch(void *Context, u32 Count, f64 const *Inputs, f64 *Expected, f64 *Outputs)
+{
+    sine_sweep *Sweep = (sine_sweep *)Context;
+
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        Expected[Index] = sin(Inputs[Index]);
+    }
+
+    for(u32 CandidateIndex = 0; CandidateIndex < Sweep->CandidateCount; ++CandidateIndex)
+    {
+        sine_candidate Candidate = Sweep->Candidates[CandidateIndex];
+        f64 *Output = Outputs + CandidateIndex*PARALLEL_PRECISION_BATCH_COUNT;
+        if(Candidate.Func)
+        {
+            for(u32 Index = 0; Index < Count; ++Index)
+            {
+                Output[Index] = Candidate.Func(Inputs[Index]);
+            }
+        }
+        else
+        {
+            OddPowerPolynomialC_N(Candidate.CCount, Candidate.C, Count, Inputs, Output);
+        }
+    }
+}
+
+static void AddSineCandidate(sine_sweep *Sweep, u32 CCount, f64 *C, math_func *Func, char const *Format, ...)
+{
+    u32 Index = Sweep->CandidateCount++;
+    Sweep->Candidates[Index] = {CCount, C, Func};
+
+    va_list ArgList;
+    va_start(ArgList, Format);
+    vsnprintf(Sweep->Labels[Index], sizeof(Sweep->Labels[Index]), Format, ArgList);
+    va_end(ArgList);
+
+    Sweep->LabelPointers[Index] = Sweep->Labels[Index];
+}
+
+static sine_sweep GetSineSweep(u32 CCount)
+{
+    // NOTE(casey): The same candidates listing 186 tests for each coefficient count
+    sine_sweep Sweep = {};
+
+    if(CCount <= ArrayCount(SineRadiansC_Taylor))
+    {
+        AddSineCandidate(&Sweep, CCount, SineRadiansC_Taylor, 0, "Taylor[%u]", CCount);
+    }
+
+    if(CCount < ArrayCount(SineRadiansC_MFTWP))
+    {
+        AddSineCandidate(&Sweep, CCount, SineRadiansC_MFTWP[CCount], 0, "MFTWP[%u]", CCount);
+    }
+
+    if(CCount == 9)
+    {
+        AddSineCandidate(&Sweep, 0, 0, SineCore_Radians_MFTWP, "SineCore_Radians_MFTWP");
+    }
+
+    return Sweep;
+}
+
+static void SerialSineSweep(math_tester *Tester, u32 StepCount)
+{
+    for(u32 CCount = 2; CCount < 16; ++CCount)
+    {
+        while(PrecisionTest(Tester, 0, Pi64/2, StepCount))
+        {
+            f64 RefOutput = sin(Tester->InputValue);
+
+            if(CCount <= ArrayCount(SineRadiansC_Taylor))
+            {
+                TestResult(Tester, RefOutput, OddPowerPolynomialC(CCount, SineRadiansC_Taylor, Tester->InputValue), "Taylor[%u]", CCount);
+            }
+
+            if(CCount < ArrayCount(SineRadiansC_MFTWP))
+            {
+                TestResult(Tester, RefOutput, OddPowerPolynomialC(CCount, SineRadiansC_MFTWP[CCount], Tester->InputValue), "MFTWP[%u]", CCount);
+            }
+
+            if(CCount == 9)
+            {
+                TestResult(Tester, RefOutput, SineCore_Radians_MFTWP(Tester->InputValue), "SineCore_Radians_MFTWP");
+            }
+        }
+    }
+}
+
+int main(int ArgCount, char **Args)
+{
+    InitializeOSPlatform();
+
+    u32 StepCount = (ArgCount > 1) ? (u32)atoi(Args[1]) : 100000000;
+    u32 ThreadCount = GetCPUCoreCount();
+    if(StepCount < 2)
+    {
+        fprintf(stderr, "Usage: %s [step count, at least 2]\n", Args[0]);
+        return 1;
+    }
+
+    // NOTE(casey): math_tester is big, so these live on the heap
+    math_tester *ParallelTester = (math_tester *)calloc(1, sizeof(math_tester));
+    math_tester *SerialTester = (math_tester *)calloc(1, sizeof(math_tester));
+    if(ParallelTester && SerialTester)
+    {
+        u64 CPUFreq = GetCPUTimerFreq();
+
+        u64 ParallelStart = ReadCPUTimer();
+        for(u32 CCount = 2; CCount < 16; ++CCount)
+        {
+            sine_sweep Sweep = GetSineSweep(CCount);
+            ParallelPrecisionTest(ParallelTester, 0, Pi64/2, StepCount, ThreadCount, SineSweepBatch, &Sweep,
+                                  Sweep.CandidateCount, Sweep.LabelPointers);
+        }
+        u64 ParallelEnd = ReadCPUTimer();
+
+        PrintResults(ParallelTester);
+        fprintf(stdout, "\nParallel sweep: %.3fs on %u threads, %u steps\n",
+                (f64)(ParallelEnd - ParallelStart) / (f64)CPUFreq, ThreadCount, StepCount);
+
+        if(StepCount <= SERIAL_COMPARE_MAX_STEP_COUNT)
+        {
+            u64 SerialStart = ReadCPUTimer();
+            fprintf(stdout, "\nSerial sweep, for comparison:\n");
+            SerialSineSweep(SerialTester, StepCount);
+            u64 SerialEnd = ReadCPUTimer();
+            fprintf(stdout, "\nSerial sweep: %.3fs\n", (f64)(SerialEnd - SerialStart) / (f64)CPUFreq);
+
+            u32 MismatchCount = 0;
+            u32 TotalDiffMismatchCount = 0;
+            for(u32 ResultIndex = 0; ResultIndex < ParallelTester->ResultCount; ++ResultIndex)
+            {
+                math_test_result P = ParallelTester->Results[ResultIndex];
+                math_test_result S = SerialTester->Results[ResultIndex];
+                if((P.MaxDiff != S.MaxDiff) ||
+                   (P.DiffCount != S.DiffCount) ||
+                   (P.InputValueAtMaxDiff != S.InputValueAtMaxDiff) ||
+                   (P.OutputValueAtMaxDiff != S.OutputValueAtMaxDiff) ||
+                   (P.ExpectedValueAtMaxDiff != S.ExpectedValueAtMaxDiff) ||
+                   (strcmp(P.Label, S.Label) != 0))
+                {
+                    fprintf(stderr, "MISMATCH: %s does not match the serial result\n", P.Label);
+                    ++MismatchCount;
+                }
+
+                TotalDiffMismatchCount += (P.TotalDiff != S.TotalDiff);
+            }
+
+            if(SerialTester->ResultCount != ParallelTester->ResultCount)
+            {
+                fprintf(stderr, "MISMATCH: %u serial results, %u parallel results\n", SerialTester->ResultCount, ParallelTester->ResultCount);
+                ++MismatchCount;
+            }
+
+            fprintf(stdout, "%u of %u results differ from the serial tester (%u differ only in the last bits of TotalDiff)\n",
+                    MismatchCount, ParallelTester->ResultCount, TotalDiffMismatchCount);
+        }
+    }
+
+    free(ParallelTester);
+    free(SerialTester);
+
+    return 0;
+}
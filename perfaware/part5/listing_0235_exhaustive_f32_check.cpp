@@ -0,0 +1,421 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 235
+   ======================================================================== */
+
+/* NOTE(casey): For f32 functions, there is no need to sample - there are only
+   2^32 possible inputs, so every one of them can be checked. This tests every
+   float in a range (or every float, period), by walking an ordered integer key
+   for each float bit pattern. Keys are cut into chunks that threads grab one at
+   a time, and the functions under test are f32_batch_funcs, so they can be SIMD.
+
+   Errors are measured in f32 ULPs of the reference value, which is computed in
+   f64 by a math_batch_func from listing 231 and never rounded to f32, so a
+   correctly rounded function would score at most 0.5. Results go into the
+   math_tester as usual, with MaxDiff and TotalDiff in ULPs, and each candidate
+   also gets a histogram of its ULP errors.
+
+   Like listing 233, chunks are merged in key order, and a later max only
+   replaces an earlier one if it is strictly larger, so the worst-case input
+   reported is the lowest one and does not depend on the thread count. */
+
+#define EXHAUSTIVE_F32_CHUNK_KEY_COUNT (1024*1024)
+#define EXHAUSTIVE_F32_BATCH_COUNT 256
+#define EXHAUSTIVE_F32_MAX_CANDIDATE_COUNT 16
+
+// NOTE(casey): Bucket 0 is exact, 1 is <= 0.5 ULP, then 2+N is <= 2^N ULP up to 2^20,
+// then everything bigger, and finally errors that are infinite (including a NaN where
+// the reference was not NaN, or vice versa)
+#define ULP_HISTOGRAM_MAX_POWER 20
+#define ULP_HISTOGRAM_LARGE_BUCKET (ULP_HISTOGRAM_MAX_POWER + 3)
+#define ULP_HISTOGRAM_INFINITE_BUCKET (ULP_HISTOGRAM_MAX_POWER + 4)
+#define ULP_HISTOGRAM_BUCKET_COUNT (ULP_HISTOGRAM_MAX_POWER + 5)
+
+typedef void f32_batch_func(u64 Count, f32 const *In, f32 *Out);
+
+struct ulp_histogram
+{
+    u64 Counts[ULP_HISTOGRAM_BUCKET_COUNT];
+};
+
+struct exhaustive_f32_result
+{
+    f64 TotalULPs; // NOTE(casey): Infinite errors are left out of this, so the average stays meaningful
+    f64 MaxULPs;
+    u64 Count;
+
+    f32 InputAtMax;
+    f32 OutputAtMax;
+    f64 ExpectedAtMax;
+
+    ulp_histogram Histogram;
+};
+
+struct exhaustive_f32_test
+{
+    math_batch_func *Reference;
+    f32_batch_func **Candidates;
+    u32 CandidateCount;
+
+    u32 FirstKey;
+    u64 KeyCount;
+
+    u64 ChunkCount;
+    exhaustive_f32_result *ChunkResults; // NOTE(casey): ChunkCount*CandidateCount of them, chunk-major
+    u64 volatile NextChunkIndex;
+};
+
+//
+// NOTE(casey): Float ordering
+//
+
+inline u32 F32BitsFromKey(u32 Key)
+{
+    // NOTE(casey): Keys count up from the most negative NaN, through -0 and +0, to the most positive NaN
+    u32 Result = (Key & 0x80000000) ? (Key & 0x7fffffff) : ~Key;
+    return Result;
+}
+
+inline u32 KeyFromF32Bits(u32 Bits)
+{
+    u32 Result = (Bits & 0x80000000) ? ~Bits : (Bits | 0x80000000);
+    return Result;
+}
+
+inline f32 F32FromBits(u32 Bits)
+{
+    f32 Result;
+    memcpy(&Result, &Bits, sizeof(Result));
+    return Result;
+}
+
+inline u32 BitsFromF32(f32 Value)
+{
+    u32 Result;
+    memcpy(&Result, &Value, sizeof(Result));
+    return Result;
+}
+
+//
+// NOTE(casey): ULPs
+//
+
+inline f64 GetF32ULPError(f64 Expected, f32 Output)
+{
+    f64 Result = 0;
+
+    if(isnan(Expected) || isnan(Output))
+    {
+        Result = (isnan(Expected) && isnan(Output)) ? 0 : INFINITY;
+    }
+    else if(Expected != Output)
+    {
+        // NOTE(casey): The size of an f32 ULP at Expected. Below the normal range, f32 ULPs stop
+        // shrinking at 2^-149, and above it there are no f32s to round to, so those stay at 2^104.
+        u64 ExpectedBits;
+        memcpy(&ExpectedBits, &Expected, sizeof(ExpectedBits));
+        s32 Exponent = (s32)((ExpectedBits >> 52) & 0x7ff) - 1023;
+        if(Exponent < -126) Exponent = -126;
+        if(Exponent > 127) Exponent = 127;
+
+        u64 InvULPBits = (u64)(1023 + 23 - Exponent) << 52;
+        f64 InvULP;
+        memcpy(&InvULP, &InvULPBits, sizeof(InvULP));
+
+        Result = fabs(Expected - (f64)Output)*InvULP;
+    }
+
+    return Result;
+}
+
+inline u32 GetULPHistogramBucket(f64 ULPs)
+{
+    u32 Result = 0;
+    if(ULPs == INFINITY)
+    {
+        Result = ULP_HISTOGRAM_INFINITE_BUCKET;
+    }
+    else if(ULPs > 0)
+    {
+        Result = 1;
+        f64 Limit = 0.5;
+        while((Result < ULP_HISTOGRAM_LARGE_BUCKET) && (ULPs > Limit))
+        {
+            ++Result;
+            Limit *= 2.0;
+        }
+    }
+
+    return Result;
+}
+
+static void GetULPHistogramBucketLabel(u32 Bucket, char *Dest, size_t DestSize)
+{
+    if(Bucket == 0)
+    {
+        snprintf(Dest, DestSize, "exact");
+    }
+    else if(Bucket == 1)
+    {
+        snprintf(Dest, DestSize, "<= 0.5");
+    }
+    else if(Bucket < ULP_HISTOGRAM_LARGE_BUCKET)
+    {
+        snprintf(Dest, DestSize, "<= %u", 1u << (Bucket - 2));
+    }
+    else if(Bucket == ULP_HISTOGRAM_LARGE_BUCKET)
+    {
+        snprintf(Dest, DestSize, "> %u", 1u << ULP_HISTOGRAM_MAX_POWER);
+    }
+    else
+    {
+        snprintf(Dest, DestSize, "inf/NaN");
+    }
+}
+
+//
+// NOTE(casey): Testing
+//
+
+static void RunExhaustiveF32Chunks(exhaustive_f32_test *Test)
+{
+    f32 Inputs[EXHAUSTIVE_F32_BATCH_COUNT];
+    f64 WideInputs[EXHAUSTIVE_F32_BATCH_COUNT];
+    f64 Expected[EXHAUSTIVE_F32_BATCH_COUNT];
+    f32 Outputs[EXHAUSTIVE_F32_BATCH_COUNT];
+
+    for(;;)
+    {
+        u64 ChunkIndex = AtomicAddU64(&Test->NextChunkIndex, 1);
+        if(ChunkIndex >= Test->ChunkCount)
+        {
+            break;
+        }
+
+        exhaustive_f32_result *Results = Test->ChunkResults + ChunkIndex*Test->CandidateCount;
+        u64 ChunkFirst = ChunkIndex*EXHAUSTIVE_F32_CHUNK_KEY_COUNT;
+        u64 ChunkEnd = ChunkFirst + EXHAUSTIVE_F32_CHUNK_KEY_COUNT;
+        if(ChunkEnd > Test->KeyCount)
+        {
+            ChunkEnd = Test->KeyCount;
+        }
+
+        for(u64 BatchFirst = ChunkFirst; BatchFirst < ChunkEnd; BatchFirst += EXHAUSTIVE_F32_BATCH_COUNT)
+        {
+            u32 BatchCount = (u32)(ChunkEnd - BatchFirst);
+            if(BatchCount > EXHAUSTIVE_F32_BATCH_COUNT)
+            {
+                BatchCount = EXHAUSTIVE_F32_BATCH_COUNT;
+            }
+
+            u32 FirstKey = Test->FirstKey + (u32)BatchFirst;
+            for(u32 Index = 0; Index < BatchCount; ++Index)
+            {
+                Inputs[Index] = F32FromBits(F32BitsFromKey(FirstKey + Index));
+                WideInputs[Index] = (f64)Inputs[Index];
+            }
+
+            Test->Reference(BatchCount, WideInputs, Expected);
+
+            for(u32 CandidateIndex = 0; CandidateIndex < Test->CandidateCount; ++CandidateIndex)
+            {
+                exhaustive_f32_result *Result = Results + CandidateIndex;
+                Test->Candidates[CandidateIndex](BatchCount, Inputs, Outputs);
+
+                for(u32 Index = 0; Index < BatchCount; ++Index)
+                {
+                    f64 ULPs = GetF32ULPError(Expected[Index], Outputs[Index]);
+                    ++Result->Histogram.Counts[GetULPHistogramBucket(ULPs)];
+                    ++Result->Count;
+                    if(ULPs != INFINITY)
+                    {
+                        Result->TotalULPs += ULPs;
+                    }
+
+                    if(Result->MaxULPs < ULPs)
+                    {
+                        Result->MaxULPs = ULPs;
+                        Result->InputAtMax = Inputs[Index];
+                        Result->OutputAtMax = Outputs[Index];
+                        Result->ExpectedAtMax = Expected[Index];
+                    }
+                }
+            }
+        }
+    }
+}
+
+THREAD_ENTRY_POINT(ExhaustiveF32Thread, Parameter)
+{
+    exhaustive_f32_test *Test = (exhaustive_f32_test *)Parameter;
+    RunExhaustiveF32Chunks(Test);
+    return 0;
+}
+
+static void PrintULPHistogram(char const *Label, ulp_histogram *Histogram)
+{
+    u64 Total = 0;
+    for(u32 Bucket = 0; Bucket < ULP_HISTOGRAM_BUCKET_COUNT; ++Bucket)
+    {
+        Total += Histogram->Counts[Bucket];
+    }
+
+    printf("%s:\n", Label);
+    for(u32 Bucket = 0; Bucket < ULP_HISTOGRAM_BUCKET_COUNT; ++Bucket)
+    {
+        u64 Count = Histogram->Counts[Bucket];
+        if(Count)
+        {
+            char BucketLabel[32];
+            GetULPHistogramBucketLabel(Bucket, BucketLabel, sizeof(BucketLabel));
+            printf("  %10s ULP: %10llu (%.6f%%)\n", BucketLabel, (unsigned long long)Count, 100.0*(f64)Count / (f64)Total);
+        }
+    }
+}
+
+static void ExhaustiveF32TestKeys(math_tester *Tester, u32 FirstKey, u64 KeyCount, u32 ThreadCount,
+                                  math_batch_func *Reference, u32 CandidateCount, f32_batch_func **Candidates,
+                                  char const **Labels, ulp_histogram *Histograms)
+{
+    /* NOTE(casey): Adds CandidateCount results to Tester, with MaxDiff and TotalDiff in ULPs,
+       and fills in one histogram per candidate in Histograms, if it is not null. */
+
+    if(CandidateCount > EXHAUSTIVE_F32_MAX_CANDIDATE_COUNT)
+    {
+        fprintf(stderr, "WARNING: Only the first %u of %u candidates can be tested at once\n",
+                EXHAUSTIVE_F32_MAX_CANDIDATE_COUNT, CandidateCount);
+        CandidateCount = EXHAUSTIVE_F32_MAX_CANDIDATE_COUNT;
+    }
+
+    exhaustive_f32_test Test = {};
+    Test.Reference = Reference;
+    Test.Candidates = Candidates;
+    Test.CandidateCount = CandidateCount;
+    Test.FirstKey = FirstKey;
+    Test.KeyCount = KeyCount;
+    Test.ChunkCount = (KeyCount + EXHAUSTIVE_F32_CHUNK_KEY_COUNT - 1) / EXHAUSTIVE_F32_CHUNK_KEY_COUNT;
+
+    buffer ChunkResultsBuffer = AllocateBuffer(Test.ChunkCount*CandidateCount*sizeof(exhaustive_f32_result));
+    if(IsValid(ChunkResultsBuffer) && CandidateCount)
+    {
+        Test.ChunkResults = (exhaustive_f32_result *)ChunkResultsBuffer.Data;
+
+        thread_handle Workers[256];
+        u32 WorkerCount = 0;
+        while(((WorkerCount + 1) < ThreadCount) && (WorkerCount < ArrayCount(Workers)))
+        {
+            thread_handle Worker = CreateAndStartThread(ExhaustiveF32Thread, &Test);
+            if(!IsValidThread(Worker))
+            {
+                break;
+            }
+            Workers[WorkerCount++] = Worker;
+        }
+
+        RunExhaustiveF32Chunks(&Test);
+        for(u32 WorkerIndex = 0; WorkerIndex < WorkerCount; ++WorkerIndex)
+        {
+            WaitForThread(Workers[WorkerIndex]);
+        }
+
+        for(u32 CandidateIndex = 0; CandidateIndex < CandidateCount; ++CandidateIndex)
+        {
+            exhaustive_f32_result Merged = {};
+            for(u64 ChunkIndex = 0; ChunkIndex < Test.ChunkCount; ++ChunkIndex)
+            {
+                exhaustive_f32_result *Chunk = Test.ChunkResults + ChunkIndex*CandidateCount + CandidateIndex;
+                Merged.TotalULPs += Chunk->TotalULPs;
+                Merged.Count += Chunk->Count;
+                if(Merged.MaxULPs < Chunk->MaxULPs)
+                {
+                    Merged.MaxULPs = Chunk->MaxULPs;
+                    Merged.InputAtMax = Chunk->InputAtMax;
+                    Merged.OutputAtMax = Chunk->OutputAtMax;
+                    Merged.ExpectedAtMax = Chunk->ExpectedAtMax;
+                }
+
+                for(u32 Bucket = 0; Bucket < ULP_HISTOGRAM_BUCKET_COUNT; ++Bucket)
+                {
+                    Merged.Histogram.Counts[Bucket] += Chunk->Histogram.Counts[Bucket];
+                }
+            }
+
+            u32 ResultIndex = Tester->ResultCount + CandidateIndex;
+            math_test_result *Result = &Tester->ErrorResult;
+            if(ResultIndex < ArrayCount(Tester->Results))
+            {
+                Result = Tester->Results + ResultIndex;
+            }
+
+            *Result = {};
+            snprintf(Result->Label, sizeof(Result->Label), "%s", Labels[CandidateIndex]);
+            Result->MaxDiff = Merged.MaxULPs;
+            Result->InputValueAtMaxDiff = Merged.InputAtMax;
+            Result->OutputValueAtMaxDiff = Merged.OutputAtMax;
+            Result->ExpectedValueAtMaxDiff = Merged.ExpectedAtMax;
+
+            // NOTE(casey): DiffCount is only 32 bits, and all the floats is 2^32 of them,
+            // so both halves of the average get scaled down until the count fits
+            f64 TotalDiff = Merged.TotalULPs;
+            u64 DiffCount = Merged.Count;
+            while(DiffCount > 0xffffffff)
+            {
+                DiffCount >>= 1;
+                TotalDiff *= 0.5;
+            }
+            Result->TotalDiff = TotalDiff;
+            Result->DiffCount = (u32)DiffCount;
+
+            if(Histograms)
+            {
+                Histograms[CandidateIndex] = Merged.Histogram;
+            }
+        }
+
+        FinishMergedPrecisionTest(Tester, CandidateCount);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate exhaustive test results\n");
+    }
+
+    FreeBuffer(&ChunkResultsBuffer);
+}
+
+static void ExhaustiveF32Test(math_tester *Tester, f32 MinInputValue, f32 MaxInputValue, u32 ThreadCount,
+                              math_batch_func *Reference, u32 CandidateCount, f32_batch_func **Candidates,
+                              char const **Labels, ulp_histogram *Histograms = 0)
+{
+    // NOTE(casey): Every float from MinInputValue to MaxInputValue, inclusive, so a range spanning zero tests both -0 and +0
+    u32 FirstKey = KeyFromF32Bits(BitsFromF32(MinInputValue));
+    u32 LastKey = KeyFromF32Bits(BitsFromF32(MaxInputValue));
+    if(FirstKey <= LastKey)
+    {
+        ExhaustiveF32TestKeys(Tester, FirstKey, (u64)(LastKey - FirstKey) + 1, ThreadCount,
+                              Reference, CandidateCount, Candidates, Labels, Histograms);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Exhaustive test range [%a, %a] is empty\n", MinInputValue, MaxInputValue);
+    }
+}
+
+static void ExhaustiveF32TestAll(math_tester *Tester, u32 ThreadCount,
+                                 math_batch_func *Reference, u32 CandidateCount, f32_batch_func **Candidates,
+                                 char const **Labels, ulp_histogram *Histograms = 0)
+{
+    // NOTE(casey): Every bit pattern, NaNs and infinities included
+    ExhaustiveF32TestKeys(Tester, 0, (u64)1 << 32, ThreadCount,
+                          Reference, CandidateCount, Candidates, Labels, Histograms);
+}
@@ -0,0 +1,187 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 236
+   ======================================================================== */
+
+/* NOTE(casey): Checks every float the f32 functions from listing 219 are
+   meant to handle, or every float in a range given on the command line, or
+   every float there is. The scalar and AVX2 versions are tested side by side,
+   so if they don't round identically, it shows up as two separate results. */
+
+#include "listing_0250_math_prelude.cpp"
+#include "listing_0203_columnar_haversine.cpp" // NOTE(casey): Listing 219 is built on the haversine columns
+#include "listing_0219_f32_haversine.cpp"
+#include "listing_0231_math_batch.cpp"
+#include "listing_0233_parallel_math_check.cpp"
+#include "listing_0235_exhaustive_f32_check.cpp"
+
+#define MATH_BATCH_LIBM(Name, LibmFunc) \
+static void Name(u64 Count, f64 const *In, f64 *Out) \
+{ \
+    for(u64 Index = 0; Index < Count; ++Index) \
+    { \
+        Out[Index] = LibmFunc(In[Index]); \
+    } \
+}
+
+#define F32_BATCH_SCALAR(Name, ScalarFunc) \
+static void Name(u64 Count, f32 const *In, f32 *Out) \
+{ \
+    for(u64 Index = 0; Index < Count; ++Index) \
+    { \
+        Out[Index] = ScalarFunc(In[Index]); \
+    } \
+}
+
+#define F32_BATCH_AVX2(Name, VectorFunc) \
+static void Name(u64 Count, f32 const *In, f32 *Out) \
+{ \
+    for(u64 Index = 0; Index < Count; Index += 8) \
+    { \
+        __m256i Mask = GetLoadMask8f(Count - Index); \
+        __m256 X = _mm256_maskload_ps(In + Index, Mask); \
+        _mm256_maskstore_ps(Out + Index, Mask, VectorFunc(X)); \
+    } \
+}
+
+inline __m256i GetLoadMask8f(u64 Count)
+{
+    __m256i Lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256i Result = _mm256_cmpgt_epi32(_mm256_set1_epi32((Count < 8) ? (s32)Count : 8), Lanes);
+    return Result;
+}
+
+inline __m256 SqrtCE8f(__m256 X)
+{
+    __m256 Result = _mm256_sqrt_ps(X);
+    return Result;
+}
+
+MATH_BATCH_LIBM(SinLibm_N, sin)
+MATH_BATCH_LIBM(ASinLibm_N, asin)
+MATH_BATCH_LIBM(SqrtLibm_N, sqrt)
+
+F32_BATCH_SCALAR(SinCE32_N, SinCE32)
+F32_BATCH_SCALAR(ASinCE32_N, ASinCE32)
+F32_BATCH_SCALAR(SqrtCE32_N, SqrtCE32)
+
+F32_BATCH_AVX2(SinCE8f_N, SinCE8f)
+F32_BATCH_AVX2(ASinCE8f_N, ASinCE8f)
+F32_BATCH_AVX2(SqrtCE8f_N, SqrtCE8f)
+
+struct exhaustive_f32_function
+{
+    char const *Name;
+    math_batch_func *Reference;
+    f32 MinInput;
+    f32 MaxInput;
+    f32_batch_func *Candidates[2];
+    char const *Labels[2];
+};
+
+static exhaustive_f32_function ExhaustiveFunctions[] =
+{
+    {"SinCE32", SinLibm_N, -(f32)Pi64, (f32)Pi64, {SinCE32_N, SinCE8f_N}, {"SinCE32 Scalar", "SinCE32 AVX2"}},
+    {"ASinCE32", ASinLibm_N, -1.0f, 1.0f, {ASinCE32_N, ASinCE8f_N}, {"ASinCE32 Scalar", "ASinCE32 AVX2"}},
+    {"SqrtCE32", SqrtLibm_N, 0.0f, INFINITY, {SqrtCE32_N, SqrtCE8f_N}, {"SqrtCE32 Scalar", "SqrtCE32 AVX2"}},
+};
+
+int main(int ArgCount, char **Args)
+{
+    InitializeOSPlatform();
+
+    b32 AllFloats = ((ArgCount == 2) && (strcmp(Args[1], "all") == 0));
+    b32 GivenRange = (ArgCount == 3);
+    if(!((ArgCount == 1) || AllFloats || GivenRange))
+    {
+        fprintf(stderr, "Usage: %s [all | [min input] [max input]]\n", Args[0]);
+        fprintf(stderr, "       With no arguments, each function is tested over every float in its input range.\n");
+        return 1;
+    }
+
+    u32 ThreadCount = GetCPUCoreCount();
+    u64 CPUFreq = GetCPUTimerFreq();
+
+    math_tester *Tester = (math_tester *)calloc(1, sizeof(math_tester));
+    if(Tester)
+    {
+        ulp_histogram Histograms[ArrayCount(ExhaustiveFunctions)][2] = {};
+        for(u32 FunctionIndex = 0; FunctionIndex < ArrayCount(ExhaustiveFunctions); ++FunctionIndex)
+        {
+            exhaustive_f32_function *Function = ExhaustiveFunctions + FunctionIndex;
+            u32 CandidateCount = ArrayCount(Function->Candidates);
+
+            u64 StartTime = ReadCPUTimer();
+            f32 MinInput = Function->MinInput;
+            f32 MaxInput = Function->MaxInput;
+            u64 FloatCount = 0;
+            if(AllFloats)
+            {
+                ExhaustiveF32TestAll(Tester, ThreadCount, Function->Reference, CandidateCount, Function->Candidates,
+                                     Function->Labels, Histograms[FunctionIndex]);
+                FloatCount = (u64)1 << 32;
+            }
+            else
+            {
+                if(GivenRange)
+                {
+                    MinInput = (f32)atof(Args[1]);
+                    MaxInput = (f32)atof(Args[2]);
+                }
+
+                ExhaustiveF32Test(Tester, MinInput, MaxInput, ThreadCount, Function->Reference, CandidateCount, Function->Candidates,
+                                  Function->Labels, Histograms[FunctionIndex]);
+                FloatCount = (u64)KeyFromF32Bits(BitsFromF32(MaxInput)) - (u64)KeyFromF32Bits(BitsFromF32(MinInput)) + 1;
+            }
+            u64 EndTime = ReadCPUTimer();
+
+            f64 Seconds = (f64)(EndTime - StartTime) / (f64)CPUFreq;
+            if(AllFloats)
+            {
+                fprintf(stdout, "%s: all floats", Function->Name);
+            }
+            else
+            {
+                fprintf(stdout, "%s: [%a, %a]", Function->Name, MinInput, MaxInput);
+            }
+            fprintf(stdout, ", %llu floats in %.3fs on %u threads (%.0f million floats/s per candidate)\n",
+                    (unsigned long long)FloatCount, Seconds, ThreadCount, (f64)FloatCount / (Seconds*1000000.0));
+        }
+
+        PrintResults(Tester);
+
+        fprintf(stdout, "\nULP error distribution:\n");
+        for(u32 FunctionIndex = 0; FunctionIndex < ArrayCount(ExhaustiveFunctions); ++FunctionIndex)
+        {
+            exhaustive_f32_function *Function = ExhaustiveFunctions + FunctionIndex;
+            for(u32 CandidateIndex = 0; CandidateIndex < ArrayCount(Function->Candidates); ++CandidateIndex)
+            {
+                PrintULPHistogram(Function->Labels[CandidateIndex], &Histograms[FunctionIndex][CandidateIndex]);
+            }
+        }
+
+        fprintf(stdout, "\nWorst-case inputs:\n");
+        for(u32 ResultIndex = 0; ResultIndex < Tester->ResultCount; ++ResultIndex)
+        {
+            math_test_result Result = Tester->Results[ResultIndex];
+            fprintf(stdout, "  %s: %.2f ULP at %a (0x%08x) - got %a, expected %.17g\n",
+                    Result.Label, Result.MaxDiff, Result.InputValueAtMaxDiff, BitsFromF32((f32)Result.InputValueAtMaxDiff),
+                    Result.OutputValueAtMaxDiff, Result.ExpectedValueAtMaxDiff);
+        }
+    }
+
+    free(Tester);
+
+    return 0;
+}
@@ -0,0 +1,593 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 237
+   ======================================================================== */
+
+/* NOTE(casey): A Remez exchange, for making our own minimax coefficient tables
+   instead of relying on donated ones. Everything is done in double-double,
+   because the errors we care about are right down at the f64 rounding level,
+   and the errors of an f64 solve would be just as big as the errors we are
+   trying to minimize. long double would have been simpler, but MSVC makes it
+   the same as double, so it wouldn't help on Windows.
+
+   The polynomial can be odd (x*P(x^2)), even (P(x^2)) or any (P(x)), and the
+   error being minimized is the absolute error, since that's what math_tester
+   measures. */
+
+#define REMEZ_MAX_TERM_COUNT 24
+#define REMEZ_MAX_ITERATION_COUNT 64
+#define REMEZ_GRID_POINTS_PER_TERM 2048
+#define REMEZ_REFINE_ITERATION_COUNT 64
+
+//
+// NOTE(casey): Double-double arithmetic
+//
+
+struct double_double
+{
+    f64 Hi;
+    f64 Lo;
+};
+
+inline double_double DD(f64 Value)
+{
+    double_double Result = {Value, 0};
+    return Result;
+}
+
+inline double_double QuickTwoSum(f64 A, f64 B)
+{
+    // NOTE(casey): Only valid when |A| >= |B|
+    double_double Result;
+    Result.Hi = A + B;
+    Result.Lo = B - (Result.Hi - A);
+    return Result;
+}
+
+inline double_double TwoSum(f64 A, f64 B)
+{
+    double_double Result;
+    Result.Hi = A + B;
+    f64 BB = Result.Hi - A;
+    Result.Lo = (A - (Result.Hi - BB)) + (B - BB);
+    return Result;
+}
+
+inline double_double TwoProduct(f64 A, f64 B)
+{
+    double_double Result;
+    Result.Hi = A*B;
+    Result.Lo = fma(A, B, -Result.Hi);
+    return Result;
+}
+
+inline double_double operator-(double_double A)
+{
+    double_double Result = {-A.Hi, -A.Lo};
+    return Result;
+}
+
+inline double_double operator+(double_double A, double_double B)
+{
+    double_double S = TwoSum(A.Hi, B.Hi);
+    double_double T = TwoSum(A.Lo, B.Lo);
+    S.Lo += T.Hi;
+    S = QuickTwoSum(S.Hi, S.Lo);
+    S.Lo += T.Lo;
+    double_double Result = QuickTwoSum(S.Hi, S.Lo);
+    return Result;
+}
+
+inline double_double operator-(double_double A, double_double B)
+{
+    double_double Result = A + (-B);
+    return Result;
+}
+
+inline double_double operator*(double_double A, double_double B)
+{
+    double_double P = TwoProduct(A.Hi, B.Hi);
+    P.Lo += A.Hi*B.Lo + A.Lo*B.Hi;
+    double_double Result = QuickTwoSum(P.Hi, P.Lo);
+    return Result;
+}
+
+inline double_double operator/(double_double A, double_double B)
+{
+    // NOTE(casey): Long division, one f64 quotient digit at a time
+    f64 Q0 = A.Hi / B.Hi;
+    double_double R = A - DD(Q0)*B;
+    f64 Q1 = R.Hi / B.Hi;
+    R = R - DD(Q1)*B;
+    f64 Q2 = R.Hi / B.Hi;
+
+    double_double Result = QuickTwoSum(Q0, Q1) + DD(Q2);
+    return Result;
+}
+
+inline f64 AbsDD(double_double A)
+{
+    // NOTE(casey): Only ever used for comparing magnitudes, so the low part isn't needed
+    f64 Result = fabs(A.Hi + A.Lo);
+    return Result;
+}
+
+//
+// NOTE(casey): Double-double reference functions
+//
+
+typedef double_double dd_math_func(double_double);
+
+static double_double SinDD(double_double X)
+{
+    // NOTE(casey): Straight Taylor series. Only meant for |X| <= pi or so, where the
+    // terms never get big enough for the cancellation to cost more than a few bits.
+    double_double X2 = X*X;
+    double_double Term = X;
+    double_double Result = X;
+    for(u32 K = 1; K < 64; ++K)
+    {
+        Term = -(Term*X2) / DD((f64)((2*K)*(2*K + 1)));
+        Result = Result + Term;
+        if(fabs(Term.Hi) < 1e-36*fabs(Result.Hi))
+        {
+            break;
+        }
+    }
+
+    return Result;
+}
+
+static double_double CosDD(double_double X)
+{
+    double_double X2 = X*X;
+    double_double Term = DD(1.0);
+    double_double Result = DD(1.0);
+    for(u32 K = 1; K < 64; ++K)
+    {
+        Term = -(Term*X2) / DD((f64)((2*K - 1)*(2*K)));
+        Result = Result + Term;
+        if(fabs(Term.Hi) < 1e-36*fabs(Result.Hi))
+        {
+            break;
+        }
+    }
+
+    return Result;
+}
+
+static double_double ASinDD(double_double X)
+{
+    // NOTE(casey): Newton's method on sin(Y) - X = 0, starting from the f64 answer.
+    // Each step doubles the good bits, so two are plenty. At +/-1 the derivative
+    // is zero, so those are special-cased.
+    double_double HalfPi = {0x1.921fb54442d18p0, 0x1.1a62633145c07p-54};
+
+    double_double Result;
+    if(X.Hi >= 1.0)
+    {
+        Result = HalfPi;
+    }
+    else if(X.Hi <= -1.0)
+    {
+        Result = -HalfPi;
+    }
+    else
+    {
+        Result = DD(asin(X.Hi));
+        for(u32 Iteration = 0; Iteration < 2; ++Iteration)
+        {
+            Result = Result - (SinDD(Result) - X) / CosDD(Result);
+        }
+    }
+
+    return Result;
+}
+
+//
+// NOTE(casey): Polynomials
+//
+
+enum remez_structure
+{
+    RemezStructure_Any,
+    RemezStructure_Even,
+    RemezStructure_Odd,
+};
+
+static char const *RemezStructureNames[] = {"any", "even", "odd"};
+
+struct remez_polynomial
+{
+    remez_structure Structure;
+    u32 TermCount;
+    f64 MinInput;
+    f64 MaxInput;
+
+    double_double C[REMEZ_MAX_TERM_COUNT];
+
+    double_double LevelError; // NOTE(casey): The E of the last exchange
+    f64 MaxError; // NOTE(casey): Measured on a dense grid, with the coefficients rounded to f64
+    u32 IterationCount;
+    b32 Converged;
+};
+
+inline double_double EvaluatePolynomialDD(remez_structure Structure, u32 TermCount, double_double *C, double_double X)
+{
+    double_double V = (Structure == RemezStructure_Any) ? X : X*X;
+
+    double_double R = C[TermCount - 1];
+    for(u32 Index = TermCount - 1; Index > 0; --Index)
+    {
+        R = R*V + C[Index - 1];
+    }
+
+    if(Structure == RemezStructure_Odd)
+    {
+        R = R*X;
+    }
+
+    return R;
+}
+
+inline f64 EvaluatePolynomial(remez_structure Structure, u32 TermCount, f64 *C, f64 X)
+{
+    // NOTE(casey): The same fma chain OddPowerPolynomialC uses, for all three structures
+    f64 V = (Structure == RemezStructure_Any) ? X : X*X;
+
+    f64 R = C[TermCount - 1];
+    for(u32 Index = TermCount - 1; Index > 0; --Index)
+    {
+        R = fma(R, V, C[Index - 1]);
+    }
+
+    if(Structure == RemezStructure_Odd)
+    {
+        R *= X;
+    }
+
+    return R;
+}
+
+inline u32 GetTermPower(remez_structure Structure, u32 TermIndex)
+{
+    u32 Result = (Structure == RemezStructure_Odd) ? (2*TermIndex + 1) :
+        (Structure == RemezStructure_Even) ? (2*TermIndex) : TermIndex;
+    return Result;
+}
+
+static double_double PowerDD(double_double X, u32 Power)
+{
+    double_double Result = DD(1.0);
+    for(u32 Index = 0; Index < Power; ++Index)
+    {
+        Result = Result*X;
+    }
+
+    return Result;
+}
+
+inline double_double GetErrorDD(remez_polynomial *Poly, dd_math_func *Func, f64 X)
+{
+    double_double XDD = DD(X);
+    double_double Result = EvaluatePolynomialDD(Poly->Structure, Poly->TermCount, Poly->C, XDD) - Func(XDD);
+    return Result;
+}
+
+//
+// NOTE(casey): Remez exchange
+//
+
+static b32 SolveRemezSystem(remez_polynomial *Poly, dd_math_func *Func, f64 *Points)
+{
+    /* NOTE(casey): Solves P(x_i) + (-1)^i E = f(x_i) for the coefficients and E,
+       with Gaussian elimination and partial pivoting. */
+
+    u32 N = Poly->TermCount + 1;
+    double_double M[REMEZ_MAX_TERM_COUNT + 1][REMEZ_MAX_TERM_COUNT + 2];
+
+    for(u32 Row = 0; Row < N; ++Row)
+    {
+        double_double X = DD(Points[Row]);
+        for(u32 Col = 0; Col < Poly->TermCount; ++Col)
+        {
+            M[Row][Col] = PowerDD(X, GetTermPower(Poly->Structure, Col));
+        }
+        M[Row][N - 1] = DD((Row & 1) ? -1.0 : 1.0);
+        M[Row][N] = Func(X);
+    }
+
+    b32 Result = true;
+    for(u32 Pivot = 0; Result && (Pivot < N); ++Pivot)
+    {
+        u32 BestRow = Pivot;
+        for(u32 Row = Pivot + 1; Row < N; ++Row)
+        {
+            if(AbsDD(M[Row][Pivot]) > AbsDD(M[BestRow][Pivot]))
+            {
+                BestRow = Row;
+            }
+        }
+
+        if(M[BestRow][Pivot].Hi == 0)
+        {
+            Result = false;
+        }
+        else
+        {
+            for(u32 Col = 0; Col <= N; ++Col)
+            {
+                double_double Temp = M[Pivot][Col];
+                M[Pivot][Col] = M[BestRow][Col];
+                M[BestRow][Col] = Temp;
+            }
+
+            for(u32 Row = Pivot + 1; Row < N; ++Row)
+            {
+                double_double Factor = M[Row][Pivot] / M[Pivot][Pivot];
+                for(u32 Col = Pivot; Col <= N; ++Col)
+                {
+                    M[Row][Col] = M[Row][Col] - Factor*M[Pivot][Col];
+                }
+            }
+        }
+    }
+
+    if(Result)
+    {
+        double_double Solution[REMEZ_MAX_TERM_COUNT + 1];
+        for(u32 Row = N; Row > 0; --Row)
+        {
+            double_double Sum = M[Row - 1][N];
+            for(u32 Col = Row; Col < N; ++Col)
+            {
+                Sum = Sum - M[Row - 1][Col]*Solution[Col];
+            }
+            Solution[Row - 1] = Sum / M[Row - 1][Row - 1];
+        }
+
+        for(u32 Index = 0; Index < Poly->TermCount; ++Index)
+        {
+            Poly->C[Index] = Solution[Index];
+        }
+        Poly->LevelError = Solution[N - 1];
+    }
+
+    return Result;
+}
+
+static f64 RefineExtremum(remez_polynomial *Poly, dd_math_func *Func, f64 Min, f64 Max)
+{
+    // NOTE(casey): Golden section search for the biggest |error| between two grid points
+    f64 InvPhi = 0.6180339887498948482;
+    f64 A = Min;
+    f64 B = Max;
+    f64 C = B - InvPhi*(B - A);
+    f64 D = A + InvPhi*(B - A);
+    f64 EC = AbsDD(GetErrorDD(Poly, Func, C));
+    f64 ED = AbsDD(GetErrorDD(Poly, Func, D));
+    for(u32 Iteration = 0; Iteration < REMEZ_REFINE_ITERATION_COUNT; ++Iteration)
+    {
+        if(EC > ED)
+        {
+            B = D;
+            D = C;
+            ED = EC;
+            C = B - InvPhi*(B - A);
+            EC = AbsDD(GetErrorDD(Poly, Func, C));
+        }
+        else
+        {
+            A = C;
+            C = D;
+            EC = ED;
+            D = A + InvPhi*(B - A);
+            ED = AbsDD(GetErrorDD(Poly, Func, D));
+        }
+    }
+
+    // NOTE(casey): The ends of the search range might be better than anything inside it
+    f64 Result = (EC > ED) ? C : D;
+    f64 EResult = (EC > ED) ? EC : ED;
+    if(AbsDD(GetErrorDD(Poly, Func, Min)) > EResult)
+    {
+        Result = Min;
+        EResult = AbsDD(GetErrorDD(Poly, Func, Min));
+    }
+    if(AbsDD(GetErrorDD(Poly, Func, Max)) > EResult)
+    {
+        Result = Max;
+    }
+
+    return Result;
+}
+
+static f64 GetGridPoint(remez_polynomial *Poly, u32 Index, u32 GridCount)
+{
+    f64 t = (f64)Index / (f64)(GridCount - 1);
+    f64 Result = (1.0 - t)*Poly->MinInput + t*Poly->MaxInput;
+    return Result;
+}
+
+static b32 ExchangeRemezPoints(remez_polynomial *Poly, dd_math_func *Func, f64 *Points)
+{
+    /* NOTE(casey): Finds the biggest |error| in every run of same-signed error on
+       a dense grid, refines each one, and then trims runs off whichever end is
+       smaller until there are exactly TermCount + 1 of them. Points where the
+       error is exactly zero (like x = 0 for an odd function) don't start a run. */
+
+    u32 GridCount = REMEZ_GRID_POINTS_PER_TERM*(Poly->TermCount + 1);
+    u32 MaxExtremumCount = 4*REMEZ_MAX_TERM_COUNT;
+    u32 ExtremumCount = 0;
+    f64 Extrema[4*REMEZ_MAX_TERM_COUNT];
+    f64 ExtremumErrors[4*REMEZ_MAX_TERM_COUNT];
+    u32 ExtremumGridIndex[4*REMEZ_MAX_TERM_COUNT];
+
+    f64 RunSign = 0;
+    for(u32 GridIndex = 0; GridIndex < GridCount; ++GridIndex)
+    {
+        f64 X = GetGridPoint(Poly, GridIndex, GridCount);
+        double_double Error = GetErrorDD(Poly, Func, X);
+        f64 E = Error.Hi + Error.Lo;
+        if(E != 0)
+        {
+            f64 Sign = (E < 0) ? -1.0 : 1.0;
+            if(Sign != RunSign)
+            {
+                if(ExtremumCount == MaxExtremumCount)
+                {
+                    break;
+                }
+
+                RunSign = Sign;
+                ExtremumErrors[ExtremumCount] = 0;
+                ++ExtremumCount;
+            }
+
+            if(fabs(E) > ExtremumErrors[ExtremumCount - 1])
+            {
+                ExtremumErrors[ExtremumCount - 1] = fabs(E);
+                Extrema[ExtremumCount - 1] = X;
+                ExtremumGridIndex[ExtremumCount - 1] = GridIndex;
+            }
+        }
+    }
+
+    for(u32 Index = 0; Index < ExtremumCount; ++Index)
+    {
+        u32 GridIndex = ExtremumGridIndex[Index];
+        f64 Min = GetGridPoint(Poly, (GridIndex > 0) ? (GridIndex - 1) : 0, GridCount);
+        f64 Max = GetGridPoint(Poly, (GridIndex + 1 < GridCount) ? (GridIndex + 1) : GridIndex, GridCount);
+        Extrema[Index] = RefineExtremum(Poly, Func, Min, Max);
+        ExtremumErrors[Index] = AbsDD(GetErrorDD(Poly, Func, Extrema[Index]));
+    }
+
+    u32 First = 0;
+    u32 Needed = Poly->TermCount + 1;
+    while(ExtremumCount > Needed)
+    {
+        if(ExtremumErrors[First] < ExtremumErrors[First + ExtremumCount - 1])
+        {
+            ++First;
+        }
+        --ExtremumCount;
+    }
+
+    b32 Result = (ExtremumCount == Needed);
+    if(Result)
+    {
+        for(u32 Index = 0; Index < Needed; ++Index)
+        {
+            Points[Index] = Extrema[First + Index];
+        }
+    }
+
+    return Result;
+}
+
+static f64 MeasureMaxError(remez_polynomial *Poly, dd_math_func *Func)
+{
+    // NOTE(casey): Uses the coefficients rounded to f64, since those are the ones that get emitted
+    remez_polynomial Rounded = *Poly;
+    for(u32 Index = 0; Index < Rounded.TermCount; ++Index)
+    {
+        Rounded.C[Index] = DD(Poly->C[Index].Hi);
+    }
+
+    u32 GridCount = 4*REMEZ_GRID_POINTS_PER_TERM*(Poly->TermCount + 1);
+    f64 Result = 0;
+    for(u32 GridIndex = 0; GridIndex < GridCount; ++GridIndex)
+    {
+        f64 E = AbsDD(GetErrorDD(&Rounded, Func, GetGridPoint(Poly, GridIndex, GridCount)));
+        if(Result < E)
+        {
+            Result = E;
+        }
+    }
+
+    return Result;
+}
+
+static remez_polynomial FindMinimaxPolynomial(dd_math_func *Func, f64 MinInput, f64 MaxInput,
+                                              remez_structure Structure, u32 TermCount)
+{
+    remez_polynomial Poly = {};
+    Poly.Structure = Structure;
+    Poly.TermCount = TermCount;
+    Poly.MinInput = MinInput;
+    Poly.MaxInput = MaxInput;
+
+    // NOTE(casey): Start on the Chebyshev extrema. For odd and even polynomials, those are
+    // bunched up towards MaxInput, leaving out zero, where an odd error is always zero.
+    f64 Points[REMEZ_MAX_TERM_COUNT + 1];
+    for(u32 Index = 0; Index <= TermCount; ++Index)
+    {
+        f64 t;
+        if(Structure == RemezStructure_Any)
+        {
+            t = 0.5 - 0.5*cos(Pi64*(f64)Index / (f64)TermCount);
+        }
+        else
+        {
+            t = sin(0.5*Pi64*(f64)(Index + 1) / (f64)(TermCount + 1));
+        }
+        Points[Index] = (1.0 - t)*MinInput + t*MaxInput;
+    }
+
+    b32 Solved = true;
+    for(u32 Iteration = 0; Solved && (Iteration < REMEZ_MAX_ITERATION_COUNT); ++Iteration)
+    {
+        Poly.IterationCount = Iteration + 1;
+        Solved = SolveRemezSystem(&Poly, Func, Points);
+        if(Solved)
+        {
+            Solved = ExchangeRemezPoints(&Poly, Func, Points);
+        }
+
+        if(Solved)
+        {
+            // NOTE(casey): Done when the new extrema are all about as big as each other
+            f64 MinE = INFINITY;
+            f64 MaxE = 0;
+            for(u32 Index = 0; Index <= TermCount; ++Index)
+            {
+                f64 E = AbsDD(GetErrorDD(&Poly, Func, Points[Index]));
+                MinE = (E < MinE) ? E : MinE;
+                MaxE = (E > MaxE) ? E : MaxE;
+            }
+
+            if((MaxE - MinE) <= 1e-3*MaxE)
+            {
+                Poly.Converged = true;
+                break;
+            }
+        }
+    }
+
+    Poly.MaxError = MeasureMaxError(&Poly, Func);
+    return Poly;
+}
+
+static void WriteRemezTable(FILE *Dest, remez_polynomial *Poly, char const *FunctionName, char const *TableName)
+{
+    fprintf(Dest, "/* NOTE(casey): Generated by listing 238 - %s on [%a, %a], %s, %u terms.\n",
+            FunctionName, Poly->MinInput, Poly->MaxInput, RemezStructureNames[Poly->Structure], Poly->TermCount);
+    fprintf(Dest, "   Max error with these f64 coefficients, evaluated exactly: %.3e */\n\n", Poly->MaxError);
+    fprintf(Dest, "static f64 %s[%u] =\n{\n", TableName, Poly->TermCount);
+    for(u32 Index = 0; Index < Poly->TermCount; ++Index)
+    {
+        fprintf(Dest, "    %a,\n", Poly->C[Index].Hi);
+    }
+    fprintf(Dest, "};\n");
+}
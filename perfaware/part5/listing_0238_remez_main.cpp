@@ -0,0 +1,207 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 238
+   ======================================================================== */
+
+/* NOTE(casey): Finds the fewest polynomial terms that get a function under a
+   target max error on an interval, and writes out the coefficients as an .inl
+   table like the ones in listings 184 and 187. Since every term is an fma in
+   the hot loop, it's worth knowing exactly how few we can get away with.
+
+   The error the Remez exchange reports is with exact arithmetic, so the table
+   is then checked the usual way, by math_tester against the CRT, with the same
+   fma chain the listings actually use. The next smaller polynomial is checked
+   alongside it, to show what the last term is buying. */
+
+#include "listing_0250_math_prelude.cpp"
+#include "listing_0184_sine_coefficients.inl"
+#include "listing_0185_sine_extc.cpp"
+#include "listing_0237_remez.cpp"
+
+#define REMEZ_VALIDATION_STEP_COUNT 10000000
+#define REMEZ_VALIDATION_POLY_COUNT 2 // NOTE(casey): The one that made it, then the one before it
+
+struct remez_function
+{
+    char const *Name;
+    char const *TableName;
+    math_func *Reference;
+    dd_math_func *ReferenceDD;
+    b32 IsSine; // NOTE(casey): Only sine has an MFTWP table to compare against
+};
+
+static remez_function RemezFunctions[] =
+{
+    {"sin", "SineRadiansC_Remez", sin, SinDD, true},
+    {"cos", "CosineRadiansC_Remez", cos, CosDD, false},
+    {"asin", "ArcsineRadiansC_Remez", asin, ASinDD, false},
+};
+
+static f64 ParseRemezBound(char const *Text)
+{
+    f64 Result = 0;
+    if(strcmp(Text, "pi") == 0) Result = Pi64;
+    else if(strcmp(Text, "pi/2") == 0) Result = Pi64/2.0;
+    else if(strcmp(Text, "pi/4") == 0) Result = Pi64/4.0;
+    else if(strcmp(Text, "sqrt(0.5)") == 0) Result = sqrt(0.5);
+    else Result = atof(Text);
+    return Result;
+}
+
+static void ValidateRemezPolynomials(remez_function *Function, u32 PolyCount, remez_polynomial *Polys)
+{
+    // NOTE(casey): math_tester is big, so it lives on the heap
+    math_tester *Tester = (math_tester *)calloc(1, sizeof(math_tester));
+    if(Tester)
+    {
+        f64 C[REMEZ_VALIDATION_POLY_COUNT][REMEZ_MAX_TERM_COUNT];
+        for(u32 PolyIndex = 0; PolyIndex < PolyCount; ++PolyIndex)
+        {
+            for(u32 Index = 0; Index < Polys[PolyIndex].TermCount; ++Index)
+            {
+                C[PolyIndex][Index] = Polys[PolyIndex].C[Index].Hi;
+            }
+        }
+
+        remez_polynomial *First = Polys;
+        u32 MFTWPCount = First->TermCount;
+        b32 CompareMFTWP = (Function->IsSine && (First->Structure == RemezStructure_Odd) &&
+                            (MFTWPCount < ArrayCount(SineRadiansC_MFTWP)));
+
+        while(PrecisionTest(Tester, First->MinInput, First->MaxInput, REMEZ_VALIDATION_STEP_COUNT))
+        {
+            f64 RefOutput = Function->Reference(Tester->InputValue);
+            for(u32 PolyIndex = 0; PolyIndex < PolyCount; ++PolyIndex)
+            {
+                remez_polynomial *Poly = Polys + PolyIndex;
+                TestResult(Tester, RefOutput, EvaluatePolynomial(Poly->Structure, Poly->TermCount, C[PolyIndex], Tester->InputValue),
+                           "Remez[%u]", Poly->TermCount);
+            }
+
+            if(CompareMFTWP)
+            {
+                TestResult(Tester, RefOutput, OddPowerPolynomialC(MFTWPCount, SineRadiansC_MFTWP[MFTWPCount], Tester->InputValue),
+                           "MFTWP[%u]", MFTWPCount);
+            }
+        }
+
+        PrintResults(Tester);
+    }
+
+    free(Tester);
+}
+
+int main(int ArgCount, char **Args)
+{
+    InitializeOSPlatform();
+
+    remez_function *Function = 0;
+    if(ArgCount >= 6)
+    {
+        for(u32 FunctionIndex = 0; FunctionIndex < ArrayCount(RemezFunctions); ++FunctionIndex)
+        {
+            if(strcmp(Args[1], RemezFunctions[FunctionIndex].Name) == 0)
+            {
+                Function = RemezFunctions + FunctionIndex;
+            }
+        }
+    }
+
+    remez_structure Structure = RemezStructure_Any;
+    b32 ValidStructure = false;
+    if(Function)
+    {
+        for(u32 StructureIndex = 0; StructureIndex < ArrayCount(RemezStructureNames); ++StructureIndex)
+        {
+            if(strcmp(Args[4], RemezStructureNames[StructureIndex]) == 0)
+            {
+                Structure = (remez_structure)StructureIndex;
+                ValidStructure = true;
+            }
+        }
+    }
+
+    if(!ValidStructure)
+    {
+        fprintf(stderr, "Usage: %s [sin|cos|asin] [min input] [max input] [odd|even|any] [target max error] [output .inl]\n", Args[0]);
+        fprintf(stderr, "       Inputs can also be pi, pi/2, pi/4 or sqrt(0.5). With no output file, the table goes to stdout.\n");
+        fprintf(stderr, "       e.g. %s sin 0 pi/2 odd 1e-16 sine_coefficients.inl\n", Args[0]);
+        return 1;
+    }
+
+    f64 MinInput = ParseRemezBound(Args[2]);
+    f64 MaxInput = ParseRemezBound(Args[3]);
+    f64 TargetError = atof(Args[5]);
+    char const *OutputFileName = (ArgCount > 6) ? Args[6] : 0;
+
+    if(!(MinInput < MaxInput) || ((Structure != RemezStructure_Any) && (MinInput < 0)))
+    {
+        fprintf(stderr, "ERROR: The input range must be non-empty, and can't go below zero for odd or even polynomials\n");
+        return 1;
+    }
+
+    fprintf(stdout, "%s on [%.17g, %.17g], %s, target max error %.3e:\n",
+            Function->Name, MinInput, MaxInput, RemezStructureNames[Structure], TargetError);
+
+    remez_polynomial Polys[REMEZ_VALIDATION_POLY_COUNT] = {};
+    b32 Found = false;
+    for(u32 TermCount = 1; !Found && (TermCount <= REMEZ_MAX_TERM_COUNT); ++TermCount)
+    {
+        Polys[1] = Polys[0];
+        Polys[0] = FindMinimaxPolynomial(Function->ReferenceDD, MinInput, MaxInput, Structure, TermCount);
+
+        fprintf(stdout, "  %2u terms: max error %.3e after %u iterations%s\n", TermCount, Polys[0].MaxError,
+                Polys[0].IterationCount, Polys[0].Converged ? "" : " (did not converge)");
+
+        Found = (Polys[0].MaxError <= TargetError);
+    }
+
+    if(Found)
+    {
+        char TableName[64];
+        snprintf(TableName, sizeof(TableName), "%s%u", Function->TableName, Polys[0].TermCount);
+
+        FILE *Dest = stdout;
+        if(OutputFileName)
+        {
+            Dest = fopen(OutputFileName, "wb");
+        }
+
+        if(Dest)
+        {
+            fprintf(stdout, "\n");
+            WriteRemezTable(Dest, &Polys[0], Function->Name, TableName);
+            if(OutputFileName)
+            {
+                fclose(Dest);
+                fprintf(stdout, "Wrote %s to %s\n", TableName, OutputFileName);
+            }
+        }
+        else
+        {
+            fprintf(stderr, "ERROR: Unable to open \"%s\" for writing.\n", OutputFileName);
+        }
+
+        ValidateRemezPolynomials(Function, (Polys[1].TermCount ? 2 : 1), Polys);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: No polynomial with up to %u terms gets under %.3e\n", REMEZ_MAX_TERM_COUNT, TargetError);
+    }
+
+    // NOTE(casey): Only the MFTWP coefficients from listing 184 are used here, not the Taylor ones
+    (void)SineRadiansC_Taylor;
+
+    return 0;
+}
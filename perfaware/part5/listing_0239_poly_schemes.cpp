@@ -0,0 +1,150 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 239
+   ======================================================================== */
+
+/* NOTE(casey): OddPowerPolynomialC from listing 185, but with the coefficient
+   count as a template parameter, so the whole thing unrolls at compile time,
+   and with a choice of how the polynomial gets evaluated:
+
+   Horner is the same fma chain as OddPowerPolynomialC. It does the fewest
+   operations, but every fma waits on the one before it, so N coefficients is
+   N - 1 fma latencies back to back.
+
+   Estrin evaluates pairs of coefficients independently, then pairs of pairs
+   with V^2, and so on, so the chain is only about log2(N) fmas long (plus the
+   squarings of V, which can happen off to the side). It costs a few extra
+   multiplies.
+
+   Split Horner runs two Horner chains in V^2, one on the even coefficients
+   and one on the odd ones, and joins them with a final fma. That's about half
+   the chain length for one extra multiply.
+
+   When lots of independent inputs are in flight, the schemes should all run at
+   about the same speed, since then it is throughput that matters, not latency.
+   They don't round identically, but they should all be about as accurate. */
+
+enum poly_scheme
+{
+    PolyScheme_Horner,
+    PolyScheme_Estrin,
+    PolyScheme_SplitHorner,
+
+    PolyScheme_Count,
+};
+
+static char const *PolySchemeNames[PolyScheme_Count] = {"Horner", "Estrin", "SplitHorner"};
+
+template<u32 N, u32 Stride = 1> struct horner_poly
+{
+    // NOTE(casey): C[0] + C[Stride]*V + C[2*Stride]*V^2 + ..., highest coefficient first, like OddPowerPolynomialC
+    static inline f64 Eval(f64 const *C, f64 V)
+    {
+        f64 Result = fma(horner_poly<N - 1, Stride>::Eval(C + Stride, V), V, C[0]);
+        return Result;
+    }
+};
+
+template<u32 Stride> struct horner_poly<1, Stride>
+{
+    static inline f64 Eval(f64 const *C, f64 V)
+    {
+        (void)V;
+        return C[0];
+    }
+};
+
+template<u32 Power> struct poly_power
+{
+    // NOTE(casey): V^Power, for powers of two, by repeated squaring
+    static inline f64 Eval(f64 V)
+    {
+        f64 Half = poly_power<Power/2>::Eval(V);
+        f64 Result = Half*Half;
+        return Result;
+    }
+};
+
+template<> struct poly_power<1>
+{
+    static inline f64 Eval(f64 V)
+    {
+        return V;
+    }
+};
+
+template<u32 N> struct estrin_poly
+{
+    /* NOTE(casey): Splits off the biggest power-of-two block of low coefficients,
+       so P(V) = Low(V) + V^LowCount*High(V), and both halves can be evaluated at the
+       same time. The powers of V are the same expressions in every half, so the
+       compiler only computes each one once. */
+    enum {LowCount = (N > 16) ? 16 : (N > 8) ? 8 : (N > 4) ? 4 : (N > 2) ? 2 : 1};
+
+    static inline f64 Eval(f64 const *C, f64 V)
+    {
+        static_assert(N <= 32, "estrin_poly only handles up to 32 coefficients");
+        f64 Low = estrin_poly<LowCount>::Eval(C, V);
+        f64 High = estrin_poly<N - LowCount>::Eval(C + LowCount, V);
+        f64 Result = fma(High, poly_power<LowCount>::Eval(V), Low);
+        return Result;
+    }
+};
+
+template<> struct estrin_poly<1>
+{
+    static inline f64 Eval(f64 const *C, f64 V)
+    {
+        (void)V;
+        return C[0];
+    }
+};
+
+template<u32 N> struct split_horner_poly
+{
+    static inline f64 Eval(f64 const *C, f64 V)
+    {
+        f64 V2 = V*V;
+        f64 Even = horner_poly<(N + 1)/2, 2>::Eval(C, V2);
+        f64 Odd = horner_poly<N/2, 2>::Eval(C + 1, V2);
+        f64 Result = fma(Odd, V, Even);
+        return Result;
+    }
+};
+
+template<> struct split_horner_poly<1>
+{
+    static inline f64 Eval(f64 const *C, f64 V)
+    {
+        (void)V;
+        return C[0];
+    }
+};
+
+template<poly_scheme Scheme, u32 N> inline f64 Poly(f64 const *C, f64 V)
+{
+    // NOTE(casey): Scheme is a constant, so only one of these survives
+    f64 Result = (Scheme == PolyScheme_Estrin) ? estrin_poly<N>::Eval(C, V) :
+        (Scheme == PolyScheme_SplitHorner) ? split_horner_poly<N>::Eval(C, V) :
+        horner_poly<N>::Eval(C, V);
+    return Result;
+}
+
+template<poly_scheme Scheme, u32 N> inline f64 OddPoly(f64 const *C, f64 X)
+{
+    // NOTE(casey): A drop-in for OddPowerPolynomialC(N, C, X)
+    f64 R = Poly<Scheme, N>(C, X*X);
+    R *= X;
+    return R;
+}
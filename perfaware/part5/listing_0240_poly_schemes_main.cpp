@@ -0,0 +1,193 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 240
+   ======================================================================== */
+
+/* NOTE(casey): Times every polynomial scheme from listing 239, plus the
+   runtime loop from listing 185, at every coefficient count in the MFTWP sine
+   table. Throughput runs each input independently. Latency feeds every output
+   back in as the next input, x = sin(x), so nothing can overlap and the time
+   per call is the length of the dependency chain. */
+
+#include "listing_0250_math_prelude.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+#include "listing_0184_sine_coefficients.inl"
+#include "listing_0185_sine_extc.cpp"
+#include "listing_0239_poly_schemes.cpp"
+
+#define POLY_MIN_COUNT 2
+#define POLY_MAX_COUNT 10
+#define POLY_COUNT_COUNT (POLY_MAX_COUNT - POLY_MIN_COUNT + 1)
+#define POLY_TIMING_COUNT 4096 // NOTE(casey): Small enough that input and output both stay in L1
+#define POLY_PRECISION_STEP_COUNT 1000000
+
+typedef void poly_kernel(u32 CCount, f64 *C, u32 Count, f64 const *In, f64 *Out);
+
+template<poly_scheme Scheme, u32 N> static void OddPolyThroughput(u32 CCount, f64 *C, u32 Count, f64 const *In, f64 *Out)
+{
+    (void)CCount;
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        Out[Index] = OddPoly<Scheme, N>(C, In[Index]);
+    }
+}
+
+template<poly_scheme Scheme, u32 N> static void OddPolyLatency(u32 CCount, f64 *C, u32 Count, f64 const *In, f64 *Out)
+{
+    (void)CCount;
+    f64 X = In[0];
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        X = OddPoly<Scheme, N>(C, X);
+    }
+    Out[0] = X;
+}
+
+static void LoopThroughput(u32 CCount, f64 *C, u32 Count, f64 const *In, f64 *Out)
+{
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        Out[Index] = OddPowerPolynomialC(CCount, C, In[Index]);
+    }
+}
+
+static void LoopLatency(u32 CCount, f64 *C, u32 Count, f64 const *In, f64 *Out)
+{
+    f64 X = In[0];
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        X = OddPowerPolynomialC(CCount, C, X);
+    }
+    Out[0] = X;
+}
+
+struct poly_kernels
+{
+    poly_kernel *Throughput;
+    poly_kernel *Latency;
+    math_func *Single; // NOTE(casey): One evaluation on the MFTWP coefficients, for checking precision
+};
+
+template<poly_scheme Scheme, u32 N> static f64 OddPolyMFTWP(f64 X)
+{
+    f64 Result = OddPoly<Scheme, N>(SineRadiansC_MFTWP[N], X);
+    return Result;
+}
+
+#define POLY_KERNELS(Scheme, N) {OddPolyThroughput<Scheme, N>, OddPolyLatency<Scheme, N>, OddPolyMFTWP<Scheme, N>}
+#define POLY_KERNEL_ROW(Scheme) {POLY_KERNELS(Scheme, 2), POLY_KERNELS(Scheme, 3), POLY_KERNELS(Scheme, 4), \
+                                 POLY_KERNELS(Scheme, 5), POLY_KERNELS(Scheme, 6), POLY_KERNELS(Scheme, 7), \
+                                 POLY_KERNELS(Scheme, 8), POLY_KERNELS(Scheme, 9), POLY_KERNELS(Scheme, 10)}
+
+static poly_kernels PolyKernels[PolyScheme_Count][POLY_COUNT_COUNT] =
+{
+    POLY_KERNEL_ROW(PolyScheme_Horner),
+    POLY_KERNEL_ROW(PolyScheme_Estrin),
+    POLY_KERNEL_ROW(PolyScheme_SplitHorner),
+};
+
+static void TimePolyKernels(repetition_test_series *Series, b32 Latency, f64 *Input, f64 *Output)
+{
+    u32 Count = POLY_TIMING_COUNT;
+
+    SetRowLabelLabel(Series, "Scheme");
+    for(u32 RowIndex = 0; RowIndex <= PolyScheme_Count; ++RowIndex)
+    {
+        // NOTE(casey): Row 0 is the runtime loop, then the schemes
+        SetRowLabel(Series, "%s", RowIndex ? PolySchemeNames[RowIndex - 1] : "Loop");
+        for(u32 CCount = POLY_MIN_COUNT; CCount <= POLY_MAX_COUNT; ++CCount)
+        {
+            poly_kernel *Kernel = Latency ? LoopLatency : LoopThroughput;
+            if(RowIndex)
+            {
+                poly_kernels Kernels = PolyKernels[RowIndex - 1][CCount - POLY_MIN_COUNT];
+                Kernel = Latency ? Kernels.Latency : Kernels.Throughput;
+            }
+
+            SetColumnLabel(Series, "C[%u]", CCount);
+
+            repetition_tester Tester = {};
+            NewTestWave(Series, &Tester, Count, GetCPUTimerFreq());
+            while(IsTesting(Series, &Tester))
+            {
+                BeginTime(&Tester);
+                Kernel(CCount, SineRadiansC_MFTWP[CCount], Count, Input, Output);
+                CountBytes(&Tester, Count);
+                EndTime(&Tester);
+            }
+        }
+    }
+}
+
+int main(void)
+{
+    InitializeOSPlatform();
+
+    // NOTE(casey): math_tester is big, so it lives on the heap
+    math_tester *Tester = (math_tester *)calloc(1, sizeof(math_tester));
+    if(Tester)
+    {
+        for(u32 CCount = POLY_MIN_COUNT; CCount <= POLY_MAX_COUNT; ++CCount)
+        {
+            while(PrecisionTest(Tester, 0, Pi64/2, POLY_PRECISION_STEP_COUNT))
+            {
+                f64 RefOutput = sin(Tester->InputValue);
+                TestResult(Tester, RefOutput, OddPowerPolynomialC(CCount, SineRadiansC_MFTWP[CCount], Tester->InputValue), "Loop[%u]", CCount);
+                for(u32 Scheme = 0; Scheme < PolyScheme_Count; ++Scheme)
+                {
+                    math_func *Single = PolyKernels[Scheme][CCount - POLY_MIN_COUNT].Single;
+                    TestResult(Tester, RefOutput, Single(Tester->InputValue), "%s[%u]", PolySchemeNames[Scheme], CCount);
+                }
+            }
+        }
+
+        PrintResults(Tester);
+    }
+    free(Tester);
+
+    f64 Input[POLY_TIMING_COUNT];
+    f64 Output[POLY_TIMING_COUNT];
+    for(u32 Index = 0; Index < POLY_TIMING_COUNT; ++Index)
+    {
+        Input[Index] = (Pi64/2)*(f64)Index / (f64)POLY_TIMING_COUNT;
+    }
+    Input[0] = 1.0; // NOTE(casey): The latency chain starts here, and sin(0) would just stay at 0
+
+    repetition_test_series ThroughputSeries = AllocateTestSeries(POLY_COUNT_COUNT, PolyScheme_Count + 1);
+    repetition_test_series LatencySeries = AllocateTestSeries(POLY_COUNT_COUNT, PolyScheme_Count + 1);
+    if(IsValid(ThroughputSeries) && IsValid(LatencySeries))
+    {
+        TimePolyKernels(&ThroughputSeries, false, Input, Output);
+        TimePolyKernels(&LatencySeries, true, Input, Output);
+
+        // NOTE(casey): "Bytes" are evaluations here
+        fprintf(stdout, "\nThroughput, million evaluations/s:\n");
+        PrintCSVForValue(&ThroughputSeries, StatValue_GBPerSecond, stdout, (1024.0*1024.0*1024.0) / 1000000.0);
+
+        fprintf(stdout, "\nLatency, ns per evaluation:\n");
+        PrintCSVForValue(&LatencySeries, StatValue_Seconds, stdout, 1000000000.0 / (f64)POLY_TIMING_COUNT);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate test series\n");
+    }
+
+    FreeTestSeries(&ThroughputSeries);
+    FreeTestSeries(&LatencySeries);
+
+    // NOTE(casey): Only the MFTWP coefficients from listing 184 are used here, not the Taylor ones
+    (void)SineRadiansC_Taylor;
+
+    return 0;
+}
@@ -0,0 +1,398 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 241
+   ======================================================================== */
+
+/* NOTE(casey): SinCosCE gets both sin(x) and cos(x) out of one range
+   reduction. x is reduced to r in [-pi/4, pi/4] by subtracting the nearest
+   multiple k of pi/2, then sin(r) and cos(r) are evaluated together off the
+   same r^2, and the low two bits of k pick which one is the sine and which
+   signs to flip. Both polynomials are short on [-pi/4, pi/4] - 7 terms for
+   sine and 8 for cosine, from listing 238 - and they don't depend on each
+   other, so they run side by side.
+
+   pi/2 is split into two parts, so r stays accurate even after subtracting
+   a few multiples of it. That's plenty for the [-pi, pi] range SinCE covers;
+   it is not meant for large arguments.
+
+   The haversine kernels here use it on the half-latitudes, which are already
+   in [-pi/4, pi/4], so they skip the reduction entirely:
+       sin(dlat/2) = sin(h2)cos(h1) - cos(h2)sin(h1)
+       cos(lat) = cos(h)^2 - sin(h)^2 = (cos(h) - sin(h))*(cos(h) + sin(h))
+   so two SinCos cores replace three of the four sine cores. That is not
+   actually less math - SimplifiedHaversine already gets its cosines out of
+   the sine core with a prefix, so it never paid for a separate cosine - and
+   in practice it comes out about even on AVX2 and slower on AVX-512. Where
+   SinCosCE does pay off is code that really needs both values of one angle. */
+
+#define SINCOS_PI_OVER_2_HI 0x1.921fb54442d18p0
+#define SINCOS_PI_OVER_2_LO 0x1.1a62633145c07p-54
+#define SINCOS_ROUNDING_MAGIC 0x1.8p52 // NOTE(casey): Adding this rounds to an integer, which ends up in the low mantissa bits
+
+typedef void sincos_batch_func(u64 Count, f64 const *In, f64 *SinOut, f64 *CosOut);
+
+//
+// NOTE(casey): Scalar
+//
+
+inline void SinCosCore(f64 X, f64 *SinX, f64 *CosX)
+{
+    // NOTE(casey): Only for X in [-pi/4, pi/4]
+    f64 X2 = X*X;
+
+    f64 S = 0x1.5d45b3248c17bp-33;
+    f64 C = -0x1.8f76380338412p-37;
+    S = fma(S, X2, -0x1.ae5d306ba2463p-26);
+    C = fma(C, X2, 0x1.1ee96d2629799p-29);
+    S = fma(S, X2, 0x1.71de339a50e07p-19);
+    C = fma(C, X2, -0x1.27e4f7282f214p-22);
+    S = fma(S, X2, -0x1.a01a01994fbb1p-13);
+    C = fma(C, X2, 0x1.a01a019b1e8d5p-16);
+    S = fma(S, X2, 0x1.111111110d8ccp-7);
+    C = fma(C, X2, -0x1.6c16c16c13a0bp-10);
+    S = fma(S, X2, -0x1.5555555555522p-3);
+    C = fma(C, X2, 0x1.5555555555536p-5);
+    S = fma(S, X2, 0x1p0);
+    C = fma(C, X2, -0x1p-1);
+    C = fma(C, X2, 0x1p0);
+    S *= X;
+
+    *SinX = S;
+    *CosX = C;
+}
+
+inline void SinCosCE(f64 X, f64 *SinX, f64 *CosX)
+{
+    f64 Shifted = fma(X, 2.0/Pi64, SINCOS_ROUNDING_MAGIC);
+    f64 K = Shifted - SINCOS_ROUNDING_MAGIC;
+
+    u64 ShiftedBits;
+    memcpy(&ShiftedBits, &Shifted, sizeof(ShiftedBits));
+    u32 Quadrant = (u32)ShiftedBits & 3;
+
+    f64 R = fma(-K, SINCOS_PI_OVER_2_HI, X);
+    R = fma(-K, SINCOS_PI_OVER_2_LO, R);
+
+    f64 S, C;
+    SinCosCore(R, &S, &C);
+
+    // NOTE(casey): Quadrant 1 is (cos, -sin), 2 is (-sin, -cos), 3 is (-cos, sin)
+    f64 SinR = (Quadrant & 1) ? C : S;
+    f64 CosR = (Quadrant & 1) ? S : C;
+    *SinX = (Quadrant & 2) ? -SinR : SinR;
+    *CosX = ((Quadrant + 1) & 2) ? -CosR : CosR;
+}
+
+//
+// NOTE(casey): AVX2
+//
+
+inline void SinCosCore4(__m256d X, __m256d *SinX, __m256d *CosX)
+{
+    __m256d X2 = _mm256_mul_pd(X, X);
+
+    __m256d S = _mm256_set1_pd(0x1.5d45b3248c17bp-33);
+    __m256d C = _mm256_set1_pd(-0x1.8f76380338412p-37);
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(-0x1.ae5d306ba2463p-26));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(0x1.1ee96d2629799p-29));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(0x1.71de339a50e07p-19));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(-0x1.27e4f7282f214p-22));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(-0x1.a01a01994fbb1p-13));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(0x1.a01a019b1e8d5p-16));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(0x1.111111110d8ccp-7));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(-0x1.6c16c16c13a0bp-10));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(-0x1.5555555555522p-3));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(0x1.5555555555536p-5));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(0x1p0));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(-0x1p-1));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(0x1p0));
+    S = _mm256_mul_pd(S, X);
+
+    *SinX = S;
+    *CosX = C;
+}
+
+inline void SinCosCE4(__m256d X, __m256d *SinX, __m256d *CosX)
+{
+    __m256d Magic = _mm256_set1_pd(SINCOS_ROUNDING_MAGIC);
+    __m256d SignBit = _mm256_set1_pd(-0.0);
+
+    __m256d Shifted = _mm256_fmadd_pd(X, _mm256_set1_pd(2.0/Pi64), Magic);
+    __m256d NegK = _mm256_sub_pd(Magic, Shifted);
+    __m256i Quadrant = _mm256_castpd_si256(Shifted);
+
+    __m256d R = _mm256_fmadd_pd(NegK, _mm256_set1_pd(SINCOS_PI_OVER_2_HI), X);
+    R = _mm256_fmadd_pd(NegK, _mm256_set1_pd(SINCOS_PI_OVER_2_LO), R);
+
+    __m256d S, C;
+    SinCosCore4(R, &S, &C);
+
+    // NOTE(casey): blendv only looks at the top bit, so the quadrant bits get shifted up there
+    __m256d Swap = _mm256_castsi256_pd(_mm256_slli_epi64(Quadrant, 63));
+    __m256d SinSign = _mm256_and_pd(SignBit, _mm256_castsi256_pd(_mm256_slli_epi64(Quadrant, 62)));
+    __m256d CosSign = _mm256_and_pd(SignBit, _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(Quadrant, _mm256_set1_epi64x(1)), 62)));
+
+    *SinX = _mm256_xor_pd(_mm256_blendv_pd(S, C, Swap), SinSign);
+    *CosX = _mm256_xor_pd(_mm256_blendv_pd(C, S, Swap), CosSign);
+}
+
+inline __m256d HaversineHalfAngleSinCos4(__m256d lon1, __m256d lat1, __m256d lon2, __m256d lat2)
+{
+    __m256d Zero = _mm256_setzero_pd();
+    __m256d SignBit = _mm256_set1_pd(-0.0);
+    __m256d HalfRadC = _mm256_set1_pd(0.01745329251994329577/2.0);
+    __m256d NegHalfRadC = _mm256_set1_pd(-0.01745329251994329577/2.0);
+    __m256d Pi = _mm256_set1_pd(Pi64);
+    __m256d HalfPi = _mm256_set1_pd(Pi64/2.0);
+    __m256d Deg180 = _mm256_set1_pd(180.0);
+    __m256d Half = _mm256_set1_pd(0.5);
+    __m256d One = _mm256_set1_pd(1.0);
+
+    __m256d S1, C1, S2, C2;
+    SinCosCore4(_mm256_mul_pd(lat1, HalfRadC), &S1, &C1);
+    SinCosCore4(_mm256_mul_pd(lat2, HalfRadC), &S2, &C2);
+
+    __m256d S0 = _mm256_fmsub_pd(S2, C1, _mm256_mul_pd(C2, S1));
+    __m256d CosLat1 = _mm256_mul_pd(_mm256_sub_pd(C1, S1), _mm256_add_pd(C1, S1));
+    __m256d CosLat2 = _mm256_mul_pd(_mm256_sub_pd(C2, S2), _mm256_add_pd(C2, S2));
+
+    // NOTE(casey): The longitude term is the same as in HaversineHalfAngle4
+    __m256d DLon = _mm256_andnot_pd(SignBit, _mm256_sub_pd(lon2, lon1));
+    __m256d LonInRange = _mm256_cmp_pd(DLon, Deg180, _CMP_LT_OQ);
+    __m256d SLC3 = _mm256_blendv_pd(NegHalfRadC, HalfRadC, LonInRange);
+    __m256d ALC3 = _mm256_blendv_pd(Pi, Zero, LonInRange);
+    __m256d S3 = SineCoreWithPrefix4(SLC3, DLon, ALC3);
+
+    __m256d a = _mm256_fmadd_pd(S0, S0, _mm256_mul_pd(_mm256_mul_pd(CosLat1, CosLat2), _mm256_mul_pd(S3, S3)));
+
+    __m256d NeedsTransform = _mm256_cmp_pd(a, Half, _CMP_GT_OQ);
+    __m256d RangeA = _mm256_blendv_pd(a, _mm256_sub_pd(One, a), NeedsTransform);
+    __m256d R = ArcsineCoreFromSquared4(RangeA);
+    __m256d RangeR = _mm256_blendv_pd(R, _mm256_sub_pd(HalfPi, R), NeedsTransform);
+
+    return RangeR;
+}
+
+static f64 SumHaversineHalfAnglesSinCosAVX2(u64 PairCount, haversine_columns Columns)
+{
+    __m256d Sum0 = _mm256_setzero_pd();
+    __m256d Sum1 = _mm256_setzero_pd();
+
+    u64 PairIndex = 0;
+    for(; (PairIndex + 8) <= PairCount; PairIndex += 8)
+    {
+        __m256d R0 = HaversineHalfAngleSinCos4(_mm256_loadu_pd(Columns.X0 + PairIndex), _mm256_loadu_pd(Columns.Y0 + PairIndex),
+                                               _mm256_loadu_pd(Columns.X1 + PairIndex), _mm256_loadu_pd(Columns.Y1 + PairIndex));
+        __m256d R1 = HaversineHalfAngleSinCos4(_mm256_loadu_pd(Columns.X0 + PairIndex + 4), _mm256_loadu_pd(Columns.Y0 + PairIndex + 4),
+                                               _mm256_loadu_pd(Columns.X1 + PairIndex + 4), _mm256_loadu_pd(Columns.Y1 + PairIndex + 4));
+        Sum0 = _mm256_add_pd(Sum0, R0);
+        Sum1 = _mm256_add_pd(Sum1, R1);
+    }
+
+    for(; PairIndex < PairCount; PairIndex += 4)
+    {
+        __m256i Mask = GetLoadMask4(PairCount - PairIndex);
+        __m256d R = HaversineHalfAngleSinCos4(_mm256_maskload_pd(Columns.X0 + PairIndex, Mask), _mm256_maskload_pd(Columns.Y0 + PairIndex, Mask),
+                                              _mm256_maskload_pd(Columns.X1 + PairIndex, Mask), _mm256_maskload_pd(Columns.Y1 + PairIndex, Mask));
+        Sum0 = _mm256_add_pd(Sum0, R);
+    }
+
+    __m256d Sum = _mm256_add_pd(Sum0, Sum1);
+    __m128d Sum2 = _mm_add_pd(_mm256_castpd256_pd128(Sum), _mm256_extractf128_pd(Sum, 1));
+    f64 Result = _mm_cvtsd_f64(_mm_add_sd(Sum2, _mm_unpackhi_pd(Sum2, Sum2)));
+
+    return Result;
+}
+
+//
+// NOTE(casey): AVX-512
+//
+
+AVX512_FUNCTION inline void SinCosCore8(__m512d X, __m512d *SinX, __m512d *CosX)
+{
+    __m512d X2 = _mm512_mul_pd(X, X);
+
+    __m512d S = _mm512_set1_pd(0x1.5d45b3248c17bp-33);
+    __m512d C = _mm512_set1_pd(-0x1.8f76380338412p-37);
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(-0x1.ae5d306ba2463p-26));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(0x1.1ee96d2629799p-29));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(0x1.71de339a50e07p-19));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(-0x1.27e4f7282f214p-22));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(-0x1.a01a01994fbb1p-13));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(0x1.a01a019b1e8d5p-16));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(0x1.111111110d8ccp-7));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(-0x1.6c16c16c13a0bp-10));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(-0x1.5555555555522p-3));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(0x1.5555555555536p-5));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(0x1p0));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(-0x1p-1));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(0x1p0));
+    S = _mm512_mul_pd(S, X);
+
+    *SinX = S;
+    *CosX = C;
+}
+
+AVX512_FUNCTION inline void SinCosCE8(__m512d X, __m512d *SinX, __m512d *CosX)
+{
+    __m512d Magic = _mm512_set1_pd(SINCOS_ROUNDING_MAGIC);
+
+    __m512d Shifted = _mm512_fmadd_pd(X, _mm512_set1_pd(2.0/Pi64), Magic);
+    __m512d NegK = _mm512_sub_pd(Magic, Shifted);
+    __m512i Quadrant = _mm512_castpd_si512(Shifted);
+
+    __m512d R = _mm512_fmadd_pd(NegK, _mm512_set1_pd(SINCOS_PI_OVER_2_HI), X);
+    R = _mm512_fmadd_pd(NegK, _mm512_set1_pd(SINCOS_PI_OVER_2_LO), R);
+
+    __m512d S, C;
+    SinCosCore8(R, &S, &C);
+
+    __mmask8 Swap = _mm512_test_epi64_mask(Quadrant, _mm512_set1_epi64(1));
+    __mmask8 SinNegative = _mm512_test_epi64_mask(Quadrant, _mm512_set1_epi64(2));
+    __mmask8 CosNegative = _mm512_test_epi64_mask(_mm512_add_epi64(Quadrant, _mm512_set1_epi64(1)), _mm512_set1_epi64(2));
+
+    __m512d SinR = _mm512_mask_blend_pd(Swap, S, C);
+    __m512d CosR = _mm512_mask_blend_pd(Swap, C, S);
+    *SinX = _mm512_mask_sub_pd(SinR, SinNegative, _mm512_setzero_pd(), SinR);
+    *CosX = _mm512_mask_sub_pd(CosR, CosNegative, _mm512_setzero_pd(), CosR);
+}
+
+AVX512_FUNCTION inline __m512d HaversineHalfAngleSinCos8(__m512d lon1, __m512d lat1, __m512d lon2, __m512d lat2)
+{
+    __m512d Zero = _mm512_setzero_pd();
+    __m512d HalfRadC = _mm512_set1_pd(0.01745329251994329577/2.0);
+    __m512d NegHalfRadC = _mm512_set1_pd(-0.01745329251994329577/2.0);
+    __m512d Pi = _mm512_set1_pd(Pi64);
+    __m512d HalfPi = _mm512_set1_pd(Pi64/2.0);
+    __m512d Deg180 = _mm512_set1_pd(180.0);
+    __m512d Half = _mm512_set1_pd(0.5);
+    __m512d One = _mm512_set1_pd(1.0);
+
+    __m512d S1, C1, S2, C2;
+    SinCosCore8(_mm512_mul_pd(lat1, HalfRadC), &S1, &C1);
+    SinCosCore8(_mm512_mul_pd(lat2, HalfRadC), &S2, &C2);
+
+    __m512d S0 = _mm512_fmsub_pd(S2, C1, _mm512_mul_pd(C2, S1));
+    __m512d CosLat1 = _mm512_mul_pd(_mm512_sub_pd(C1, S1), _mm512_add_pd(C1, S1));
+    __m512d CosLat2 = _mm512_mul_pd(_mm512_sub_pd(C2, S2), _mm512_add_pd(C2, S2));
+
+    __m512d DLon = _mm512_abs_pd(_mm512_sub_pd(lon2, lon1));
+    __mmask8 LonInRange = _mm512_cmp_pd_mask(DLon, Deg180, _CMP_LT_OQ);
+    __m512d SLC3 = _mm512_mask_blend_pd(LonInRange, NegHalfRadC, HalfRadC);
+    __m512d ALC3 = _mm512_mask_blend_pd(LonInRange, Pi, Zero);
+    __m512d S3 = SineCoreWithPrefix8(SLC3, DLon, ALC3);
+
+    __m512d a = _mm512_fmadd_pd(S0, S0, _mm512_mul_pd(_mm512_mul_pd(CosLat1, CosLat2), _mm512_mul_pd(S3, S3)));
+
+    __mmask8 NeedsTransform = _mm512_cmp_pd_mask(a, Half, _CMP_GT_OQ);
+    __m512d RangeA = _mm512_mask_sub_pd(a, NeedsTransform, One, a);
+    __m512d R = ArcsineCoreFromSquared8(RangeA);
+    __m512d RangeR = _mm512_mask_sub_pd(R, NeedsTransform, HalfPi, R);
+
+    return RangeR;
+}
+
+AVX512_FUNCTION static f64 SumHaversineHalfAnglesSinCosAVX512(u64 PairCount, haversine_columns Columns)
+{
+    __m512d Sum0 = _mm512_setzero_pd();
+    __m512d Sum1 = _mm512_setzero_pd();
+
+    u64 PairIndex = 0;
+    for(; (PairIndex + 16) <= PairCount; PairIndex += 16)
+    {
+        __m512d R0 = HaversineHalfAngleSinCos8(_mm512_loadu_pd(Columns.X0 + PairIndex), _mm512_loadu_pd(Columns.Y0 + PairIndex),
+                                               _mm512_loadu_pd(Columns.X1 + PairIndex), _mm512_loadu_pd(Columns.Y1 + PairIndex));
+        __m512d R1 = HaversineHalfAngleSinCos8(_mm512_loadu_pd(Columns.X0 + PairIndex + 8), _mm512_loadu_pd(Columns.Y0 + PairIndex + 8),
+                                               _mm512_loadu_pd(Columns.X1 + PairIndex + 8), _mm512_loadu_pd(Columns.Y1 + PairIndex + 8));
+        Sum0 = _mm512_add_pd(Sum0, R0);
+        Sum1 = _mm512_add_pd(Sum1, R1);
+    }
+
+    for(; PairIndex < PairCount; PairIndex += 8)
+    {
+        u64 Remaining = PairCount - PairIndex;
+        __mmask8 Mask = (Remaining >= 8) ? (__mmask8)0xff : (__mmask8)((1u << Remaining) - 1);
+        __m512d R = HaversineHalfAngleSinCos8(_mm512_maskz_loadu_pd(Mask, Columns.X0 + PairIndex), _mm512_maskz_loadu_pd(Mask, Columns.Y0 + PairIndex),
+                                              _mm512_maskz_loadu_pd(Mask, Columns.X1 + PairIndex), _mm512_maskz_loadu_pd(Mask, Columns.Y1 + PairIndex));
+        Sum0 = _mm512_add_pd(Sum0, R);
+    }
+
+    f64 Result = _mm512_reduce_add_pd(_mm512_add_pd(Sum0, Sum1));
+    return Result;
+}
+
+//
+// NOTE(casey): Batches
+//
+
+static void SinCosCE_N_Scalar(u64 Count, f64 const *In, f64 *SinOut, f64 *CosOut)
+{
+    for(u64 Index = 0; Index < Count; ++Index)
+    {
+        SinCosCE(In[Index], SinOut + Index, CosOut + Index);
+    }
+}
+
+static void SinCosCE_N_AVX2(u64 Count, f64 const *In, f64 *SinOut, f64 *CosOut)
+{
+    for(u64 Index = 0; Index < Count; Index += 4)
+    {
+        __m256i Mask = GetLoadMask4(Count - Index);
+        __m256d S, C;
+        SinCosCE4(_mm256_maskload_pd(In + Index, Mask), &S, &C);
+        _mm256_maskstore_pd(SinOut + Index, Mask, S);
+        _mm256_maskstore_pd(CosOut + Index, Mask, C);
+    }
+}
+
+AVX512_FUNCTION static void SinCosCE_N_AVX512(u64 Count, f64 const *In, f64 *SinOut, f64 *CosOut)
+{
+    for(u64 Index = 0; Index < Count; Index += 8)
+    {
+        u64 Remaining = Count - Index;
+        __mmask8 Mask = (Remaining < 8) ? (__mmask8)((1u << Remaining) - 1) : (__mmask8)0xff;
+        __m512d S, C;
+        SinCosCE8(_mm512_maskz_loadu_pd(Mask, In + Index), &S, &C);
+        _mm512_mask_storeu_pd(SinOut + Index, Mask, S);
+        _mm512_mask_storeu_pd(CosOut + Index, Mask, C);
+    }
+}
+
+static sincos_batch_func *GlobalSinCosBatch = SinCosCE_N_AVX2;
+
+static void InitializeSinCosBatch(void)
+{
+    GlobalSinCosBatch = CPUSupportsAVX512F() ? SinCosCE_N_AVX512 : SinCosCE_N_AVX2;
+}
+
+inline void SinCosCE_N(u64 Count, f64 const *In, f64 *SinOut, f64 *CosOut) {GlobalSinCosBatch(Count, In, SinOut, CosOut);}
+
+//
+// NOTE(casey): Test functions
+//
+
+static f64 SinCosAVX2Haversine(haversine_setup Setup)
+{
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+    f64 Result = SumCoef*SumHaversineHalfAnglesSinCosAVX2(Setup.PairCount, Setup.Columns);
+    return Result;
+}
+
+static f64 SinCosAVX512Haversine(haversine_setup Setup)
+{
+    // NOTE(casey): Only call this if CPUSupportsAVX512F() says it's OK
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+    f64 Result = SumCoef*SumHaversineHalfAnglesSinCosAVX512(Setup.PairCount, Setup.Columns);
+    return Result;
+}
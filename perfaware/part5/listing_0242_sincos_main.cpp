@@ -0,0 +1,194 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 242
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+#include "listing_0231_math_batch.cpp"
+#include "listing_0241_sincos.cpp"
+
+#define SINCOS_PRECISION_STEP_COUNT 1000003 // NOTE(casey): Not a multiple of 8, so the masked tails get tested too
+#define SINCOS_TIMING_COUNT 2048 // NOTE(casey): Small enough that input and outputs all stay in L1
+
+struct sincos_batch
+{
+    char const *Name;
+    sincos_batch_func *Func;
+};
+
+static void SinThenCos_N(u64 Count, f64 const *In, f64 *SinOut, f64 *CosOut)
+{
+    // NOTE(casey): What it takes to get both without SinCosCE
+    SinCE_N(Count, In, SinOut);
+    CosCE_N(Count, In, CosOut);
+}
+
+static test_function TestFunctions[] =
+{
+    {"AVX2Haversine", AVX2Haversine},
+    {"SinCosAVX2Haversine", SinCosAVX2Haversine},
+
+    // NOTE(casey): These have to be last, so they can be left off if the CPU doesn't have AVX-512
+    {"AVX512Haversine", AVX512Haversine},
+    {"SinCosAVX512Haversine", SinCosAVX512Haversine},
+};
+
+int main(int ArgCount, char **Args)
+{
+    InitializeOSPlatform();
+    InitializeMathBatch();
+    InitializeSinCosBatch();
+
+    b32 HasAVX512 = CPUSupportsAVX512F();
+    if(!HasAVX512)
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so the AVX-512 functions will not be tested.\n");
+    }
+
+    sincos_batch Batches[] =
+    {
+        {"Scalar", SinCosCE_N_Scalar},
+        {"AVX2", SinCosCE_N_AVX2},
+        {"AVX-512", SinCosCE_N_AVX512},
+    };
+    u32 BatchCount = HasAVX512 ? ArrayCount(Batches) : (ArrayCount(Batches) - 1);
+
+    // NOTE(casey): Outputs are sin then cos for each batch, then SinCE and CosCE for comparison
+    u32 StepCount = SINCOS_PRECISION_STEP_COUNT;
+    u32 OutputCount = 2*(ArrayCount(Batches) + 1);
+    buffer InputBuffer = AllocateBuffer(StepCount*sizeof(f64));
+    buffer OutputBuffer = AllocateBuffer(OutputCount*StepCount*sizeof(f64));
+    if(IsValid(InputBuffer) && IsValid(OutputBuffer))
+    {
+        f64 *Input = (f64 *)InputBuffer.Data;
+        f64 *Outputs = (f64 *)OutputBuffer.Data;
+
+        // NOTE(casey): CosCE only covers [-pi/2, pi/2], so the SinCE/CosCE comparison is only run on that
+        f64 Ranges[][2] = {{-Pi64, Pi64}, {-Pi64/2, Pi64/2}};
+        math_tester Tester = {};
+        for(u32 RangeIndex = 0; RangeIndex < ArrayCount(Ranges); ++RangeIndex)
+        {
+            f64 MinInput = Ranges[RangeIndex][0];
+            f64 MaxInput = Ranges[RangeIndex][1];
+            b32 CompareSinCE = (RangeIndex == 1);
+            for(u32 StepIndex = 0; StepIndex < StepCount; ++StepIndex)
+            {
+                f64 tStep = (f64)StepIndex / (f64)(StepCount - 1);
+                Input[StepIndex] = (1.0 - tStep)*MinInput + tStep*MaxInput;
+            }
+
+            for(u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+            {
+                Batches[BatchIndex].Func(StepCount, Input, Outputs + (2*BatchIndex)*StepCount, Outputs + (2*BatchIndex + 1)*StepCount);
+            }
+            SinThenCos_N(StepCount, Input, Outputs + (OutputCount - 2)*StepCount, Outputs + (OutputCount - 1)*StepCount);
+
+            while(PrecisionTest(&Tester, MinInput, MaxInput, StepCount))
+            {
+                f64 *Output = Outputs + Tester.StepIndex;
+                f64 ExpectedSin = sin(Tester.InputValue);
+                f64 ExpectedCos = cos(Tester.InputValue);
+                for(u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+                {
+                    TestResult(&Tester, ExpectedSin, Output[(2*BatchIndex)*StepCount], "SinCosCE %s sin on [%.4f, %.4f]", Batches[BatchIndex].Name, MinInput, MaxInput);
+                    TestResult(&Tester, ExpectedCos, Output[(2*BatchIndex + 1)*StepCount], "SinCosCE %s cos on [%.4f, %.4f]", Batches[BatchIndex].Name, MinInput, MaxInput);
+                }
+
+                // NOTE(casey): The vector versions should agree with the scalar one, not just with libm
+                for(u32 BatchIndex = 1; BatchIndex < BatchCount; ++BatchIndex)
+                {
+                    TestResult(&Tester, Output[0], Output[(2*BatchIndex)*StepCount], "SinCosCE %s sin vs Scalar on [%.4f, %.4f]", Batches[BatchIndex].Name, MinInput, MaxInput);
+                    TestResult(&Tester, Output[StepCount], Output[(2*BatchIndex + 1)*StepCount], "SinCosCE %s cos vs Scalar on [%.4f, %.4f]", Batches[BatchIndex].Name, MinInput, MaxInput);
+                }
+
+                if(CompareSinCE)
+                {
+                    TestResult(&Tester, ExpectedSin, Output[(OutputCount - 2)*StepCount], "SinCE_N on [%.4f, %.4f]", MinInput, MaxInput);
+                    TestResult(&Tester, ExpectedCos, Output[(OutputCount - 1)*StepCount], "CosCE_N on [%.4f, %.4f]", MinInput, MaxInput);
+                }
+            }
+        }
+
+        PrintResults(&Tester);
+
+        sincos_batch Timed[] =
+        {
+            {"SinCE_N + CosCE_N", SinThenCos_N},
+            {"SinCosCE_N", SinCosCE_N},
+        };
+
+        repetition_test_series TestSeries = AllocateTestSeries(ArrayCount(Timed), 1);
+        if(IsValid(TestSeries))
+        {
+            u32 Count = SINCOS_TIMING_COUNT;
+            SetRowLabelLabel(&TestSeries, "Dispatch");
+            SetRowLabel(&TestSeries, "%s", HasAVX512 ? "AVX-512" : "AVX2");
+            for(u32 TimedIndex = 0; TimedIndex < ArrayCount(Timed); ++TimedIndex)
+            {
+                SetColumnLabel(&TestSeries, "%s", Timed[TimedIndex].Name);
+
+                // NOTE(casey): "Bytes" are elements here, so the GB/s column comes out in elements
+                repetition_tester RepTester = {};
+                NewTestWave(&TestSeries, &RepTester, Count, GetCPUTimerFreq());
+                while(IsTesting(&TestSeries, &RepTester))
+                {
+                    BeginTime(&RepTester);
+                    Timed[TimedIndex].Func(Count, Input, Outputs, Outputs + Count);
+                    CountBytes(&RepTester, Count);
+                    EndTime(&RepTester);
+                }
+            }
+
+            fprintf(stdout, "\nMillion sin/cos pairs/s:\n");
+            PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, (1024.0*1024.0*1024.0) / 1000000.0);
+        }
+
+        FreeTestSeries(&TestSeries);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate test buffers\n");
+    }
+
+    FreeBuffer(&InputBuffer);
+    FreeBuffer(&OutputBuffer);
+
+    // NOTE(casey): The haversine kernels, if a pair file was given
+    if(ArgCount > 1)
+    {
+        haversine_setup Setup = {};
+        if(SetUpHaversineTest(ArgCount, Args, &Setup))
+        {
+            u32 TestFunctionCount = HasAVX512 ? ArrayCount(TestFunctions) : (ArrayCount(TestFunctions) - 2);
+            repetition_test_series TestSeries = AllocateTestSeries(TestFunctionCount, 1);
+            if(IsValid(TestSeries))
+            {
+                SetRowLabelLabel(&TestSeries, "Test");
+                SetRowLabel(&TestSeries, "Haversine");
+                RunHaversineTestRow(&TestSeries, Setup, TestFunctionCount, TestFunctions);
+
+                PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, 1.0);
+            }
+
+            FreeTestSeries(&TestSeries);
+        }
+
+        FreeHaversine(&Setup);
+    }
+
+    (void)&CombinedHaversineTest;
+
+    return 0;
+}
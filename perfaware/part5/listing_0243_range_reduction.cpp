@@ -0,0 +1,504 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 243
+   ======================================================================== */
+
+/* NOTE(casey): SinCE only folds |x| > pi/2 once, so it is only right on
+   [-pi, pi]. SinAnyCE and CosAnyCE work for any finite x. Like SinCosCE, they
+   reduce x to r in [-pi/4, pi/4] plus a quadrant k mod 4, and then evaluate
+   both polynomials on r. The difference is in how carefully r is computed,
+   since for large x, x - k*pi/2 cancels almost everything.
+
+   For |x| < 2^20 it's Cody-Waite. pi/2 is split into pieces of 33 bits each,
+   so k*piece is exact for any k under 2^20, and the first subtraction is
+   exact too. The remaining pieces are subtracted in double-double, so r comes
+   out as r + Lo with Lo carrying the bits that don't fit. That's a handful of
+   fmas, and it's the same in every SIMD lane.
+
+   For anything bigger it's Payne-Hanek. x is M*2^E for a 53-bit integer M.
+   The only bits of 2/pi that matter are the ones that land near the binary
+   point after scaling by 2^E - the ones above it only add multiples of 4 to
+   k - so it takes a 192-bit window of 2/pi starting at bit E-2, multiplies by
+   M exactly with three 64x64->128 multiplies, and reads k mod 4 and the
+   fraction straight out of the product. It's scalar, but it only runs on
+   lanes that actually need it, and those are rare in practice.
+
+   NaN and infinity go down the Payne-Hanek path too, and come out NaN. */
+
+#define REDUCE_CODY_WAITE_LIMIT 0x1p20
+#define REDUCE_ROUNDING_MAGIC 0x1.8p52 // NOTE(casey): Adding this rounds to an integer, which ends up in the low mantissa bits
+
+// NOTE(casey): pi/2 in 33-bit pieces, so K*piece is exact for |K| < 2^20, plus the rest
+#define REDUCE_PI_OVER_2_CW1 0x1.921fb544p0
+#define REDUCE_PI_OVER_2_CW2 0x1.0b4611a6p-34
+#define REDUCE_PI_OVER_2_CW3 0x1.3198a2ep-69
+#define REDUCE_PI_OVER_2_CW4 0x1.b839a252049c1p-104
+
+#define REDUCE_PI_OVER_2_HI 0x1.921fb54442d18p0
+#define REDUCE_PI_OVER_2_LO 0x1.1a62633145c07p-54
+
+// NOTE(casey): The first 1280 bits of 2/pi after the binary point, which is enough for any finite double
+static u64 const TwoOverPiBits[] =
+{
+    0xA2F9836E4E441529ULL, 0xFC2757D1F534DDC0ULL, 0xDB6295993C439041ULL, 0xFE5163ABDEBBC561ULL,
+    0xB7246E3A424DD2E0ULL, 0x06492EEA09D1921CULL, 0xFE1DEB1CB129A73EULL, 0xE88235F52EBB4484ULL,
+    0xE99C7026B45F7E41ULL, 0x3991D639835339F4ULL, 0x9C845F8BBDF9283BULL, 0x1FF897FFDE05980FULL,
+    0xEF2F118B5A0A6D1FULL, 0x6D367ECF27CB09B7ULL, 0x4F463F669E5FEA2DULL, 0x7527BAC7EBE5F17BULL,
+    0x3D0739F78A5292EAULL, 0x6BFB5FB11F8D5D08ULL, 0x56033046FC7B6BABULL, 0xF0CFBC209AF4361DULL,
+};
+
+inline u64 GetTwoOverPiBits(s32 Offset)
+{
+    // NOTE(casey): 64 bits of 2/pi starting Offset bits after the binary point. Bits before the point are all zero.
+    u64 Result = 0;
+    if(Offset < 0)
+    {
+        if(Offset > -64)
+        {
+            Result = TwoOverPiBits[0] >> -Offset;
+        }
+    }
+    else
+    {
+        u32 Word = (u32)Offset / 64;
+        u32 Shift = (u32)Offset % 64;
+        Result = TwoOverPiBits[Word] << Shift;
+        if(Shift)
+        {
+            Result |= TwoOverPiBits[Word + 1] >> (64 - Shift);
+        }
+    }
+
+    return Result;
+}
+
+inline void TwoSum(f64 A, f64 B, f64 *Sum, f64 *Err)
+{
+    // NOTE(casey): Sum + Err == A + B exactly, with no assumption about which one is bigger
+    f64 S = A + B;
+    f64 BB = S - A;
+    *Err = (A - (S - BB)) + (B - BB);
+    *Sum = S;
+}
+
+//
+// NOTE(casey): Scalar
+//
+
+static u32 ReduceRadiansPayneHanek(f64 X, f64 *R, f64 *Lo)
+{
+    u64 Bits;
+    memcpy(&Bits, &X, sizeof(Bits));
+
+    u64 Sign = Bits >> 63;
+    u32 BiasedExponent = (u32)(Bits >> 52) & 0x7ff;
+
+    u32 Quadrant = 0;
+    if(BiasedExponent == 0x7ff)
+    {
+        *R = X - X;
+        *Lo = 0;
+    }
+    else
+    {
+        // NOTE(casey): Only ever called for |X| >= 2^20, so X is never denormal here
+        u64 M = (Bits & 0xfffffffffffffULL) | (1ULL << 52);
+        s32 E = (s32)BiasedExponent - 1075;
+
+        // NOTE(casey): M * (the 192 bits of 2/pi starting at bit E-2), which is X*(2/pi) times 2^190, mod 4*2^190
+        s32 Offset = E - 2;
+        u64 H0, H1, H2;
+        u64 L0 = MultiplyU64(M, GetTwoOverPiBits(Offset), &H0);
+        u64 L1 = MultiplyU64(M, GetTwoOverPiBits(Offset + 64), &H1);
+        u64 L2 = MultiplyU64(M, GetTwoOverPiBits(Offset + 128), &H2);
+        (void)H0;
+
+        u64 P0 = L2;
+        u64 P1 = H2 + L1;
+        u64 P2 = H1 + L0 + (P1 < L1);
+
+        // NOTE(casey): The top two bits are k mod 4, the rest are the fraction, as 0.128 fixed point
+        Quadrant = (u32)(P2 >> 62);
+        u64 FHi = (P2 << 2) | (P1 >> 62);
+        u64 FLo = (P1 << 2) | (P0 >> 62);
+
+        // NOTE(casey): A fraction of 1/2 or more rounds k up, which leaves the fraction negative in two's complement
+        f64 FSign = 1.0;
+        if(FHi >> 63)
+        {
+            Quadrant += 1;
+            FHi = ~FHi + (FLo == 0);
+            FLo = 0 - FLo;
+            FSign = -1.0;
+        }
+
+        // NOTE(casey): Split so that both conversions are exact (or nearly), then treat the pair as a double-double
+        f64 FA = FSign*(f64)(FHi & ~0x7ffULL)*0x1p-64;
+        f64 FB = FSign*(f64)(((FHi & 0x7ff) << 53) | (FLo >> 11))*0x1p-117;
+        f64 F = FA + FB;
+        f64 FErr = FB - (F - FA);
+
+        // NOTE(casey): Fraction of a quadrant times pi/2 is radians
+        f64 RHi = F*REDUCE_PI_OVER_2_HI;
+        f64 RLo = fma(F, REDUCE_PI_OVER_2_HI, -RHi);
+        RLo = fma(F, REDUCE_PI_OVER_2_LO, RLo);
+        RLo = fma(FErr, REDUCE_PI_OVER_2_HI, RLo);
+        TwoSum(RHi, RLo, R, Lo);
+
+        if(Sign)
+        {
+            *R = -*R;
+            *Lo = -*Lo;
+            Quadrant = 0 - Quadrant;
+        }
+    }
+
+    Quadrant &= 3;
+    return Quadrant;
+}
+
+inline u32 ReduceRadiansCodyWaite(f64 X, f64 *R, f64 *Lo)
+{
+    // NOTE(casey): Only good for |X| < 2^20
+    f64 Shifted = fma(X, 2.0/Pi64, REDUCE_ROUNDING_MAGIC);
+    f64 K = Shifted - REDUCE_ROUNDING_MAGIC;
+
+    u64 ShiftedBits;
+    memcpy(&ShiftedBits, &Shifted, sizeof(ShiftedBits));
+    u32 Quadrant = (u32)ShiftedBits & 3;
+
+    f64 T = fma(-K, REDUCE_PI_OVER_2_CW1, X); // NOTE(casey): Exact
+    f64 Hi, Err;
+    TwoSum(T, -K*REDUCE_PI_OVER_2_CW2, &Hi, &Err);
+    Err = fma(-K, REDUCE_PI_OVER_2_CW3, Err);
+    TwoSum(Hi, Err, &Hi, &Err);
+    Err = fma(-K, REDUCE_PI_OVER_2_CW4, Err);
+
+    *R = Hi;
+    *Lo = Err;
+    return Quadrant;
+}
+
+inline u32 ReduceRadians(f64 X, f64 *R, f64 *Lo)
+{
+    u32 Quadrant = (fabs(X) < REDUCE_CODY_WAITE_LIMIT) ? ReduceRadiansCodyWaite(X, R, Lo) : ReduceRadiansPayneHanek(X, R, Lo);
+    return Quadrant;
+}
+
+inline void SinCosReducedCore(f64 X, f64 Lo, f64 *SinX, f64 *CosX)
+{
+    /* NOTE(casey): The SinCosCore polynomials, on X + Lo. Lo is under half an
+       ulp of X, so sin(X + Lo) = sin(X) + Lo and cos(X + Lo) = cos(X) - Lo*X
+       to well past double precision. */
+    f64 X2 = X*X;
+
+    f64 S = 0x1.5d45b3248c17bp-33;
+    f64 C = -0x1.8f76380338412p-37;
+    S = fma(S, X2, -0x1.ae5d306ba2463p-26);
+    C = fma(C, X2, 0x1.1ee96d2629799p-29);
+    S = fma(S, X2, 0x1.71de339a50e07p-19);
+    C = fma(C, X2, -0x1.27e4f7282f214p-22);
+    S = fma(S, X2, -0x1.a01a01994fbb1p-13);
+    C = fma(C, X2, 0x1.a01a019b1e8d5p-16);
+    S = fma(S, X2, 0x1.111111110d8ccp-7);
+    C = fma(C, X2, -0x1.6c16c16c13a0bp-10);
+    S = fma(S, X2, -0x1.5555555555522p-3);
+    C = fma(C, X2, 0x1.5555555555536p-5);
+    S = fma(S, X2, 0x1p0);
+    C = fma(C, X2, -0x1p-1);
+    C = fma(C, X2, 0x1p0);
+    S = fma(S, X, Lo);
+    C = fma(-Lo, X, C);
+
+    *SinX = S;
+    *CosX = C;
+}
+
+inline void SinCosAnyCE(f64 X, f64 *SinX, f64 *CosX)
+{
+    f64 R, Lo;
+    u32 Quadrant = ReduceRadians(X, &R, &Lo);
+
+    f64 S, C;
+    SinCosReducedCore(R, Lo, &S, &C);
+
+    f64 SinR = (Quadrant & 1) ? C : S;
+    f64 CosR = (Quadrant & 1) ? S : C;
+    *SinX = (Quadrant & 2) ? -SinR : SinR;
+    *CosX = ((Quadrant + 1) & 2) ? -CosR : CosR;
+}
+
+inline f64 SinAnyCE(f64 X)
+{
+    f64 S, C;
+    SinCosAnyCE(X, &S, &C);
+    return S;
+}
+
+inline f64 CosAnyCE(f64 X)
+{
+    f64 S, C;
+    SinCosAnyCE(X, &S, &C);
+    return C;
+}
+
+//
+// NOTE(casey): AVX2
+//
+
+inline void TwoSum4(__m256d A, __m256d B, __m256d *Sum, __m256d *Err)
+{
+    __m256d S = _mm256_add_pd(A, B);
+    __m256d BB = _mm256_sub_pd(S, A);
+    *Err = _mm256_add_pd(_mm256_sub_pd(A, _mm256_sub_pd(S, BB)), _mm256_sub_pd(B, BB));
+    *Sum = S;
+}
+
+inline __m256i ReduceRadians4(__m256d X, __m256d *R, __m256d *Lo)
+{
+    __m256d Magic = _mm256_set1_pd(REDUCE_ROUNDING_MAGIC);
+
+    __m256d Shifted = _mm256_fmadd_pd(X, _mm256_set1_pd(2.0/Pi64), Magic);
+    __m256d NegK = _mm256_sub_pd(Magic, Shifted);
+    __m256i Quadrant = _mm256_castpd_si256(Shifted);
+
+    __m256d T = _mm256_fmadd_pd(NegK, _mm256_set1_pd(REDUCE_PI_OVER_2_CW1), X);
+    __m256d Hi, Err;
+    TwoSum4(T, _mm256_mul_pd(NegK, _mm256_set1_pd(REDUCE_PI_OVER_2_CW2)), &Hi, &Err);
+    Err = _mm256_fmadd_pd(NegK, _mm256_set1_pd(REDUCE_PI_OVER_2_CW3), Err);
+    TwoSum4(Hi, Err, &Hi, &Err);
+    Err = _mm256_fmadd_pd(NegK, _mm256_set1_pd(REDUCE_PI_OVER_2_CW4), Err);
+
+    // NOTE(casey): NLT rather than GE, so NaNs get sent to Payne-Hanek as well
+    __m256d AbsX = _mm256_andnot_pd(_mm256_set1_pd(-0.0), X);
+    u32 LargeMask = (u32)_mm256_movemask_pd(_mm256_cmp_pd(AbsX, _mm256_set1_pd(REDUCE_CODY_WAITE_LIMIT), _CMP_NLT_UQ));
+    if(LargeMask)
+    {
+        // NOTE(casey): Rare, so those lanes just go through the scalar path one at a time
+        f64 XLanes[4], RLanes[4], LoLanes[4];
+        u64 QuadrantLanes[4];
+        _mm256_storeu_pd(XLanes, X);
+        _mm256_storeu_pd(RLanes, Hi);
+        _mm256_storeu_pd(LoLanes, Err);
+        _mm256_storeu_si256((__m256i *)QuadrantLanes, Quadrant);
+        for(u32 Lane = 0; Lane < 4; ++Lane)
+        {
+            if(LargeMask & (1 << Lane))
+            {
+                QuadrantLanes[Lane] = ReduceRadiansPayneHanek(XLanes[Lane], RLanes + Lane, LoLanes + Lane);
+            }
+        }
+        Hi = _mm256_loadu_pd(RLanes);
+        Err = _mm256_loadu_pd(LoLanes);
+        Quadrant = _mm256_loadu_si256((__m256i *)QuadrantLanes);
+    }
+
+    *R = Hi;
+    *Lo = Err;
+    return Quadrant;
+}
+
+inline void SinCosReducedCore4(__m256d X, __m256d Lo, __m256d *SinX, __m256d *CosX)
+{
+    __m256d X2 = _mm256_mul_pd(X, X);
+
+    __m256d S = _mm256_set1_pd(0x1.5d45b3248c17bp-33);
+    __m256d C = _mm256_set1_pd(-0x1.8f76380338412p-37);
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(-0x1.ae5d306ba2463p-26));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(0x1.1ee96d2629799p-29));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(0x1.71de339a50e07p-19));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(-0x1.27e4f7282f214p-22));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(-0x1.a01a01994fbb1p-13));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(0x1.a01a019b1e8d5p-16));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(0x1.111111110d8ccp-7));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(-0x1.6c16c16c13a0bp-10));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(-0x1.5555555555522p-3));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(0x1.5555555555536p-5));
+    S = _mm256_fmadd_pd(S, X2, _mm256_set1_pd(0x1p0));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(-0x1p-1));
+    C = _mm256_fmadd_pd(C, X2, _mm256_set1_pd(0x1p0));
+    S = _mm256_fmadd_pd(S, X, Lo);
+    C = _mm256_fnmadd_pd(Lo, X, C);
+
+    *SinX = S;
+    *CosX = C;
+}
+
+inline void SinCosAnyCE4(__m256d X, __m256d *SinX, __m256d *CosX)
+{
+    __m256d SignBit = _mm256_set1_pd(-0.0);
+
+    __m256d R, Lo;
+    __m256i Quadrant = ReduceRadians4(X, &R, &Lo);
+
+    __m256d S, C;
+    SinCosReducedCore4(R, Lo, &S, &C);
+
+    // NOTE(casey): Same quadrant fix-up as SinCosCE4
+    __m256d Swap = _mm256_castsi256_pd(_mm256_slli_epi64(Quadrant, 63));
+    __m256d SinSign = _mm256_and_pd(SignBit, _mm256_castsi256_pd(_mm256_slli_epi64(Quadrant, 62)));
+    __m256d CosSign = _mm256_and_pd(SignBit, _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(Quadrant, _mm256_set1_epi64x(1)), 62)));
+
+    *SinX = _mm256_xor_pd(_mm256_blendv_pd(S, C, Swap), SinSign);
+    *CosX = _mm256_xor_pd(_mm256_blendv_pd(C, S, Swap), CosSign);
+}
+
+inline __m256d SinAnyCE4(__m256d X)
+{
+    __m256d S, C;
+    SinCosAnyCE4(X, &S, &C);
+    return S;
+}
+
+inline __m256d CosAnyCE4(__m256d X)
+{
+    __m256d S, C;
+    SinCosAnyCE4(X, &S, &C);
+    return C;
+}
+
+//
+// NOTE(casey): AVX-512
+//
+
+AVX512_FUNCTION inline void TwoSum8(__m512d A, __m512d B, __m512d *Sum, __m512d *Err)
+{
+    __m512d S = _mm512_add_pd(A, B);
+    __m512d BB = _mm512_sub_pd(S, A);
+    *Err = _mm512_add_pd(_mm512_sub_pd(A, _mm512_sub_pd(S, BB)), _mm512_sub_pd(B, BB));
+    *Sum = S;
+}
+
+AVX512_FUNCTION inline __m512i ReduceRadians8(__m512d X, __m512d *R, __m512d *Lo)
+{
+    __m512d Magic = _mm512_set1_pd(REDUCE_ROUNDING_MAGIC);
+
+    __m512d Shifted = _mm512_fmadd_pd(X, _mm512_set1_pd(2.0/Pi64), Magic);
+    __m512d NegK = _mm512_sub_pd(Magic, Shifted);
+    __m512i Quadrant = _mm512_castpd_si512(Shifted);
+
+    __m512d T = _mm512_fmadd_pd(NegK, _mm512_set1_pd(REDUCE_PI_OVER_2_CW1), X);
+    __m512d Hi, Err;
+    TwoSum8(T, _mm512_mul_pd(NegK, _mm512_set1_pd(REDUCE_PI_OVER_2_CW2)), &Hi, &Err);
+    Err = _mm512_fmadd_pd(NegK, _mm512_set1_pd(REDUCE_PI_OVER_2_CW3), Err);
+    TwoSum8(Hi, Err, &Hi, &Err);
+    Err = _mm512_fmadd_pd(NegK, _mm512_set1_pd(REDUCE_PI_OVER_2_CW4), Err);
+
+    u32 LargeMask = _mm512_cmp_pd_mask(_mm512_abs_pd(X), _mm512_set1_pd(REDUCE_CODY_WAITE_LIMIT), _CMP_NLT_UQ);
+    if(LargeMask)
+    {
+        f64 XLanes[8], RLanes[8], LoLanes[8];
+        u64 QuadrantLanes[8];
+        _mm512_storeu_pd(XLanes, X);
+        _mm512_storeu_pd(RLanes, Hi);
+        _mm512_storeu_pd(LoLanes, Err);
+        _mm512_storeu_si512(QuadrantLanes, Quadrant);
+        for(u32 Lane = 0; Lane < 8; ++Lane)
+        {
+            if(LargeMask & (1 << Lane))
+            {
+                QuadrantLanes[Lane] = ReduceRadiansPayneHanek(XLanes[Lane], RLanes + Lane, LoLanes + Lane);
+            }
+        }
+        Hi = _mm512_loadu_pd(RLanes);
+        Err = _mm512_loadu_pd(LoLanes);
+        Quadrant = _mm512_loadu_si512(QuadrantLanes);
+    }
+
+    *R = Hi;
+    *Lo = Err;
+    return Quadrant;
+}
+
+AVX512_FUNCTION inline void SinCosReducedCore8(__m512d X, __m512d Lo, __m512d *SinX, __m512d *CosX)
+{
+    __m512d X2 = _mm512_mul_pd(X, X);
+
+    __m512d S = _mm512_set1_pd(0x1.5d45b3248c17bp-33);
+    __m512d C = _mm512_set1_pd(-0x1.8f76380338412p-37);
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(-0x1.ae5d306ba2463p-26));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(0x1.1ee96d2629799p-29));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(0x1.71de339a50e07p-19));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(-0x1.27e4f7282f214p-22));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(-0x1.a01a01994fbb1p-13));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(0x1.a01a019b1e8d5p-16));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(0x1.111111110d8ccp-7));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(-0x1.6c16c16c13a0bp-10));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(-0x1.5555555555522p-3));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(0x1.5555555555536p-5));
+    S = _mm512_fmadd_pd(S, X2, _mm512_set1_pd(0x1p0));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(-0x1p-1));
+    C = _mm512_fmadd_pd(C, X2, _mm512_set1_pd(0x1p0));
+    S = _mm512_fmadd_pd(S, X, Lo);
+    C = _mm512_fnmadd_pd(Lo, X, C);
+
+    *SinX = S;
+    *CosX = C;
+}
+
+AVX512_FUNCTION inline void SinCosAnyCE8(__m512d X, __m512d *SinX, __m512d *CosX)
+{
+    __m512d R, Lo;
+    __m512i Quadrant = ReduceRadians8(X, &R, &Lo);
+
+    __m512d S, C;
+    SinCosReducedCore8(R, Lo, &S, &C);
+
+    __mmask8 Swap = _mm512_test_epi64_mask(Quadrant, _mm512_set1_epi64(1));
+    __mmask8 SinNegative = _mm512_test_epi64_mask(Quadrant, _mm512_set1_epi64(2));
+    __mmask8 CosNegative = _mm512_test_epi64_mask(_mm512_add_epi64(Quadrant, _mm512_set1_epi64(1)), _mm512_set1_epi64(2));
+
+    __m512d SinR = _mm512_mask_blend_pd(Swap, S, C);
+    __m512d CosR = _mm512_mask_blend_pd(Swap, C, S);
+    *SinX = _mm512_mask_sub_pd(SinR, SinNegative, _mm512_setzero_pd(), SinR);
+    *CosX = _mm512_mask_sub_pd(CosR, CosNegative, _mm512_setzero_pd(), CosR);
+}
+
+AVX512_FUNCTION inline __m512d SinAnyCE8(__m512d X)
+{
+    __m512d S, C;
+    SinCosAnyCE8(X, &S, &C);
+    return S;
+}
+
+AVX512_FUNCTION inline __m512d CosAnyCE8(__m512d X)
+{
+    __m512d S, C;
+    SinCosAnyCE8(X, &S, &C);
+    return C;
+}
+
+//
+// NOTE(casey): Batches, built with the listing 231 macros
+//
+
+MATH_BATCH_SCALAR(SinAnyCE_N_Scalar, SinAnyCE)
+MATH_BATCH_SCALAR(CosAnyCE_N_Scalar, CosAnyCE)
+MATH_BATCH_AVX2(SinAnyCE_N_AVX2, SinAnyCE4)
+MATH_BATCH_AVX2(CosAnyCE_N_AVX2, CosAnyCE4)
+MATH_BATCH_AVX512(SinAnyCE_N_AVX512, SinAnyCE8)
+MATH_BATCH_AVX512(CosAnyCE_N_AVX512, CosAnyCE8)
+
+static math_batch_func *GlobalSinAnyBatch = SinAnyCE_N_AVX2;
+static math_batch_func *GlobalCosAnyBatch = CosAnyCE_N_AVX2;
+
+static void InitializeAnyRangeBatch(void)
+{
+    b32 HasAVX512 = CPUSupportsAVX512F();
+    GlobalSinAnyBatch = HasAVX512 ? SinAnyCE_N_AVX512 : SinAnyCE_N_AVX2;
+    GlobalCosAnyBatch = HasAVX512 ? CosAnyCE_N_AVX512 : CosAnyCE_N_AVX2;
+}
+
+inline void SinAnyCE_N(u64 Count, f64 const *In, f64 *Out) {GlobalSinAnyBatch(Count, In, Out);}
+inline void CosAnyCE_N(u64 Count, f64 const *In, f64 *Out) {GlobalCosAnyBatch(Count, In, Out);}
@@ -0,0 +1,207 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 244
+   ======================================================================== */
+
+#include "listing_0250_math_prelude.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+#include "listing_0212_fixed_f64_format.cpp"
+#include "listing_0231_math_batch.cpp"
+#include "listing_0243_range_reduction.cpp"
+
+#define RANGE_PRECISION_STEP_COUNT 1000003 // NOTE(casey): Not a multiple of 8, so the masked tails get tested too
+#define RANGE_TIMING_COUNT 2048 // NOTE(casey): Small enough that input and output both stay in L1
+
+struct input_range
+{
+    char const *Name;
+    f64 Min;
+    f64 Max;
+    b32 Logarithmic; // NOTE(casey): Steps evenly through log2(|x|), for ranges too wide to step through linearly
+};
+
+static input_range InputRanges[] =
+{
+    {"[-pi, pi]", -Pi64, Pi64, false},
+    {"[-1e3, 1e3]", -1000.0, 1000.0, false},
+    {"[-2^20, 2^20]", -REDUCE_CODY_WAITE_LIMIT, REDUCE_CODY_WAITE_LIMIT, false},
+    {"[2^20, 2^1023]", 20.0, 1023.0, true},
+};
+
+struct range_batch
+{
+    char const *Name;
+    math_batch_func *Sin;
+    math_batch_func *Cos;
+};
+
+static void CRTSin_N(u64 Count, f64 const *In, f64 *Out)
+{
+    for(u64 Index = 0; Index < Count; ++Index)
+    {
+        Out[Index] = sin(In[Index]);
+    }
+}
+
+static void FillInputRange(input_range Range, u32 Count, f64 *Dest)
+{
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        f64 t = (f64)Index / (f64)(Count - 1);
+        f64 X = (1.0 - t)*Range.Min + t*Range.Max;
+        if(Range.Logarithmic)
+        {
+            // NOTE(casey): Alternate signs, and wiggle the mantissa so it isn't always the same few bits
+            X = exp2(X)*(1.0 + 0.5*t);
+            X = (Index & 1) ? -X : X;
+        }
+        Dest[Index] = X;
+    }
+}
+
+int main(void)
+{
+    InitializeOSPlatform();
+    InitializeMathBatch();
+    InitializeAnyRangeBatch();
+
+    b32 HasAVX512 = CPUSupportsAVX512F();
+    if(!HasAVX512)
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so the AVX-512 functions will not be tested.\n");
+    }
+
+    range_batch Batches[] =
+    {
+        {"Scalar", SinAnyCE_N_Scalar, CosAnyCE_N_Scalar},
+        {"AVX2", SinAnyCE_N_AVX2, CosAnyCE_N_AVX2},
+        {"AVX-512", SinAnyCE_N_AVX512, CosAnyCE_N_AVX512},
+    };
+    u32 BatchCount = HasAVX512 ? ArrayCount(Batches) : (ArrayCount(Batches) - 1);
+
+    u32 StepCount = RANGE_PRECISION_STEP_COUNT;
+    u32 OutputCount = 2*ArrayCount(Batches);
+    buffer InputBuffer = AllocateBuffer(StepCount*sizeof(f64));
+    buffer OutputBuffer = AllocateBuffer(OutputCount*StepCount*sizeof(f64));
+    math_tester *Tester = (math_tester *)calloc(1, sizeof(math_tester)); // NOTE(casey): math_tester is big, so it lives on the heap
+    if(IsValid(InputBuffer) && IsValid(OutputBuffer) && Tester)
+    {
+        f64 *Input = (f64 *)InputBuffer.Data;
+        f64 *Outputs = (f64 *)OutputBuffer.Data;
+
+        for(u32 RangeIndex = 0; RangeIndex < ArrayCount(InputRanges); ++RangeIndex)
+        {
+            input_range Range = InputRanges[RangeIndex];
+            FillInputRange(Range, StepCount, Input);
+
+            for(u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+            {
+                Batches[BatchIndex].Sin(StepCount, Input, Outputs + (2*BatchIndex)*StepCount);
+                Batches[BatchIndex].Cos(StepCount, Input, Outputs + (2*BatchIndex + 1)*StepCount);
+            }
+
+            while(PrecisionTest(Tester, 0, 1, StepCount))
+            {
+                // NOTE(casey): Report the real input, not the step parameter
+                f64 X = Input[Tester->StepIndex];
+                Tester->InputValue = X;
+
+                f64 *Output = Outputs + Tester->StepIndex;
+                f64 ExpectedSin = sin(X);
+                f64 ExpectedCos = cos(X);
+                for(u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+                {
+                    TestResult(Tester, ExpectedSin, Output[(2*BatchIndex)*StepCount], "SinAnyCE %s on %s", Batches[BatchIndex].Name, Range.Name);
+                    TestResult(Tester, ExpectedCos, Output[(2*BatchIndex + 1)*StepCount], "CosAnyCE %s on %s", Batches[BatchIndex].Name, Range.Name);
+                }
+
+                for(u32 BatchIndex = 1; BatchIndex < BatchCount; ++BatchIndex)
+                {
+                    TestResult(Tester, Output[0], Output[(2*BatchIndex)*StepCount], "SinAnyCE %s vs Scalar on %s", Batches[BatchIndex].Name, Range.Name);
+                    TestResult(Tester, Output[StepCount], Output[(2*BatchIndex + 1)*StepCount], "CosAnyCE %s vs Scalar on %s", Batches[BatchIndex].Name, Range.Name);
+                }
+            }
+        }
+
+        PrintResults(Tester);
+
+        /* NOTE(casey): Inputs where the reduction is hardest. 6381956970095103*2^797 is the double
+           closest to a multiple of pi/2, so nearly all of its bits cancel, and sin(1e22) is the
+           classic check for whether a library does real argument reduction at all. */
+        f64 HardInputs[] =
+        {
+            Pi64/2.0, Pi64, 2.0*Pi64, 1.0e6*Pi64, 0x1.fffffffffffffp19, REDUCE_CODY_WAITE_LIMIT,
+            1.0e22, 6381956970095103.0*0x1p797, -6381956970095103.0*0x1p797, 1.0e300, 0x1.fffffffffffffp1023,
+            INFINITY, NAN,
+        };
+
+        fprintf(stdout, "\n%26s %25s %25s %25s %25s\n", "x", "sin(x)", "SinAnyCE(x)", "cos(x)", "CosAnyCE(x)");
+        for(u32 Index = 0; Index < ArrayCount(HardInputs); ++Index)
+        {
+            f64 X = HardInputs[Index];
+            fprintf(stdout, "%26.17g %25.17g %25.17g %25.17g %25.17g\n", X, sin(X), SinAnyCE(X), cos(X), CosAnyCE(X));
+        }
+
+        range_batch Timed[] =
+        {
+            {"CRT sin", CRTSin_N, 0},
+            {"SinAnyCE scalar", SinAnyCE_N_Scalar, 0},
+            {"SinAnyCE_N", SinAnyCE_N, 0},
+        };
+
+        repetition_test_series TestSeries = AllocateTestSeries(ArrayCount(Timed), ArrayCount(InputRanges));
+        if(IsValid(TestSeries))
+        {
+            u32 Count = RANGE_TIMING_COUNT;
+            SetRowLabelLabel(&TestSeries, "Inputs");
+            for(u32 RangeIndex = 0; RangeIndex < ArrayCount(InputRanges); ++RangeIndex)
+            {
+                input_range Range = InputRanges[RangeIndex];
+                FillInputRange(Range, Count, Input);
+
+                SetRowLabel(&TestSeries, "%s", Range.Name);
+                for(u32 TimedIndex = 0; TimedIndex < ArrayCount(Timed); ++TimedIndex)
+                {
+                    SetColumnLabel(&TestSeries, "%s", Timed[TimedIndex].Name);
+
+                    // NOTE(casey): "Bytes" are elements here, so the GB/s column comes out in elements
+                    repetition_tester RepTester = {};
+                    NewTestWave(&TestSeries, &RepTester, Count, GetCPUTimerFreq());
+                    while(IsTesting(&TestSeries, &RepTester))
+                    {
+                        BeginTime(&RepTester);
+                        Timed[TimedIndex].Sin(Count, Input, Outputs);
+                        CountBytes(&RepTester, Count);
+                        EndTime(&RepTester);
+                    }
+                }
+            }
+
+            fprintf(stdout, "\nMillion sines/s:\n");
+            PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, (1024.0*1024.0*1024.0) / 1000000.0);
+        }
+
+        FreeTestSeries(&TestSeries);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate test buffers\n");
+    }
+
+    free(Tester);
+    FreeBuffer(&InputBuffer);
+    FreeBuffer(&OutputBuffer);
+
+    return 0;
+}
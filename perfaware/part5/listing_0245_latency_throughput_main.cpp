@@ -0,0 +1,109 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 245
+   ======================================================================== */
+
+/* NOTE(casey): Times each listing 190 replacement (and the CRT function it
+   replaces) two ways, to tell whether it is latency-bound or throughput-bound:
+   as one dependent chain, and as 1, 2, 4 or 8 such chains interleaved, with
+   the kernels from listing 251. "Streams x1" should match "Chain", and the
+   wider ones show how close overlapping independent chains gets to the
+   function's throughput. The "Feedback" row is the chain's own feedback fma
+   with no function in it. The inputs cycle through listing 251's StreamSeeds.
+
+   Results are in CPU timer ticks per call. Those are only core cycles if the
+   core happens to run at the timer frequency, so compare them with each other
+   rather than with instruction tables. */
+
+#include "listing_0250_math_prelude.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+#include "listing_0251_latency_harness.cpp"
+
+#define LATENCY_REP_COUNT 2048 // NOTE(casey): Multiple of 8, so every stream count divides it, and small enough that the inputs stay in L1
+#define LATENCY_SECONDS_TO_TRY 3
+
+struct latency_function
+{
+    char const *Name;
+    latency_kernel *Kernels[5];
+};
+
+#define LATENCY_KERNELS(Func) {ChainKernel<Func>, StreamKernel<Func, 1>, StreamKernel<Func, 2>, StreamKernel<Func, 4>, StreamKernel<Func, 8>}
+
+static char const *LatencyModeNames[] = {"Chain", "Streams x1", "Streams x2", "Streams x4", "Streams x8"};
+
+static latency_function LatencyFunctions[] =
+{
+    {"Feedback", LATENCY_KERNELS(Feedback)},
+
+    {"SinCE", LATENCY_KERNELS(SinCE)},
+    {"CosCE", LATENCY_KERNELS(CosCE)},
+    {"SqrtCE", LATENCY_KERNELS(SqrtCE)},
+    {"ASinCE", LATENCY_KERNELS(ASinCE)},
+
+    {"CRT sin", LATENCY_KERNELS(sin)},
+    {"CRT cos", LATENCY_KERNELS(cos)},
+    {"CRT sqrt", LATENCY_KERNELS(sqrt)},
+    {"CRT asin", LATENCY_KERNELS(asin)},
+};
+
+int main(void)
+{
+    InitializeOSPlatform();
+
+    u32 ModeCount = ArrayCount(LatencyModeNames);
+    buffer InputBuffer = AllocateBuffer(LATENCY_REP_COUNT*sizeof(f64));
+    repetition_test_series TestSeries = AllocateTestSeries(ModeCount, ArrayCount(LatencyFunctions));
+    if(IsValid(InputBuffer) && IsValid(TestSeries))
+    {
+        u32 RepCount = LATENCY_REP_COUNT;
+        f64 *Input = (f64 *)InputBuffer.Data;
+        FillWithStreamSeeds(Input, RepCount);
+
+        SetRowLabelLabel(&TestSeries, "Function");
+        for(u32 FunctionIndex = 0; FunctionIndex < ArrayCount(LatencyFunctions); ++FunctionIndex)
+        {
+            latency_function Function = LatencyFunctions[FunctionIndex];
+            SetRowLabel(&TestSeries, "%s", Function.Name);
+
+            for(u32 ModeIndex = 0; ModeIndex < ModeCount; ++ModeIndex)
+            {
+                SetColumnLabel(&TestSeries, "%s", LatencyModeNames[ModeIndex]);
+
+                // NOTE(casey): "Bytes" are calls here
+                repetition_tester Tester = {};
+                NewTestWave(&TestSeries, &Tester, RepCount, GetCPUTimerFreq(), LATENCY_SECONDS_TO_TRY);
+                while(IsTesting(&TestSeries, &Tester))
+                {
+                    BeginTime(&Tester);
+                    Function.Kernels[ModeIndex](RepCount, Input);
+                    CountBytes(&Tester, RepCount);
+                    EndTime(&Tester);
+                }
+            }
+        }
+
+        fprintf(stdout, "\nCPU timer ticks per call (timer runs at %llu Hz):\n", (unsigned long long)GetCPUTimerFreq());
+        PrintCSVForValue(&TestSeries, RepValue_CPUTimer, stdout, 1.0 / (f64)RepCount);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate test buffers\n");
+    }
+
+    FreeTestSeries(&TestSeries);
+    FreeBuffer(&InputBuffer);
+
+    return 0;
+}
@@ -0,0 +1,471 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 246
+   ======================================================================== */
+
+/* NOTE(casey): Sine and arcsine as a table lookup plus a short polynomial,
+   instead of one long polynomial over the whole range. The idea is to trade
+   fmas for a load.
+
+   Sine: the table has sin and cos at every multiple of 2^-7 from 0 to pi/2.
+   X is split into the nearest node X0 plus D, with |D| <= 2^-8, and then
+       sin(X0 + D) = sin(X0) + (sin(X0)*(cos(D) - 1) + cos(X0)*sin(D))
+   Over a range that small, sin(D) and cos(D) - 1 only need two terms each.
+   2^-7 is a power of two, so the nodes are exact and so is D.
+
+   Arcsine: the table has one row per 2^-8 interval of [0, sqrt(0.5)], which
+   is everything ArcsineCoreFromSquared gets. Each row is the interval's
+   center followed by the degree-6 Taylor polynomial of asin around it, so a
+   lookup is exactly one 64-byte cache line. The first interval is centered
+   on 0 instead, so that asin(x) keeps its relative accuracy near zero.
+
+   Both tables are built at startup from the CRT by InitializeTableMath.
+   Together they are about 15k, so they fit in L1 alongside everything else
+   the haversine loop needs.
+
+   The catch for SIMD is that a lookup becomes a gather. That's two gathers
+   for sine, and eight for arcsine, one per coefficient. */
+
+#define SINE_TABLE_SCALE 128.0 // NOTE(casey): Nodes are 2^-7 apart
+#define SINE_TABLE_COUNT 202 // NOTE(casey): Enough to cover round(pi/2 * 128) = 201
+
+#define ARCSINE_TABLE_SCALE 256.0 // NOTE(casey): Intervals are 2^-8 wide
+#define ARCSINE_TABLE_COUNT 182 // NOTE(casey): Enough to cover floor(sqrt(0.5) * 256) = 181
+#define ARCSINE_TABLE_TERM_COUNT 7
+#define ARCSINE_TABLE_ROW_SIZE 8 // NOTE(casey): Center, then the terms
+
+alignas(64) static f64 SineTable[SINE_TABLE_COUNT][2]; // NOTE(casey): sin, cos
+alignas(64) static f64 ArcsineTable[ARCSINE_TABLE_COUNT][ARCSINE_TABLE_ROW_SIZE];
+
+static void InitializeTableMath(void)
+{
+    for(u32 Index = 0; Index < SINE_TABLE_COUNT; ++Index)
+    {
+        f64 X = (f64)Index / SINE_TABLE_SCALE;
+        SineTable[Index][0] = sin(X);
+        SineTable[Index][1] = cos(X);
+    }
+
+    for(u32 Index = 0; Index < ARCSINE_TABLE_COUNT; ++Index)
+    {
+        f64 Center = Index ? (((f64)Index + 0.5) / ARCSINE_TABLE_SCALE) : 0.0;
+        f64 OneMinusC2 = 1.0 - Center*Center;
+
+        /* NOTE(casey): The derivatives of asin all follow from asin'(x) = 1/sqrt(1 - x^2),
+           which gives (1 - x^2)f(n+2) = (2n + 1)x f(n+1) + n^2 f(n). Each term is then f(n)/n!. */
+        f64 Derivative[ARCSINE_TABLE_TERM_COUNT + 1];
+        Derivative[0] = asin(Center);
+        Derivative[1] = 1.0 / sqrt(OneMinusC2);
+        for(u32 N = 0; (N + 2) < ArrayCount(Derivative); ++N)
+        {
+            Derivative[N + 2] = ((f64)(2*N + 1)*Center*Derivative[N + 1] + (f64)(N*N)*Derivative[N]) / OneMinusC2;
+        }
+
+        f64 *Row = ArcsineTable[Index];
+        Row[0] = Center;
+
+        f64 Factorial = 1.0;
+        for(u32 Term = 0; Term < ARCSINE_TABLE_TERM_COUNT; ++Term)
+        {
+            Factorial *= Term ? (f64)Term : 1.0;
+            Row[1 + Term] = Derivative[Term] / Factorial;
+        }
+    }
+}
+
+inline u64 GetTableMathFootprint(void)
+{
+    u64 Result = sizeof(SineTable) + sizeof(ArcsineTable);
+    return Result;
+}
+
+//
+// NOTE(casey): Scalar
+//
+
+inline f64 SineTableCore(f64 X)
+{
+    // NOTE(casey): Only for X in [0, pi/2]
+    u32 Index = (u32)(s32)(X*SINE_TABLE_SCALE + 0.5);
+    f64 D = X - (f64)Index*(1.0 / SINE_TABLE_SCALE); // NOTE(casey): Exact
+    f64 D2 = D*D;
+
+    f64 SinD = fma(D*D2, fma(D2, 1.0/120.0, -1.0/6.0), D);
+    f64 CosDMinus1 = D2*fma(D2, 1.0/24.0, -0.5);
+
+    f64 *Entry = SineTable[Index];
+    f64 Result = Entry[0] + fma(Entry[1], SinD, Entry[0]*CosDMinus1);
+    return Result;
+}
+
+inline f64 ArcsineTableCore(f64 X)
+{
+    // NOTE(casey): Only for X in [0, sqrt(0.5)]
+    u32 Index = (u32)(s32)(X*ARCSINE_TABLE_SCALE);
+    Index = (Index < ARCSINE_TABLE_COUNT) ? Index : (ARCSINE_TABLE_COUNT - 1);
+
+    f64 *Row = ArcsineTable[Index];
+    f64 D = X - Row[0];
+
+    f64 R = Row[7];
+    R = fma(R, D, Row[6]);
+    R = fma(R, D, Row[5]);
+    R = fma(R, D, Row[4]);
+    R = fma(R, D, Row[3]);
+    R = fma(R, D, Row[2]);
+    R = fma(R, D, Row[1]);
+
+    return R;
+}
+
+inline f64 SinTableCE(f64 OrigX)
+{
+    // NOTE(casey): Same range handling as SinCE
+    f64 HalfPi = Pi64/2;
+    f64 PosX = fabs(OrigX);
+    f64 X = (PosX > HalfPi) ? (Pi64 - PosX) : PosX;
+
+    f64 R = SineTableCore(X);
+
+    f64 Result = (OrigX < 0) ? -R : R;
+    return Result;
+}
+
+inline f64 ASinTableCE(f64 OrigX)
+{
+    f64 PosX = fabs(OrigX);
+    b32 NeedsTransform = (PosX > 0.7071067811865475244);
+    f64 X = NeedsTransform ? SqrtCE(1.0 - PosX*PosX) : PosX;
+
+    f64 R = ArcsineTableCore(X);
+    R = NeedsTransform ? (1.57079632679489661923 - R) : R;
+
+    f64 Result = (OrigX < 0) ? -R : R;
+    return Result;
+}
+
+inline f64 SineTableCoreWithPrefix(f64 A, f64 B, f64 C)
+{
+    // NOTE(casey): Every prefix the haversine uses lands in [0, pi/2]
+    f64 Result = SineTableCore(fma(A, B, C));
+    return Result;
+}
+
+inline f64 ArcsineTableCoreFromSquared(f64 X2)
+{
+    f64 Result = ArcsineTableCore(SqrtCE(X2));
+    return Result;
+}
+
+inline f64 HaversineHalfAngleTable(f64 lon1, f64 lat1, f64 lon2, f64 lat2)
+{
+    // NOTE(casey): SimplifiedHaversineI from listing 195, with the table cores swapped in
+    f64 RadC = 0.01745329251994329577;
+    f64 HalfRadC = RadC/2.0;
+    f64 HalfPi = Pi64/2.0;
+    f64 Deg180 = 180.0;
+
+    f64 SLC1 = (lat1 < 0) ? RadC : -RadC;
+    f64 SLC2 = (lat2 < 0) ? RadC : -RadC;
+
+    f64 DLat = fabs(lat2 - lat1);
+    f64 DLon = fabs(lon2 - lon1);
+    f64 SLC0 = (DLat < Deg180) ? HalfRadC : -HalfRadC;
+    f64 SLC3 = (DLon < Deg180) ? HalfRadC : -HalfRadC;
+    f64 ALC0 = (DLat < Deg180) ? 0 : Pi64;
+    f64 ALC3 = (DLon < Deg180) ? 0 : Pi64;
+
+    f64 S1 = SineTableCoreWithPrefix(SLC1, lat1, HalfPi);
+    f64 S2 = SineTableCoreWithPrefix(SLC2, lat2, HalfPi);
+    f64 S0 = SineTableCoreWithPrefix(SLC0, DLat, ALC0);
+    f64 S3 = SineTableCoreWithPrefix(SLC3, DLon, ALC3);
+
+    f64 a = fma(S0, S0, S1*S2*S3*S3);
+
+    b32 NeedsTransform = (a > 0.5);
+    f64 RangeA = NeedsTransform ? (1.0 - a) : a;
+    f64 R = ArcsineTableCoreFromSquared(RangeA);
+    f64 RangeR = NeedsTransform ? (1.57079632679489661923 - R) : R;
+
+    return RangeR;
+}
+
+//
+// NOTE(casey): AVX2
+//
+
+inline __m256d SineTableCoreWithPrefix4(__m256d A, __m256d B, __m256d C)
+{
+    __m256d X = _mm256_fmadd_pd(A, B, C);
+
+    __m128i Index = _mm256_cvttpd_epi32(_mm256_fmadd_pd(X, _mm256_set1_pd(SINE_TABLE_SCALE), _mm256_set1_pd(0.5)));
+    __m256d D = _mm256_fnmadd_pd(_mm256_cvtepi32_pd(Index), _mm256_set1_pd(1.0 / SINE_TABLE_SCALE), X);
+    __m256d D2 = _mm256_mul_pd(D, D);
+
+    __m256d SinD = _mm256_fmadd_pd(_mm256_mul_pd(D, D2), _mm256_fmadd_pd(D2, _mm256_set1_pd(1.0/120.0), _mm256_set1_pd(-1.0/6.0)), D);
+    __m256d CosDMinus1 = _mm256_mul_pd(D2, _mm256_fmadd_pd(D2, _mm256_set1_pd(1.0/24.0), _mm256_set1_pd(-0.5)));
+
+    // NOTE(casey): Entries are two f64s, so the index is doubled
+    __m128i EntryIndex = _mm_slli_epi32(Index, 1);
+    __m256d SinX0 = _mm256_i32gather_pd(&SineTable[0][0], EntryIndex, 8);
+    __m256d CosX0 = _mm256_i32gather_pd(&SineTable[0][1], EntryIndex, 8);
+
+    __m256d Result = _mm256_add_pd(SinX0, _mm256_fmadd_pd(CosX0, SinD, _mm256_mul_pd(SinX0, CosDMinus1)));
+    return Result;
+}
+
+inline __m256d ArcsineTableCoreFromSquared4(__m256d X2)
+{
+    __m256d X = _mm256_sqrt_pd(X2);
+
+    __m128i Index = _mm256_cvttpd_epi32(_mm256_mul_pd(X, _mm256_set1_pd(ARCSINE_TABLE_SCALE)));
+    Index = _mm_min_epi32(Index, _mm_set1_epi32(ARCSINE_TABLE_COUNT - 1));
+    __m128i RowIndex = _mm_slli_epi32(Index, 3);
+
+    f64 const *Row = &ArcsineTable[0][0];
+    __m256d D = _mm256_sub_pd(X, _mm256_i32gather_pd(Row + 0, RowIndex, 8));
+
+    __m256d R = _mm256_i32gather_pd(Row + 7, RowIndex, 8);
+    R = _mm256_fmadd_pd(R, D, _mm256_i32gather_pd(Row + 6, RowIndex, 8));
+    R = _mm256_fmadd_pd(R, D, _mm256_i32gather_pd(Row + 5, RowIndex, 8));
+    R = _mm256_fmadd_pd(R, D, _mm256_i32gather_pd(Row + 4, RowIndex, 8));
+    R = _mm256_fmadd_pd(R, D, _mm256_i32gather_pd(Row + 3, RowIndex, 8));
+    R = _mm256_fmadd_pd(R, D, _mm256_i32gather_pd(Row + 2, RowIndex, 8));
+    R = _mm256_fmadd_pd(R, D, _mm256_i32gather_pd(Row + 1, RowIndex, 8));
+
+    return R;
+}
+
+inline __m256d HaversineHalfAngleTable4(__m256d lon1, __m256d lat1, __m256d lon2, __m256d lat2)
+{
+    // NOTE(casey): HaversineHalfAngle4 from listing 215, with the table cores swapped in
+    __m256d Zero = _mm256_setzero_pd();
+    __m256d SignBit = _mm256_set1_pd(-0.0);
+    __m256d RadC = _mm256_set1_pd(0.01745329251994329577);
+    __m256d NegRadC = _mm256_set1_pd(-0.01745329251994329577);
+    __m256d HalfRadC = _mm256_set1_pd(0.01745329251994329577/2.0);
+    __m256d NegHalfRadC = _mm256_set1_pd(-0.01745329251994329577/2.0);
+    __m256d Pi = _mm256_set1_pd(Pi64);
+    __m256d HalfPi = _mm256_set1_pd(Pi64/2.0);
+    __m256d Deg180 = _mm256_set1_pd(180.0);
+    __m256d Half = _mm256_set1_pd(0.5);
+    __m256d One = _mm256_set1_pd(1.0);
+
+    __m256d SLC1 = _mm256_blendv_pd(NegRadC, RadC, _mm256_cmp_pd(lat1, Zero, _CMP_LT_OQ));
+    __m256d SLC2 = _mm256_blendv_pd(NegRadC, RadC, _mm256_cmp_pd(lat2, Zero, _CMP_LT_OQ));
+
+    __m256d DLat = _mm256_andnot_pd(SignBit, _mm256_sub_pd(lat2, lat1));
+    __m256d DLon = _mm256_andnot_pd(SignBit, _mm256_sub_pd(lon2, lon1));
+
+    __m256d LatInRange = _mm256_cmp_pd(DLat, Deg180, _CMP_LT_OQ);
+    __m256d LonInRange = _mm256_cmp_pd(DLon, Deg180, _CMP_LT_OQ);
+    __m256d SLC0 = _mm256_blendv_pd(NegHalfRadC, HalfRadC, LatInRange);
+    __m256d SLC3 = _mm256_blendv_pd(NegHalfRadC, HalfRadC, LonInRange);
+    __m256d ALC0 = _mm256_blendv_pd(Pi, Zero, LatInRange);
+    __m256d ALC3 = _mm256_blendv_pd(Pi, Zero, LonInRange);
+
+    __m256d S1 = SineTableCoreWithPrefix4(SLC1, lat1, HalfPi);
+    __m256d S2 = SineTableCoreWithPrefix4(SLC2, lat2, HalfPi);
+    __m256d S0 = SineTableCoreWithPrefix4(SLC0, DLat, ALC0);
+    __m256d S3 = SineTableCoreWithPrefix4(SLC3, DLon, ALC3);
+
+    __m256d a = _mm256_fmadd_pd(S0, S0, _mm256_mul_pd(_mm256_mul_pd(S1, S2), _mm256_mul_pd(S3, S3)));
+
+    __m256d NeedsTransform = _mm256_cmp_pd(a, Half, _CMP_GT_OQ);
+    __m256d RangeA = _mm256_blendv_pd(a, _mm256_sub_pd(One, a), NeedsTransform);
+    __m256d R = ArcsineTableCoreFromSquared4(RangeA);
+    __m256d RangeR = _mm256_blendv_pd(R, _mm256_sub_pd(HalfPi, R), NeedsTransform);
+
+    return RangeR;
+}
+
+static f64 SumHaversineHalfAnglesTableAVX2(u64 PairCount, haversine_columns Columns)
+{
+    __m256d Sum0 = _mm256_setzero_pd();
+    __m256d Sum1 = _mm256_setzero_pd();
+
+    u64 PairIndex = 0;
+    for(; (PairIndex + 8) <= PairCount; PairIndex += 8)
+    {
+        __m256d R0 = HaversineHalfAngleTable4(_mm256_loadu_pd(Columns.X0 + PairIndex), _mm256_loadu_pd(Columns.Y0 + PairIndex),
+                                              _mm256_loadu_pd(Columns.X1 + PairIndex), _mm256_loadu_pd(Columns.Y1 + PairIndex));
+        __m256d R1 = HaversineHalfAngleTable4(_mm256_loadu_pd(Columns.X0 + PairIndex + 4), _mm256_loadu_pd(Columns.Y0 + PairIndex + 4),
+                                              _mm256_loadu_pd(Columns.X1 + PairIndex + 4), _mm256_loadu_pd(Columns.Y1 + PairIndex + 4));
+        Sum0 = _mm256_add_pd(Sum0, R0);
+        Sum1 = _mm256_add_pd(Sum1, R1);
+    }
+
+    for(; PairIndex < PairCount; PairIndex += 4)
+    {
+        __m256i Mask = GetLoadMask4(PairCount - PairIndex);
+        __m256d R = HaversineHalfAngleTable4(_mm256_maskload_pd(Columns.X0 + PairIndex, Mask), _mm256_maskload_pd(Columns.Y0 + PairIndex, Mask),
+                                             _mm256_maskload_pd(Columns.X1 + PairIndex, Mask), _mm256_maskload_pd(Columns.Y1 + PairIndex, Mask));
+        Sum0 = _mm256_add_pd(Sum0, R);
+    }
+
+    __m256d Sum = _mm256_add_pd(Sum0, Sum1);
+    __m128d Sum2 = _mm_add_pd(_mm256_castpd256_pd128(Sum), _mm256_extractf128_pd(Sum, 1));
+    f64 Result = _mm_cvtsd_f64(_mm_add_sd(Sum2, _mm_unpackhi_pd(Sum2, Sum2)));
+
+    return Result;
+}
+
+//
+// NOTE(casey): AVX-512
+//
+
+AVX512_FUNCTION inline __m512d SineTableCoreWithPrefix8(__m512d A, __m512d B, __m512d C)
+{
+    __m512d X = _mm512_fmadd_pd(A, B, C);
+
+    __m256i Index = _mm512_cvttpd_epi32(_mm512_fmadd_pd(X, _mm512_set1_pd(SINE_TABLE_SCALE), _mm512_set1_pd(0.5)));
+    __m512d D = _mm512_fnmadd_pd(_mm512_cvtepi32_pd(Index), _mm512_set1_pd(1.0 / SINE_TABLE_SCALE), X);
+    __m512d D2 = _mm512_mul_pd(D, D);
+
+    __m512d SinD = _mm512_fmadd_pd(_mm512_mul_pd(D, D2), _mm512_fmadd_pd(D2, _mm512_set1_pd(1.0/120.0), _mm512_set1_pd(-1.0/6.0)), D);
+    __m512d CosDMinus1 = _mm512_mul_pd(D2, _mm512_fmadd_pd(D2, _mm512_set1_pd(1.0/24.0), _mm512_set1_pd(-0.5)));
+
+    __m256i EntryIndex = _mm256_slli_epi32(Index, 1);
+    __m512d SinX0 = _mm512_i32gather_pd(EntryIndex, &SineTable[0][0], 8);
+    __m512d CosX0 = _mm512_i32gather_pd(EntryIndex, &SineTable[0][1], 8);
+
+    __m512d Result = _mm512_add_pd(SinX0, _mm512_fmadd_pd(CosX0, SinD, _mm512_mul_pd(SinX0, CosDMinus1)));
+    return Result;
+}
+
+AVX512_FUNCTION inline __m512d ArcsineTableCoreFromSquared8(__m512d X2)
+{
+    __m512d X = _mm512_sqrt_pd(X2);
+
+    __m256i Index = _mm512_cvttpd_epi32(_mm512_mul_pd(X, _mm512_set1_pd(ARCSINE_TABLE_SCALE)));
+    Index = _mm256_min_epi32(Index, _mm256_set1_epi32(ARCSINE_TABLE_COUNT - 1));
+    __m256i RowIndex = _mm256_slli_epi32(Index, 3);
+
+    f64 const *Row = &ArcsineTable[0][0];
+    __m512d D = _mm512_sub_pd(X, _mm512_i32gather_pd(RowIndex, Row + 0, 8));
+
+    __m512d R = _mm512_i32gather_pd(RowIndex, Row + 7, 8);
+    R = _mm512_fmadd_pd(R, D, _mm512_i32gather_pd(RowIndex, Row + 6, 8));
+    R = _mm512_fmadd_pd(R, D, _mm512_i32gather_pd(RowIndex, Row + 5, 8));
+    R = _mm512_fmadd_pd(R, D, _mm512_i32gather_pd(RowIndex, Row + 4, 8));
+    R = _mm512_fmadd_pd(R, D, _mm512_i32gather_pd(RowIndex, Row + 3, 8));
+    R = _mm512_fmadd_pd(R, D, _mm512_i32gather_pd(RowIndex, Row + 2, 8));
+    R = _mm512_fmadd_pd(R, D, _mm512_i32gather_pd(RowIndex, Row + 1, 8));
+
+    return R;
+}
+
+AVX512_FUNCTION inline __m512d HaversineHalfAngleTable8(__m512d lon1, __m512d lat1, __m512d lon2, __m512d lat2)
+{
+    __m512d Zero = _mm512_setzero_pd();
+    __m512d RadC = _mm512_set1_pd(0.01745329251994329577);
+    __m512d NegRadC = _mm512_set1_pd(-0.01745329251994329577);
+    __m512d HalfRadC = _mm512_set1_pd(0.01745329251994329577/2.0);
+    __m512d NegHalfRadC = _mm512_set1_pd(-0.01745329251994329577/2.0);
+    __m512d Pi = _mm512_set1_pd(Pi64);
+    __m512d HalfPi = _mm512_set1_pd(Pi64/2.0);
+    __m512d Deg180 = _mm512_set1_pd(180.0);
+    __m512d Half = _mm512_set1_pd(0.5);
+    __m512d One = _mm512_set1_pd(1.0);
+
+    __m512d SLC1 = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(lat1, Zero, _CMP_LT_OQ), NegRadC, RadC);
+    __m512d SLC2 = _mm512_mask_blend_pd(_mm512_cmp_pd_mask(lat2, Zero, _CMP_LT_OQ), NegRadC, RadC);
+
+    __m512d DLat = _mm512_abs_pd(_mm512_sub_pd(lat2, lat1));
+    __m512d DLon = _mm512_abs_pd(_mm512_sub_pd(lon2, lon1));
+
+    __mmask8 LatInRange = _mm512_cmp_pd_mask(DLat, Deg180, _CMP_LT_OQ);
+    __mmask8 LonInRange = _mm512_cmp_pd_mask(DLon, Deg180, _CMP_LT_OQ);
+    __m512d SLC0 = _mm512_mask_blend_pd(LatInRange, NegHalfRadC, HalfRadC);
+    __m512d SLC3 = _mm512_mask_blend_pd(LonInRange, NegHalfRadC, HalfRadC);
+    __m512d ALC0 = _mm512_mask_blend_pd(LatInRange, Pi, Zero);
+    __m512d ALC3 = _mm512_mask_blend_pd(LonInRange, Pi, Zero);
+
+    __m512d S1 = SineTableCoreWithPrefix8(SLC1, lat1, HalfPi);
+    __m512d S2 = SineTableCoreWithPrefix8(SLC2, lat2, HalfPi);
+    __m512d S0 = SineTableCoreWithPrefix8(SLC0, DLat, ALC0);
+    __m512d S3 = SineTableCoreWithPrefix8(SLC3, DLon, ALC3);
+
+    __m512d a = _mm512_fmadd_pd(S0, S0, _mm512_mul_pd(_mm512_mul_pd(S1, S2), _mm512_mul_pd(S3, S3)));
+
+    __mmask8 NeedsTransform = _mm512_cmp_pd_mask(a, Half, _CMP_GT_OQ);
+    __m512d RangeA = _mm512_mask_sub_pd(a, NeedsTransform, One, a);
+    __m512d R = ArcsineTableCoreFromSquared8(RangeA);
+    __m512d RangeR = _mm512_mask_sub_pd(R, NeedsTransform, HalfPi, R);
+
+    return RangeR;
+}
+
+AVX512_FUNCTION static f64 SumHaversineHalfAnglesTableAVX512(u64 PairCount, haversine_columns Columns)
+{
+    __m512d Sum0 = _mm512_setzero_pd();
+    __m512d Sum1 = _mm512_setzero_pd();
+
+    u64 PairIndex = 0;
+    for(; (PairIndex + 16) <= PairCount; PairIndex += 16)
+    {
+        __m512d R0 = HaversineHalfAngleTable8(_mm512_loadu_pd(Columns.X0 + PairIndex), _mm512_loadu_pd(Columns.Y0 + PairIndex),
+                                              _mm512_loadu_pd(Columns.X1 + PairIndex), _mm512_loadu_pd(Columns.Y1 + PairIndex));
+        __m512d R1 = HaversineHalfAngleTable8(_mm512_loadu_pd(Columns.X0 + PairIndex + 8), _mm512_loadu_pd(Columns.Y0 + PairIndex + 8),
+                                              _mm512_loadu_pd(Columns.X1 + PairIndex + 8), _mm512_loadu_pd(Columns.Y1 + PairIndex + 8));
+        Sum0 = _mm512_add_pd(Sum0, R0);
+        Sum1 = _mm512_add_pd(Sum1, R1);
+    }
+
+    for(; PairIndex < PairCount; PairIndex += 8)
+    {
+        u64 Remaining = PairCount - PairIndex;
+        __mmask8 Mask = (Remaining >= 8) ? (__mmask8)0xff : (__mmask8)((1u << Remaining) - 1);
+        __m512d R = HaversineHalfAngleTable8(_mm512_maskz_loadu_pd(Mask, Columns.X0 + PairIndex), _mm512_maskz_loadu_pd(Mask, Columns.Y0 + PairIndex),
+                                             _mm512_maskz_loadu_pd(Mask, Columns.X1 + PairIndex), _mm512_maskz_loadu_pd(Mask, Columns.Y1 + PairIndex));
+        Sum0 = _mm512_add_pd(Sum0, R);
+    }
+
+    f64 Result = _mm512_reduce_add_pd(_mm512_add_pd(Sum0, Sum1));
+    return Result;
+}
+
+//
+// NOTE(casey): Test functions
+//
+
+static f64 TableHaversine(haversine_setup Setup)
+{
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+
+    f64 Sum = 0;
+    haversine_columns Columns = Setup.Columns;
+    for(u64 PairIndex = 0; PairIndex < Setup.PairCount; ++PairIndex)
+    {
+        f64 RangeR = HaversineHalfAngleTable(Columns.X0[PairIndex], Columns.Y0[PairIndex], Columns.X1[PairIndex], Columns.Y1[PairIndex]);
+        Sum = fma(SumCoef, RangeR, Sum);
+    }
+
+    return Sum;
+}
+
+static f64 TableAVX2Haversine(haversine_setup Setup)
+{
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+    f64 Result = SumCoef*SumHaversineHalfAnglesTableAVX2(Setup.PairCount, Setup.Columns);
+    return Result;
+}
+
+static f64 TableAVX512Haversine(haversine_setup Setup)
+{
+    // NOTE(casey): Only call this if CPUSupportsAVX512F() says it's OK
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+    f64 Result = SumCoef*SumHaversineHalfAnglesTableAVX512(Setup.PairCount, Setup.Columns);
+    return Result;
+}
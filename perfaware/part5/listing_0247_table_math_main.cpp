@@ -0,0 +1,252 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 247
+   ======================================================================== */
+
+#include "listing_0214_columnar_haversine_test.cpp"
+#include "listing_0215_simd_haversine.cpp"
+#include "listing_0246_table_math.cpp"
+#include "listing_0251_latency_harness.cpp"
+
+#define TABLE_PRECISION_STEP_COUNT 1000003
+#define TABLE_TIMING_COUNT 2048 // NOTE(casey): Small enough that the inputs and the tables all stay in L1, and a multiple of 8 for the streams
+
+struct table_timed_function
+{
+    char const *Name;
+    f64 Min;
+    f64 Max;
+    latency_kernel *Kernels[2];
+};
+
+#define TABLE_TIMING_KERNELS(Func) {StreamKernel<Func, 8>, ChainKernel<Func>}
+
+static table_timed_function TimedFunctions[] =
+{
+    {"CRT sin", -Pi64, Pi64, TABLE_TIMING_KERNELS(sin)},
+    {"SinCE", -Pi64, Pi64, TABLE_TIMING_KERNELS(SinCE)},
+    {"SinTableCE", -Pi64, Pi64, TABLE_TIMING_KERNELS(SinTableCE)},
+
+    {"CRT asin", 0, 1, TABLE_TIMING_KERNELS(asin)},
+    {"ASinCE", 0, 1, TABLE_TIMING_KERNELS(ASinCE)},
+    {"ASinTableCE", 0, 1, TABLE_TIMING_KERNELS(ASinTableCE)},
+};
+
+static f64 ScalarHaversine(haversine_setup Setup)
+{
+    // NOTE(casey): TableHaversine with the listing 215 polynomial cores, so the scalar table version has something to race
+    f64 RadC = 0.01745329251994329577;
+    f64 HalfRadC = RadC/2.0;
+    f64 HalfPi = Pi64/2.0;
+    f64 Deg180 = 180.0;
+    f64 SumCoef = (2.0*QUESTIONABLE_EARTH_RADIUS) / (f64)Setup.PairCount;
+
+    f64 Sum = 0;
+    haversine_columns Columns = Setup.Columns;
+    for(u64 PairIndex = 0; PairIndex < Setup.PairCount; ++PairIndex)
+    {
+        f64 lon1 = Columns.X0[PairIndex];
+        f64 lat1 = Columns.Y0[PairIndex];
+        f64 lon2 = Columns.X1[PairIndex];
+        f64 lat2 = Columns.Y1[PairIndex];
+
+        f64 SLC1 = (lat1 < 0) ? RadC : -RadC;
+        f64 SLC2 = (lat2 < 0) ? RadC : -RadC;
+
+        f64 DLat = fabs(lat2 - lat1);
+        f64 DLon = fabs(lon2 - lon1);
+        f64 SLC0 = (DLat < Deg180) ? HalfRadC : -HalfRadC;
+        f64 SLC3 = (DLon < Deg180) ? HalfRadC : -HalfRadC;
+        f64 ALC0 = (DLat < Deg180) ? 0 : Pi64;
+        f64 ALC3 = (DLon < Deg180) ? 0 : Pi64;
+
+        f64 S1 = SineCoreWithPrefix(SLC1, lat1, HalfPi);
+        f64 S2 = SineCoreWithPrefix(SLC2, lat2, HalfPi);
+        f64 S0 = SineCoreWithPrefix(SLC0, DLat, ALC0);
+        f64 S3 = SineCoreWithPrefix(SLC3, DLon, ALC3);
+
+        f64 a = fma(S0, S0, S1*S2*S3*S3);
+
+        b32 NeedsTransform = (a > 0.5);
+        f64 RangeA = NeedsTransform ? (1.0 - a) : a;
+        f64 R = ArcsineCoreFromSquared(RangeA);
+        f64 RangeR = NeedsTransform ? (1.57079632679489661923 - R) : R;
+
+        Sum = fma(SumCoef, RangeR, Sum);
+    }
+
+    return Sum;
+}
+
+static test_function TestFunctions[] =
+{
+    {"ScalarHaversine", ScalarHaversine},
+    {"TableHaversine", TableHaversine},
+    {"AVX2Haversine", AVX2Haversine},
+    {"TableAVX2Haversine", TableAVX2Haversine},
+
+    // NOTE(casey): These have to be last, so they can be left off if the CPU doesn't have AVX-512
+    {"AVX512Haversine", AVX512Haversine},
+    {"TableAVX512Haversine", TableAVX512Haversine},
+};
+
+AVX512_FUNCTION static void TestAVX512TableCores(math_tester *Tester, f64 X, f64 A, f64 ScalarSine, f64 ScalarArcsine)
+{
+    f64 Sine = _mm_cvtsd_f64(_mm512_castpd512_pd128(SineTableCoreWithPrefix8(_mm512_set1_pd(1.0), _mm512_set1_pd(X), _mm512_setzero_pd())));
+    f64 Arcsine = _mm_cvtsd_f64(_mm512_castpd512_pd128(ArcsineTableCoreFromSquared8(_mm512_set1_pd(A*A))));
+    TestResult(Tester, ScalarSine, Sine, "SineTableCoreWithPrefix8 vs scalar");
+    TestResult(Tester, ScalarArcsine, Arcsine, "ArcsineTableCoreFromSquared8 vs scalar");
+}
+
+int main(int ArgCount, char **Args)
+{
+    InitializeOSPlatform();
+    InitializeTableMath();
+
+    b32 HasAVX512 = CPUSupportsAVX512F();
+    if(!HasAVX512)
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so the AVX-512 functions will not be tested.\n");
+    }
+
+    fprintf(stdout, "Sine table: %llu bytes (%u entries)\n", (unsigned long long)sizeof(SineTable), SINE_TABLE_COUNT);
+    fprintf(stdout, "Arcsine table: %llu bytes (%u rows)\n", (unsigned long long)sizeof(ArcsineTable), ARCSINE_TABLE_COUNT);
+    fprintf(stdout, "Total: %llu bytes\n\n", (unsigned long long)GetTableMathFootprint());
+
+    math_tester *Tester = (math_tester *)calloc(1, sizeof(math_tester)); // NOTE(casey): math_tester is big, so it lives on the heap
+    if(Tester)
+    {
+        u32 StepCount = TABLE_PRECISION_STEP_COUNT;
+
+        while(PrecisionTest(Tester, -Pi64, Pi64, StepCount))
+        {
+            f64 X = Tester->InputValue;
+            TestResult(Tester, sin(X), SinCE(X), "SinCE");
+            TestResult(Tester, sin(X), SinTableCE(X), "SinTableCE");
+        }
+
+        while(PrecisionTest(Tester, 0, 1, StepCount))
+        {
+            f64 X = Tester->InputValue;
+            TestResult(Tester, asin(X), ASinCE(X), "ASinCE");
+            TestResult(Tester, asin(X), ASinTableCE(X), "ASinTableCE");
+        }
+
+        // NOTE(casey): The haversine cores only ever see [0, pi/2] for sine and [0, sqrt(0.5)] for arcsine
+        while(PrecisionTest(Tester, 0, Pi64/2.0, StepCount))
+        {
+            f64 X = Tester->InputValue;
+            f64 Sine = SineTableCoreWithPrefix(1.0, X, 0.0);
+            TestResult(Tester, sin(X), Sine, "SineTableCoreWithPrefix");
+
+            f64 A = X*(0.7071067811865475244 / (Pi64/2.0));
+            f64 Arcsine = ArcsineTableCoreFromSquared(A*A);
+            TestResult(Tester, asin(SqrtCE(A*A)), Arcsine, "ArcsineTableCoreFromSquared");
+
+            // NOTE(casey): The gathers have to find the same entries the scalar lookup does
+            f64 Sine4 = _mm256_cvtsd_f64(SineTableCoreWithPrefix4(_mm256_set1_pd(1.0), _mm256_set1_pd(X), _mm256_setzero_pd()));
+            f64 Arcsine4 = _mm256_cvtsd_f64(ArcsineTableCoreFromSquared4(_mm256_set1_pd(A*A)));
+            TestResult(Tester, Sine, Sine4, "SineTableCoreWithPrefix4 vs scalar");
+            TestResult(Tester, Arcsine, Arcsine4, "ArcsineTableCoreFromSquared4 vs scalar");
+
+            if(HasAVX512)
+            {
+                TestAVX512TableCores(Tester, X, A, Sine, Arcsine);
+            }
+        }
+
+        PrintResults(Tester);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate math tester\n");
+    }
+    free(Tester);
+
+    static char const *ModeNames[] = {"Throughput", "Latency"};
+    buffer InputBuffer = AllocateBuffer(TABLE_TIMING_COUNT*sizeof(f64));
+    repetition_test_series TestSeries = AllocateTestSeries(ArrayCount(ModeNames), ArrayCount(TimedFunctions));
+    if(IsValid(InputBuffer) && IsValid(TestSeries))
+    {
+        u32 Count = TABLE_TIMING_COUNT;
+        f64 *Input = (f64 *)InputBuffer.Data;
+
+        SetRowLabelLabel(&TestSeries, "Function");
+        for(u32 FunctionIndex = 0; FunctionIndex < ArrayCount(TimedFunctions); ++FunctionIndex)
+        {
+            table_timed_function Function = TimedFunctions[FunctionIndex];
+            SetRowLabel(&TestSeries, "%s", Function.Name);
+
+            // NOTE(casey): Stepped with an odd stride, so neighboring inputs don't all land in the same table entry
+            for(u32 Index = 0; Index < Count; ++Index)
+            {
+                f64 t = (f64)((Index*1237) % Count) / (f64)(Count - 1);
+                Input[Index] = (1.0 - t)*Function.Min + t*Function.Max;
+            }
+
+            for(u32 ModeIndex = 0; ModeIndex < ArrayCount(ModeNames); ++ModeIndex)
+            {
+                SetColumnLabel(&TestSeries, "%s", ModeNames[ModeIndex]);
+
+                // NOTE(casey): "Bytes" are calls here
+                repetition_tester RepTester = {};
+                NewTestWave(&TestSeries, &RepTester, Count, GetCPUTimerFreq());
+                while(IsTesting(&TestSeries, &RepTester))
+                {
+                    BeginTime(&RepTester);
+                    Function.Kernels[ModeIndex](Count, Input);
+                    CountBytes(&RepTester, Count);
+                    EndTime(&RepTester);
+                }
+            }
+        }
+
+        fprintf(stdout, "\nCPU timer ticks per call (timer runs at %llu Hz):\n", (unsigned long long)GetCPUTimerFreq());
+        PrintCSVForValue(&TestSeries, RepValue_CPUTimer, stdout, 1.0 / (f64)Count);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate timing buffers\n");
+    }
+
+    FreeTestSeries(&TestSeries);
+    FreeBuffer(&InputBuffer);
+
+    // NOTE(casey): The haversine kernels, if a pair file was given
+    if(ArgCount > 1)
+    {
+        haversine_setup Setup = {};
+        if(SetUpHaversineTest(ArgCount, Args, &Setup))
+        {
+            u32 TestFunctionCount = HasAVX512 ? ArrayCount(TestFunctions) : (ArrayCount(TestFunctions) - 2);
+            repetition_test_series HaversineSeries = AllocateTestSeries(TestFunctionCount, 1);
+            if(IsValid(HaversineSeries))
+            {
+                SetRowLabelLabel(&HaversineSeries, "Test");
+                SetRowLabel(&HaversineSeries, "Haversine");
+                RunHaversineTestRow(&HaversineSeries, Setup, TestFunctionCount, TestFunctions);
+
+                PrintCSVForValue(&HaversineSeries, StatValue_GBPerSecond, stdout, 1.0);
+            }
+
+            FreeTestSeries(&HaversineSeries);
+        }
+
+        FreeHaversine(&Setup);
+    }
+
+    (void)&CombinedHaversineTest;
+
+    return 0;
+}
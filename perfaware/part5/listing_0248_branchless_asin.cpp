@@ -0,0 +1,203 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 248
+   ======================================================================== */
+
+/* NOTE(casey): ASinCE reworked along the lines of ArcsineCoreFromSquared.
+
+   ASinCE takes x, and for x > sqrt(0.5) it replaces x with sqrt(1 - x^2).
+   Then it squares the result again, because the polynomial runs on X^2. That
+   means the sqrt sits in the middle of the dependency chain: square, subtract,
+   sqrt, square again, and only then the nineteen fmas.
+
+   The polynomial doesn't need X, just X^2, and both paths can produce that
+   directly:
+
+       X^2 = NeedsTransform ? (1 - x^2) : x^2
+
+   X is only needed for the final multiply, so the sqrt can run alongside the
+   polynomial instead of in front of it. Every lane does exactly one sqrt, and
+   both paths are one straight line of code with selects at the start and
+   the end. 1 - x^2 is also done as a single fma now, so it doesn't lose bits
+   as x approaches 1, and so is pi/2 - R*X at the end.
+
+   On the untransformed path, X is taken straight from |x| rather than from
+   sqrt(x^2), so that tiny inputs whose square underflows still come out as x.
+   These also take negative inputs, which ASinCE does not. */
+
+//
+// NOTE(casey): Scalar
+//
+
+inline f64 ASinBranchlessCE(f64 ScalarX)
+{
+    /* NOTE(casey): The selects are done on __m128d, the way SqrtCE does its sqrt.
+       Written as plain ternaries, the compiler turns them back into branches on
+       NeedsTransform, and moves the sqrt inside one of them. Being branchless
+       isn't free in scalar code: ASinCE's branch is cheap when it predicts,
+       and this always pays for the sqrt and both selects. Listing 249 shows
+       the difference. */
+
+    __m128d SignBit = _mm_set_sd(-0.0);
+    __m128d One = _mm_set_sd(1.0);
+
+    __m128d OrigX = _mm_set_sd(ScalarX);
+    __m128d PosX = _mm_andnot_pd(SignBit, OrigX);
+    __m128d NeedsTransform = _mm_cmpgt_sd(PosX, _mm_set_sd(0.7071067811865475244));
+
+    __m128d PosX2 = _mm_mul_sd(PosX, PosX);
+    __m128d OneMinusX2 = _mm_fnmadd_sd(PosX, PosX, One);
+    __m128d X2V = _mm_blendv_pd(PosX2, OneMinusX2, NeedsTransform);
+
+    // NOTE(casey): Always computed, so there is nothing to branch around
+    __m128d SqrtX2 = _mm_sqrt_sd(X2V, X2V);
+
+    f64 X2 = _mm_cvtsd_f64(X2V);
+    f64 R = 0x1.dfc53682725cap-1;
+    R = fma(R, X2, -0x1.bec6daf74ed61p1);
+    R = fma(R, X2, 0x1.8bf4dadaf548cp2);
+    R = fma(R, X2, -0x1.b06f523e74f33p2);
+    R = fma(R, X2, 0x1.4537ddde2d76dp2);
+    R = fma(R, X2, -0x1.6067d334b4792p1);
+    R = fma(R, X2, 0x1.1fb54da575b22p0);
+    R = fma(R, X2, -0x1.57380bcd2890ep-2);
+    R = fma(R, X2, 0x1.69b370aad086ep-4);
+    R = fma(R, X2, -0x1.21438ccc95d62p-8);
+    R = fma(R, X2, 0x1.b8a33b8e380efp-7);
+    R = fma(R, X2, 0x1.c37061f4e5f55p-7);
+    R = fma(R, X2, 0x1.1c875d6c5323dp-6);
+    R = fma(R, X2, 0x1.6e88ce94d1149p-6);
+    R = fma(R, X2, 0x1.f1c73443a02f5p-6);
+    R = fma(R, X2, 0x1.6db6db3184756p-5);
+    R = fma(R, X2, 0x1.3333333380df2p-4);
+    R = fma(R, X2, 0x1.555555555531ep-3);
+    R = fma(R, X2, 0x1p0);
+
+    // NOTE(casey): The transform's subtract is fused with the final multiply, explicitly, so that the vector versions can match it
+    __m128d RV = _mm_set_sd(R);
+    RV = _mm_blendv_pd(_mm_mul_sd(RV, PosX), _mm_fnmadd_sd(RV, SqrtX2, _mm_set_sd(1.57079632679489661923)), NeedsTransform);
+
+    // NOTE(casey): Put the sign of OrigX back
+    __m128d Result = _mm_or_pd(RV, _mm_and_pd(OrigX, SignBit));
+    return _mm_cvtsd_f64(Result);
+}
+
+//
+// NOTE(casey): AVX2
+//
+
+inline __m256d ASinBranchlessCE4(__m256d OrigX)
+{
+    __m256d SignBit = _mm256_set1_pd(-0.0);
+    __m256d One = _mm256_set1_pd(1.0);
+
+    __m256d PosX = _mm256_andnot_pd(SignBit, OrigX);
+    __m256d NeedsTransform = _mm256_cmp_pd(PosX, _mm256_set1_pd(0.7071067811865475244), _CMP_GT_OQ);
+
+    __m256d PosX2 = _mm256_mul_pd(PosX, PosX);
+    __m256d OneMinusX2 = _mm256_fnmadd_pd(PosX, PosX, One);
+    __m256d X2 = _mm256_blendv_pd(PosX2, OneMinusX2, NeedsTransform);
+
+    __m256d SqrtX2 = _mm256_sqrt_pd(X2);
+
+    __m256d R = _mm256_set1_pd(0x1.dfc53682725cap-1);
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.bec6daf74ed61p1));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.8bf4dadaf548cp2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.b06f523e74f33p2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.4537ddde2d76dp2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.6067d334b4792p1));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.1fb54da575b22p0));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.57380bcd2890ep-2));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.69b370aad086ep-4));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(-0x1.21438ccc95d62p-8));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.b8a33b8e380efp-7));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.c37061f4e5f55p-7));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.1c875d6c5323dp-6));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.6e88ce94d1149p-6));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.f1c73443a02f5p-6));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.6db6db3184756p-5));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.3333333380df2p-4));
+    R = _mm256_fmadd_pd(R, X2, _mm256_set1_pd(0x1.555555555531ep-3));
+    R = _mm256_fmadd_pd(R, X2, One);
+
+    R = _mm256_blendv_pd(_mm256_mul_pd(R, PosX), _mm256_fnmadd_pd(R, SqrtX2, _mm256_set1_pd(1.57079632679489661923)), NeedsTransform);
+
+    // NOTE(casey): Put the sign of OrigX back
+    __m256d Result = _mm256_or_pd(R, _mm256_and_pd(OrigX, SignBit));
+    return Result;
+}
+
+MATH_BATCH_AVX2(ASinBranchlessCE_N_AVX2, ASinBranchlessCE4)
+
+//
+// NOTE(casey): AVX-512
+//
+
+AVX512_FUNCTION inline __m512d ASinBranchlessCE8(__m512d OrigX)
+{
+    __m512d One = _mm512_set1_pd(1.0);
+
+    __m512d PosX = _mm512_abs_pd(OrigX);
+    __mmask8 NeedsTransform = _mm512_cmp_pd_mask(PosX, _mm512_set1_pd(0.7071067811865475244), _CMP_GT_OQ);
+
+    __m512d PosX2 = _mm512_mul_pd(PosX, PosX);
+    __m512d OneMinusX2 = _mm512_fnmadd_pd(PosX, PosX, One);
+    __m512d X2 = _mm512_mask_blend_pd(NeedsTransform, PosX2, OneMinusX2);
+
+    __m512d SqrtX2 = _mm512_sqrt_pd(X2);
+
+    __m512d R = _mm512_set1_pd(0x1.dfc53682725cap-1);
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.bec6daf74ed61p1));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.8bf4dadaf548cp2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.b06f523e74f33p2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.4537ddde2d76dp2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.6067d334b4792p1));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.1fb54da575b22p0));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.57380bcd2890ep-2));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.69b370aad086ep-4));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(-0x1.21438ccc95d62p-8));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.b8a33b8e380efp-7));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.c37061f4e5f55p-7));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.1c875d6c5323dp-6));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.6e88ce94d1149p-6));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.f1c73443a02f5p-6));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.6db6db3184756p-5));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.3333333380df2p-4));
+    R = _mm512_fmadd_pd(R, X2, _mm512_set1_pd(0x1.555555555531ep-3));
+    R = _mm512_fmadd_pd(R, X2, One);
+
+    R = _mm512_mask_blend_pd(NeedsTransform, _mm512_mul_pd(R, PosX), _mm512_fnmadd_pd(R, SqrtX2, _mm512_set1_pd(1.57079632679489661923)));
+
+    // NOTE(casey): Put the sign of OrigX back. _mm512_or_pd needs AVX512DQ, so this is R | (OrigX & SignBit) as one ternary op
+    __m512d Result = _mm512_castsi512_pd(_mm512_ternarylogic_epi64(_mm512_castpd_si512(R), _mm512_castpd_si512(OrigX),
+                                                                    _mm512_set1_epi64((long long)0x8000000000000000ull), 0xf8));
+    return Result;
+}
+
+MATH_BATCH_AVX512(ASinBranchlessCE_N_AVX512, ASinBranchlessCE8)
+
+MATH_BATCH_SCALAR(ASinBranchlessCE_N_Scalar, ASinBranchlessCE)
+
+//
+// NOTE(casey): Dispatch
+//
+
+static math_batch_func *GlobalASinBranchlessBatch = ASinBranchlessCE_N_AVX2;
+
+static void InitializeBranchlessASinBatch(void)
+{
+    GlobalASinBranchlessBatch = CPUSupportsAVX512F() ? ASinBranchlessCE_N_AVX512 : ASinBranchlessCE_N_AVX2;
+}
+
+inline void ASinBranchlessCE_N(u64 Count, f64 const *In, f64 *Out) {GlobalASinBranchlessBatch(Count, In, Out);}
@@ -0,0 +1,234 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 249
+   ======================================================================== */
+
+#include "listing_0250_math_prelude.cpp"
+#include "listing_0164_csv_repetition_tester.cpp"
+#include "listing_0231_math_batch.cpp"
+#include "listing_0248_branchless_asin.cpp"
+#include "listing_0251_latency_harness.cpp"
+
+#define ASIN_PRECISION_STEP_COUNT 1000003 // NOTE(casey): Not a multiple of 8, so the masked tails get tested too
+#define ASIN_TIMING_COUNT 2048 // NOTE(casey): Small enough that input and output both stay in L1, and a power of two for the shuffle
+#define ASIN_SHUFFLE_STRIDE 1237 // NOTE(casey): Odd, so stepping by it mod ASIN_TIMING_COUNT visits every index once
+
+struct asin_batch
+{
+    char const *Name;
+    math_batch_func *Func;
+    b32 TakesNegatives;
+};
+
+template<__m256d Func(__m256d)> static void ChainKernel4(u32 Count, f64 const *Input)
+{
+    // NOTE(casey): ChainKernel from listing 251, four lanes wide
+    __m256d Zero = _mm256_set1_pd(GlobalZero);
+    __m256d Y = _mm256_setzero_pd();
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        // NOTE(casey): Same input in every lane, so this makes the same number of calls the scalar chain does
+        __m256d X = _mm256_fmadd_pd(Y, Zero, _mm256_set1_pd(Input[Index]));
+        Y = Func(X);
+    }
+
+    ConsumeF64(_mm256_cvtsd_f64(Y));
+}
+
+struct asin_chain
+{
+    char const *Name;
+    latency_kernel *Kernel;
+};
+
+static asin_chain Chains[] =
+{
+    {"ASinCE", ChainKernel<ASinCE>},
+    {"ASinBranchlessCE", ChainKernel<ASinBranchlessCE>},
+    {"ASinCE4", ChainKernel4<ASinCE4>},
+    {"ASinBranchlessCE4", ChainKernel4<ASinBranchlessCE4>},
+};
+
+static char const *InputOrderNames[] = {"Sorted", "Shuffled"};
+
+static void FillTimingInputs(f64 *Dest, u32 Count, b32 Shuffled)
+{
+    // NOTE(casey): [0, 1], either in order, where the x > sqrt(0.5) test is easy to predict, or scrambled, where it isn't
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        u32 Step = Shuffled ? ((Index*ASIN_SHUFFLE_STRIDE) % Count) : Index;
+        Dest[Index] = (f64)Step / (f64)(Count - 1);
+    }
+}
+
+int main(void)
+{
+    InitializeOSPlatform();
+    InitializeMathBatch();
+    InitializeBranchlessASinBatch();
+
+    b32 HasAVX512 = CPUSupportsAVX512F();
+    if(!HasAVX512)
+    {
+        fprintf(stderr, "NOTE: This CPU does not support AVX-512, so the AVX-512 functions will not be tested.\n");
+    }
+
+    // NOTE(casey): The AVX-512 ones have to be last, so they can be left off if the CPU doesn't have AVX-512
+    asin_batch Batches[] =
+    {
+        {"ASinCE scalar", ASinCE_N_Scalar, false},
+        {"ASinBranchlessCE scalar", ASinBranchlessCE_N_Scalar, true},
+        {"ASinCE AVX2", ASinCE_N_AVX2, false},
+        {"ASinBranchlessCE AVX2", ASinBranchlessCE_N_AVX2, true},
+        {"ASinCE AVX-512", ASinCE_N_AVX512, false},
+        {"ASinBranchlessCE AVX-512", ASinBranchlessCE_N_AVX512, true},
+    };
+    u32 BatchCount = HasAVX512 ? ArrayCount(Batches) : (ArrayCount(Batches) - 2);
+
+    u32 StepCount = ASIN_PRECISION_STEP_COUNT;
+    buffer InputBuffer = AllocateBuffer(StepCount*sizeof(f64));
+    buffer OutputBuffer = AllocateBuffer(ArrayCount(Batches)*StepCount*sizeof(f64));
+    math_tester *Tester = (math_tester *)calloc(1, sizeof(math_tester)); // NOTE(casey): math_tester is big, so it lives on the heap
+    if(IsValid(InputBuffer) && IsValid(OutputBuffer) && Tester)
+    {
+        f64 *Input = (f64 *)InputBuffer.Data;
+        f64 *Outputs = (f64 *)OutputBuffer.Data;
+
+        f64 Ranges[][2] = {{0, 1}, {-1, 1}};
+        for(u32 RangeIndex = 0; RangeIndex < ArrayCount(Ranges); ++RangeIndex)
+        {
+            f64 MinInput = Ranges[RangeIndex][0];
+            f64 MaxInput = Ranges[RangeIndex][1];
+            b32 HasNegatives = (MinInput < 0);
+            for(u32 StepIndex = 0; StepIndex < StepCount; ++StepIndex)
+            {
+                f64 tStep = (f64)StepIndex / (f64)(StepCount - 1);
+                Input[StepIndex] = (1.0 - tStep)*MinInput + tStep*MaxInput;
+            }
+
+            for(u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+            {
+                Batches[BatchIndex].Func(StepCount, Input, Outputs + BatchIndex*StepCount);
+            }
+
+            while(PrecisionTest(Tester, MinInput, MaxInput, StepCount))
+            {
+                f64 *Output = Outputs + Tester->StepIndex;
+                f64 Expected = asin(Tester->InputValue);
+                for(u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+                {
+                    asin_batch Batch = Batches[BatchIndex];
+                    if(Batch.TakesNegatives || !HasNegatives)
+                    {
+                        TestResult(Tester, Expected, Output[BatchIndex*StepCount], "%s on [%.0f, %.0f]", Batch.Name, MinInput, MaxInput);
+                    }
+                }
+
+                // NOTE(casey): The vector versions should agree with the scalar one, not just with libm
+                for(u32 BatchIndex = 3; BatchIndex < BatchCount; BatchIndex += 2)
+                {
+                    TestResult(Tester, Output[1*StepCount], Output[BatchIndex*StepCount], "%s vs scalar on [%.0f, %.0f]", Batches[BatchIndex].Name, MinInput, MaxInput);
+                }
+            }
+        }
+
+        PrintResults(Tester);
+
+        // NOTE(casey): Near 1 is where 1 - x*x and fma(-x, x, 1) part ways
+        f64 NearOne[] = {0.7071067811865476, 0.9, 0.99, 0.999999, 1.0 - 0x1p-26, 1.0 - 0x1p-52, 1.0 - 0x1p-53, 1.0};
+        fprintf(stdout, "\n%22s %25s %25s %25s\n", "x", "asin(x)", "ASinCE(x)", "ASinBranchlessCE(x)");
+        for(u32 Index = 0; Index < ArrayCount(NearOne); ++Index)
+        {
+            f64 X = NearOne[Index];
+            fprintf(stdout, "%22.17g %25.17g %25.17g %25.17g\n", X, asin(X), ASinCE(X), ASinBranchlessCE(X));
+        }
+
+        u32 Count = ASIN_TIMING_COUNT;
+
+        repetition_test_series TestSeries = AllocateTestSeries(BatchCount, ArrayCount(InputOrderNames));
+        if(IsValid(TestSeries))
+        {
+            SetRowLabelLabel(&TestSeries, "Inputs");
+            for(u32 OrderIndex = 0; OrderIndex < ArrayCount(InputOrderNames); ++OrderIndex)
+            {
+                FillTimingInputs(Input, Count, OrderIndex);
+
+                SetRowLabel(&TestSeries, "%s", InputOrderNames[OrderIndex]);
+                for(u32 BatchIndex = 0; BatchIndex < BatchCount; ++BatchIndex)
+                {
+                    SetColumnLabel(&TestSeries, "%s", Batches[BatchIndex].Name);
+
+                    // NOTE(casey): "Bytes" are elements here, so the GB/s column comes out in elements
+                    repetition_tester RepTester = {};
+                    NewTestWave(&TestSeries, &RepTester, Count, GetCPUTimerFreq());
+                    while(IsTesting(&TestSeries, &RepTester))
+                    {
+                        BeginTime(&RepTester);
+                        Batches[BatchIndex].Func(Count, Input, Outputs);
+                        CountBytes(&RepTester, Count);
+                        EndTime(&RepTester);
+                    }
+                }
+            }
+
+            fprintf(stdout, "\nMillion arcsines/s:\n");
+            PrintCSVForValue(&TestSeries, StatValue_GBPerSecond, stdout, (1024.0*1024.0*1024.0) / 1000000.0);
+        }
+
+        FreeTestSeries(&TestSeries);
+
+        repetition_test_series ChainSeries = AllocateTestSeries(ArrayCount(InputOrderNames), ArrayCount(Chains));
+        if(IsValid(ChainSeries))
+        {
+            SetRowLabelLabel(&ChainSeries, "Function");
+            for(u32 ChainIndex = 0; ChainIndex < ArrayCount(Chains); ++ChainIndex)
+            {
+                asin_chain Chain = Chains[ChainIndex];
+                SetRowLabel(&ChainSeries, "%s", Chain.Name);
+
+                for(u32 OrderIndex = 0; OrderIndex < ArrayCount(InputOrderNames); ++OrderIndex)
+                {
+                    FillTimingInputs(Input, Count, OrderIndex);
+                    SetColumnLabel(&ChainSeries, "%s", InputOrderNames[OrderIndex]);
+
+                    // NOTE(casey): "Bytes" are calls here
+                    repetition_tester RepTester = {};
+                    NewTestWave(&ChainSeries, &RepTester, Count, GetCPUTimerFreq());
+                    while(IsTesting(&ChainSeries, &RepTester))
+                    {
+                        BeginTime(&RepTester);
+                        Chain.Kernel(Count, Input);
+                        CountBytes(&RepTester, Count);
+                        EndTime(&RepTester);
+                    }
+                }
+            }
+
+            fprintf(stdout, "\nDependent chain, CPU timer ticks per call (timer runs at %llu Hz):\n", (unsigned long long)GetCPUTimerFreq());
+            PrintCSVForValue(&ChainSeries, RepValue_CPUTimer, stdout, 1.0 / (f64)Count);
+        }
+
+        FreeTestSeries(&ChainSeries);
+    }
+    else
+    {
+        fprintf(stderr, "ERROR: Unable to allocate test buffers\n");
+    }
+
+    free(Tester);
+    FreeBuffer(&InputBuffer);
+    FreeBuffer(&OutputBuffer);
+
+    return 0;
+}
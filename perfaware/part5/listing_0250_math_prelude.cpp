@@ -0,0 +1,126 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 250
+   ======================================================================== */
+
+/* NOTE(casey): Everything the math-only listings need, without the haversine
+   test harness from listing 214: the types, the math checker, the platform
+   layer, the listing 190 replacements, and the CPU feature checks and load
+   masks the SIMD math is built on. Listings that time things include the
+   repetition tester themselves. Listing 214 starts with this too, so anything
+   that includes both gets it only once. */
+
+#define _CRT_SECURE_NO_WARNINGS
+#include <math.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#if _WIN32
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+
+typedef int32_t s32;
+
+typedef int32_t b32;
+
+typedef float f32;
+typedef double f64;
+
+#define ArrayCount(Array) (sizeof(Array)/sizeof((Array)[0]))
+
+#include "listing_0175_math_check.cpp"
+#include "listing_0125_buffer.cpp"
+#include "listing_0210_os_platform.cpp"
+#include "listing_0190_math_replacement.cpp"
+
+#if _MSC_VER
+#define AVX512_FUNCTION
+#else
+#define AVX512_FUNCTION __attribute__((target("avx512f")))
+#endif
+
+inline void ReadCPUID(u32 Leaf, u32 SubLeaf, u32 *Registers)
+{
+#if _MSC_VER
+    int Values[4];
+    __cpuidex(Values, (int)Leaf, (int)SubLeaf);
+    for(u32 Index = 0; Index < 4; ++Index)
+    {
+        Registers[Index] = (u32)Values[Index];
+    }
+#else
+    __asm__ __volatile__("cpuid"
+                         : "=a"(Registers[0]), "=b"(Registers[1]), "=c"(Registers[2]), "=d"(Registers[3])
+                         : "a"(Leaf), "c"(SubLeaf));
+#endif
+}
+
+inline u64 ReadXCR0(void)
+{
+#if _MSC_VER
+    u64 Result = _xgetbv(0);
+#else
+    u32 Low, High;
+    __asm__ __volatile__("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+    u64 Result = ((u64)High << 32) | Low;
+#endif
+    return Result;
+}
+
+inline b32 CPUSupportsAVX512F(void)
+{
+    /* NOTE(casey): The CPU has to have AVX-512F, and the OS has to have turned on
+       saving of the opmask and upper ZMM state (XCR0 bits 5-7), along with the
+       SSE and AVX state (bits 1-2) that AVX-512 builds on. */
+
+    b32 Result = false;
+
+    u32 Registers[4];
+    ReadCPUID(0, 0, Registers);
+    u32 MaxLeaf = Registers[0];
+    if(MaxLeaf >= 7)
+    {
+        ReadCPUID(1, 0, Registers);
+        b32 OSXSAVE = (Registers[2] >> 27) & 1;
+
+        ReadCPUID(7, 0, Registers);
+        b32 AVX512F = (Registers[1] >> 16) & 1;
+
+        if(OSXSAVE && AVX512F)
+        {
+            u64 StateMask = 0xe6;
+            Result = ((ReadXCR0() & StateMask) == StateMask);
+        }
+    }
+
+    return Result;
+}
+
+inline __m256i GetLoadMask4(u64 Count)
+{
+    // NOTE(casey): Lanes below Count get all ones, the rest get zero
+    __m256i Indices = _mm256_setr_epi64x(0, 1, 2, 3);
+    __m256i Result = _mm256_cmpgt_epi64(_mm256_set1_epi64x((long long)Count), Indices);
+    return Result;
+}
@@ -0,0 +1,116 @@
+/* ========================================================================
+
+   (C) Copyright 2023 by Molly Rocket, Inc., All Rights Reserved.
+
+   This software is provided 'as-is', without any express or implied
+   warranty. In no event will the authors be held liable for any damages
+   arising from the use of this software.
+
+   Please see https://computerenhance.com for more information
+
+   ======================================================================== */
+
+/* ========================================================================
+   LISTING 251
+   ======================================================================== */
+
+/* NOTE(casey): The latency and throughput kernels from listing 245, pulled out
+   so every listing that times a math function measures it the same way. Each
+   kernel calls the function once per input, so a kernel run over Count inputs
+   is Count calls.
+
+   ChainKernel feeds every output back into the next input, so no call can
+   start until the one before it is done, and the time per call is the latency.
+   The feedback is fma(Output, Zero, Input), where the compiler can't know Zero
+   is zero, so the input is still the one from the array but it waits on the
+   previous output. That fma is in the chain too, which is what timing a chain
+   of Feedback measures on its own.
+
+   StreamKernel runs StreamCount of those chains side by side, each with its
+   own feedback fma, taking turns through the inputs. A call still waits on
+   the one before it in its own chain, but not on the other chains, so with
+   one stream this is the same as ChainKernel, and with more streams it shows
+   how much of the latency the CPU can hide by overlapping them. Each chain's
+   input goes through the listing 198 asm barrier, so the compiler can't
+   merge the chains into vector code, and the last outputs go through it so
+   the calls can't be thrown away as dead code. Count has to be a multiple of
+   StreamCount. */
+
+#if __clang__ || __GNUC__
+#define OpaqueF64(Value) asm volatile ("" : "+x"(Value))
+#define ConsumeF64(Value) asm volatile ("" : : "x"(Value))
+#else
+/* NOTE(casey): MSVC has no inline assembly on x64, so the closest it gets is
+   going through memory. That adds a load and a store per call to the stream
+   loops, which the clang build doesn't pay. */
+static f64 volatile GlobalOpaqueF64;
+#define OpaqueF64(Value) (GlobalOpaqueF64 = (Value), (Value) = GlobalOpaqueF64)
+#define ConsumeF64(Value) (GlobalOpaqueF64 = (Value))
+#endif
+
+static f64 volatile GlobalZero = 0.0;
+
+// NOTE(casey): All in range for every function in listing 190, and not all the same, so nothing gets to take a shortcut
+static f64 const StreamSeeds[8] = {0.0625, 0.1875, 0.3125, 0.4375, 0.5625, 0.6875, 0.8125, 0.9375};
+
+typedef void latency_kernel(u32 Count, f64 const *Input);
+
+inline f64 Feedback(f64 X)
+{
+    // NOTE(casey): Nothing at all, so the chain is just the feedback fma
+    return X;
+}
+
+inline void FillWithStreamSeeds(f64 *Dest, u32 Count)
+{
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        Dest[Index] = StreamSeeds[Index % ArrayCount(StreamSeeds)];
+    }
+}
+
+template<math_func *Func> static void ChainKernel(u32 Count, f64 const *Input)
+{
+    f64 Zero = GlobalZero;
+
+    f64 Y = 0;
+    for(u32 Index = 0; Index < Count; ++Index)
+    {
+        f64 X = fma(Y, Zero, Input[Index]);
+        Y = Func(X);
+    }
+
+    ConsumeF64(Y);
+}
+
+/* NOTE(casey): The chains are spelled out as separate variables, not an array
+   indexed in an inner loop, because compilers don't always unroll that loop,
+   and then every chain goes through a store and a load on the stack, which
+   adds its own latency to the chain. The StreamCount tests are all constant,
+   so the unused chains compile away. */
+#define STREAM_STEP(N) \
+    if(StreamCount > N) \
+    { \
+        f64 X = fma(Y##N, Zero, Input[Index + N]); \
+        OpaqueF64(X); \
+        Y##N = Func(X); \
+    }
+
+template<math_func *Func, u32 StreamCount> static void StreamKernel(u32 Count, f64 const *Input)
+{
+    static_assert((StreamCount >= 1) && (StreamCount <= 8), "StreamKernel has at most 8 chains");
+
+    f64 Zero = GlobalZero;
+
+    f64 Y0 = 0, Y1 = 0, Y2 = 0, Y3 = 0, Y4 = 0, Y5 = 0, Y6 = 0, Y7 = 0;
+    for(u32 Index = 0; Index < Count; Index += StreamCount)
+    {
+        STREAM_STEP(0) STREAM_STEP(1) STREAM_STEP(2) STREAM_STEP(3)
+        STREAM_STEP(4) STREAM_STEP(5) STREAM_STEP(6) STREAM_STEP(7)
+    }
+
+    ConsumeF64(Y0); ConsumeF64(Y1); ConsumeF64(Y2); ConsumeF64(Y3);
+    ConsumeF64(Y4); ConsumeF64(Y5); ConsumeF64(Y6); ConsumeF64(Y7);
+}
+
+#undef STREAM_STEP